@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   LogDecoder.cpp
+/// @author David Stalter
+///
+/// @details
+/// Offline tool that turns a binary match log from the robot into CSV.  It is
+/// not part of the robot build, compile it on a PC with:
+///
+///     g++ -std=c++17 -O2 -o LogDecoder LogDecoder.cpp
+///
+/// Usage: LogDecoder robot_000.ytalog
+///
+/// Loop records go to robot_000.ytalog.csv and text messages to
+/// robot_000.ytalog.txt.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cstdint>                                      // for sized integer types
+#include <cstdio>                                       // for file I/O
+#include <cstring>                                      // for memcmp
+#include <map>                                          // for std::map
+#include <string>                                       // for std::string
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "../main/include/RobotLogRecords.hpp"          // for the log record layout
+
+using namespace RobotLogRecords;
+
+// Matches YtaRobot::RobotMode
+static const char * const ROBOT_MODE_NAMES[] = {"autonomous", "teleop", "test", "disabled", "not set"};
+static const unsigned NUM_ROBOT_MODES = sizeof(ROBOT_MODE_NAMES) / sizeof(ROBOT_MODE_NAMES[0]);
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method WriteControllerHeader
+///
+/// Writes the CSV column names for one controller.
+///
+////////////////////////////////////////////////////////////////
+static void WriteControllerHeader(std::FILE * pCsvFile, const char * pPrefix)
+{
+    std::fprintf(pCsvFile, ",%s_buttons,%s_pov,%s_x,%s_y", pPrefix, pPrefix, pPrefix, pPrefix);
+    for (unsigned i = 0U; i < LOGGED_AXES; i++)
+    {
+        std::fprintf(pCsvFile, ",%s_axis%u", pPrefix, i);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method WriteControllerData
+///
+/// Writes the CSV columns for one controller.
+///
+////////////////////////////////////////////////////////////////
+static void WriteControllerData(std::FILE * pCsvFile, const ControllerData & rData)
+{
+    std::fprintf(pCsvFile, ",0x%08X,%d,%.4f,%.4f", rData.m_Buttons, rData.m_Pov, rData.m_X, rData.m_Y);
+    for (unsigned i = 0U; i < LOGGED_AXES; i++)
+    {
+        std::fprintf(pCsvFile, ",%.4f", rData.m_Axes[i]);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method main
+///
+/// Reads every record in a log and writes it out as text.
+/// Gaps in the sequence numbers are reported, they mean the
+/// robot dropped records because its ring filled up.
+///
+////////////////////////////////////////////////////////////////
+int main(int argc, char * argv[])
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s <log file>\n", argv[0]);
+        return 1;
+    }
+
+    const std::string logFileName(argv[1]);
+    std::FILE * pLogFile = std::fopen(logFileName.c_str(), "rb");
+    if (pLogFile == nullptr)
+    {
+        std::fprintf(stderr, "Could not open %s.\n", logFileName.c_str());
+        return 1;
+    }
+
+    FileHeader fileHeader;
+    if ((std::fread(&fileHeader, sizeof(fileHeader), 1U, pLogFile) != 1U) ||
+        (std::memcmp(fileHeader.m_Magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0))
+    {
+        std::fprintf(stderr, "%s is not a robot log.\n", logFileName.c_str());
+        std::fclose(pLogFile);
+        return 1;
+    }
+
+    if ((fileHeader.m_Version != LOG_VERSION) || (fileHeader.m_RecordSize != RECORD_SIZE_BYTES))
+    {
+        std::fprintf(stderr, "Log version %u (record size %u) doesn't match this decoder (version %u).\n",
+                     fileHeader.m_Version, fileHeader.m_RecordSize, LOG_VERSION);
+        std::fclose(pLogFile);
+        return 1;
+    }
+
+    std::FILE * pCsvFile = std::fopen((logFileName + ".csv").c_str(), "w");
+    std::FILE * pTextFile = std::fopen((logFileName + ".txt").c_str(), "w");
+    if ((pCsvFile == nullptr) || (pTextFile == nullptr))
+    {
+        std::fprintf(stderr, "Could not create the output files.\n");
+        std::fclose(pLogFile);
+        return 1;
+    }
+
+    std::fprintf(pCsvFile, "timestamp_s,sequence,mode,loop_time_us");
+    WriteControllerHeader(pCsvFile, "drive");
+    WriteControllerHeader(pCsvFile, "control");
+    std::fprintf(pCsvFile, ",left_drive_output,right_drive_output,left_encoder,right_encoder,gyro_angle,shooter_rpm\n");
+
+    Record record;
+    unsigned numRecords = 0U;
+    unsigned numDropped = 0U;
+    uint32_t expectedSequence = 0U;
+    bool bStartOfText = true;
+
+    // Text messages still waiting for their last chunk, by message id
+    struct PendingText
+    {
+        double      m_TimestampS;
+        std::string m_Text;
+    };
+    std::map<uint32_t, PendingText> pendingTexts;
+
+    while (std::fread(&record, sizeof(record), 1U, pLogFile) == 1U)
+    {
+        const RecordHeader & rHeader = record.m_Header;
+
+        // Records can be a little out of order between threads.  A
+        // late one was counted as dropped when the gap it left was
+        // seen, so it comes back off the count when it shows up.
+        const int32_t sequenceGap = static_cast<int32_t>(rHeader.m_Sequence - expectedSequence);
+        if (sequenceGap >= 0)
+        {
+            numDropped += static_cast<unsigned>(sequenceGap);
+            expectedSequence = rHeader.m_Sequence + 1U;
+        }
+        else if (numDropped > 0U)
+        {
+            numDropped--;
+        }
+        else
+        {
+        }
+        numRecords++;
+
+        const double timestampS = static_cast<double>(rHeader.m_TimestampUs) / 1.0E6;
+
+        switch (rHeader.m_Type)
+        {
+            case RECORD_LOOP:
+            {
+                const LoopData & rLoop = record.m_Loop;
+                const char * pModeName = "unknown";
+                if (rHeader.m_RobotMode < NUM_ROBOT_MODES)
+                {
+                    pModeName = ROBOT_MODE_NAMES[rHeader.m_RobotMode];
+                }
+                else if (rHeader.m_RobotMode == NO_ROBOT_MODE)
+                {
+                    pModeName = "none";
+                }
+                else
+                {
+                }
+
+                std::fprintf(pCsvFile, "%.6f,%u,%s,%u", timestampS, rHeader.m_Sequence, pModeName, rLoop.m_LoopTimeUs);
+                WriteControllerData(pCsvFile, rLoop.m_DriveController);
+                WriteControllerData(pCsvFile, rLoop.m_ControlController);
+                std::fprintf(pCsvFile, ",%.4f,%.4f,%d,%d,%.2f,%.1f\n",
+                             rLoop.m_LeftDriveOutput, rLoop.m_RightDriveOutput,
+                             rLoop.m_LeftEncoder, rLoop.m_RightEncoder,
+                             rLoop.m_GyroAngle, rLoop.m_ShooterRpm);
+                break;
+            }
+            case RECORD_TEXT:
+            {
+                // Chunks of one message can have other threads' records between them
+                const TextData & rText = record.m_Text;
+                const unsigned length = (rHeader.m_Length <= TEXT_RECORD_BYTES) ? rHeader.m_Length : TEXT_RECORD_BYTES;
+                const std::map<uint32_t, PendingText>::iterator pendingIter = pendingTexts.emplace(rText.m_MessageId, PendingText{timestampS, std::string()}).first;
+                pendingIter->second.m_Text.append(rText.m_Text, length);
+                if ((rHeader.m_Flags & TEXT_CONTINUES_FLAG) != 0U)
+                {
+                    break;
+                }
+
+                // Stamp each line where it starts, a message without a newline runs on into the next
+                const std::string & rMessage = pendingIter->second.m_Text;
+                if (bStartOfText)
+                {
+                    std::fprintf(pTextFile, "[%10.6f] ", pendingIter->second.m_TimestampS);
+                }
+                std::fwrite(rMessage.data(), 1U, rMessage.size(), pTextFile);
+                bStartOfText = !rMessage.empty() && (rMessage.back() == '\n');
+                pendingTexts.erase(pendingIter);
+                break;
+            }
+            default:
+            {
+                // Unknown record type, skip it
+                break;
+            }
+        }
+    }
+
+    // The rest of these were dropped, or the robot stopped before they were logged
+    for (const std::pair<const uint32_t, PendingText> & rPending : pendingTexts)
+    {
+        std::fprintf(pTextFile, "%s[%10.6f] (incomplete) %s\n", bStartOfText ? "" : "\n", rPending.second.m_TimestampS, rPending.second.m_Text.c_str());
+        bStartOfText = true;
+    }
+
+    std::printf("Decoded %u records, %u dropped on the robot.\n", numRecords, numDropped);
+
+    std::fclose(pTextFile);
+    std::fclose(pCsvFile);
+    std::fclose(pLogFile);
+    return 0;
+}
@@ -35,7 +35,7 @@ private:
   
   // Makes for easier use/readability of interacting with I2C commands and data
   typedef RoborioRioduinoSharedData::I2cCommand I2cCommand;
-  typedef RoborioRioduinoSharedData::I2cData I2cData;
+  typedef RoborioRioduinoSharedData::I2cDataFrame I2cDataFrame;
 
   // Support function for displaying a message if prints are enabled
   template <typename T>
@@ -52,14 +52,22 @@ private:
   static void I2cOnReceive(int bytesReceived);
   static void I2cOnRequest();
   static void CheckForAndProcessI2cCommand();
+  static void RunStreaming();
+  static void RunHandshake();
   static void BuildI2cData();
+  static void AddI2cPayload(I2cDataFrame & rFrame, RoborioRioduinoSharedData::I2cDataSelection selection, const void * pPayload, uint8_t size);
+  static int16_t ToGyroI2cAngle(double angle);
   static void GetGyroData();
   static void HeartBeat();
   
   // Member variables
   static Adafruit_BNO055    m_Bno055;
   static I2cCommand         m_I2cCommand;
-  static I2cData            m_I2cData;
+  static I2cDataFrame       m_I2cFrames[2];             // Double buffered, one is built while the other is sent
+  static unsigned long      m_I2cFrameSampleTimesMs[2];
+  static volatile uint8_t   m_ReadyI2cFrame;
+  static unsigned long      m_LastSampleTimeMs;
+  static uint8_t            m_I2cSequence;
   static volatile bool      m_bNewI2cCommandAvailable;
   static volatile bool      m_bReadNewGyroCenter;
   static volatile bool      m_bCollectSensorData;
@@ -68,6 +76,8 @@ private:
   static double             m_RobotAbsoluteAngle;
   static double             m_RobotRelativeAngle;
   static double             m_RobotCenterPoint;
+  static double             m_RobotYAngle;
+  static double             m_RobotZAngle;
   
   // Constants
   static const int          ROBORIO_SIGNAL_PIN          = 2;
@@ -77,6 +87,8 @@ private:
   static const int          DEBUG_GREEN_LED_PIN         = 7;
   static const int          BNO055_SENSOR_ID            = 55;
   static const int          HEART_BEAT_RATE_MS          = 1000;
+  static const unsigned long STREAMING_SAMPLE_PERIOD_MS = 10;
+  static const unsigned long MAX_SAMPLE_AGE_MS          = 0xFFFF;
   static const uint8_t      I2C_BUFFER_MARKER           = 0xBB;
   static constexpr double   ONE_HUNDRED_EIGHTY_DEGREES  = 180.0;
   static constexpr double   THREE_HUNDRED_SIXTY_DEGREES = 360.0;
@@ -95,7 +107,11 @@ private:
 // STATIC MEMBER DATA
 Adafruit_BNO055         YtaRioduino::m_Bno055                   = Adafruit_BNO055(BNO055_SENSOR_ID);
 YtaRioduino::I2cCommand YtaRioduino::m_I2cCommand;
-YtaRioduino::I2cData    YtaRioduino::m_I2cData;
+YtaRioduino::I2cDataFrame YtaRioduino::m_I2cFrames[2];
+unsigned long           YtaRioduino::m_I2cFrameSampleTimesMs[2];
+volatile uint8_t        YtaRioduino::m_ReadyI2cFrame            = 0U;
+unsigned long           YtaRioduino::m_LastSampleTimeMs         = 0U;
+uint8_t                 YtaRioduino::m_I2cSequence              = 0U;
 volatile bool           YtaRioduino::m_bNewI2cCommandAvailable  = false;
 volatile bool           YtaRioduino::m_bReadNewGyroCenter       = false;
 volatile bool           YtaRioduino::m_bCollectSensorData       = false;
@@ -104,6 +120,8 @@ double                  YtaRioduino::m_RobotAngle               = 0.0;
 double                  YtaRioduino::m_RobotAbsoluteAngle       = 0.0;
 double                  YtaRioduino::m_RobotRelativeAngle       = 0.0;
 double                  YtaRioduino::m_RobotCenterPoint         = 0.0;
+double                  YtaRioduino::m_RobotYAngle              = 0.0;
+double                  YtaRioduino::m_RobotZAngle              = 0.0;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -163,7 +181,8 @@ void YtaRioduino::Initialize()
   Wire.onRequest(I2cOnRequest);
   
   // Clear I2C data and set constant fields
-  memset(&m_I2cData, 0U, sizeof(m_I2cData));
+  memset(&m_I2cFrames[0], 0U, sizeof(m_I2cFrames));
+  memset(&m_I2cFrameSampleTimesMs[0], 0U, sizeof(m_I2cFrameSampleTimesMs));
   
   // Initialize the 9-axis sensor
   while (!m_Bno055.begin())
@@ -192,17 +211,45 @@ void YtaRioduino::Initialize()
 ////////////////////////////////////////////////////////////////////////////////
 void YtaRioduino::Run()
 {
-  while (true)
+  if (RoborioRioduinoSharedData::I2C_STREAMING_MODE)
+  {
+    RunStreaming();
+  }
+  else
+  {
+    RunHandshake();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Method: RunStreaming
+///
+/// Details:  The sensors are sampled at a fixed rate without waiting for the
+///           roboRIO.  Each sample is built into the spare frame, which then
+///           becomes the one sent.  Whenever the roboRIO reads, it gets the
+///           newest complete sample along with how old it is.
+////////////////////////////////////////////////////////////////////////////////
+void YtaRioduino::RunStreaming()
+{
+  CheckForAndProcessI2cCommand();
+  HeartBeat();
+  
+  if ((millis() - m_LastSampleTimeMs) >= STREAMING_SAMPLE_PERIOD_MS)
   {
-    while (!m_bCollectSensorData)
-    {
-      HeartBeat();
-    }
     GetGyroData();
     BuildI2cData();
-    m_bCollectSensorData = false;
   }
-  
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Method: RunHandshake
+///
+/// Details:  The sensors are sampled only when the roboRIO asks.
+////////////////////////////////////////////////////////////////////////////////
+void YtaRioduino::RunHandshake()
+{
   // This approach is an interurpt based communication mechanism.
   // The roboRIO will interrupt the RIOduino when it wants new data.
   // The loops waiting on a state change will poll for a new I2C
@@ -317,19 +364,39 @@ void YtaRioduino::I2cOnReceive(int bytesReceived)
 ////////////////////////////////////////////////////////////////////////////////
 /// Method: I2cOnRequest
 ///
-/// Details:  Sends I2C data to the roboRIO.
+/// Details:  Sends I2C data to the roboRIO.  The newest complete frame gets its
+///           sample age filled in (which means a new CRC) right before it is
+///           sent.  Only the part of the frame in use is sent.
 ////////////////////////////////////////////////////////////////////////////////
 void YtaRioduino::I2cOnRequest()
 {
-  Wire.write(reinterpret_cast<byte *>(&m_I2cData), sizeof(m_I2cData));
+  // The main loop only builds the other frame, so this one can't change underneath
+  const uint8_t readyFrame = m_ReadyI2cFrame;
+  I2cDataFrame & rFrame = m_I2cFrames[readyFrame];
+  
+  if (rFrame.m_PayloadLength > 0U)
+  {
+    unsigned long ageMs = millis() - m_I2cFrameSampleTimesMs[readyFrame];
+    if (ageMs > MAX_SAMPLE_AGE_MS)
+    {
+      ageMs = MAX_SAMPLE_AGE_MS;
+    }
+    
+    RoborioRioduinoSharedData::SampleAgeI2cData ageData;
+    ageData.m_AgeMs = static_cast<uint16_t>(ageMs);
+    memcpy(&rFrame.m_Payloads[I2cDataFrame::I2C_SAMPLE_AGE_OFFSET], &ageData, sizeof(ageData));
+    rFrame.m_Payloads[rFrame.m_PayloadLength] = RoborioRioduinoSharedData::ComputeFrameCrc(rFrame);
+  }
+  
+  Wire.write(reinterpret_cast<byte *>(&rFrame), RoborioRioduinoSharedData::GetFrameSize(rFrame));
   
   m_bI2cDataRead = true;
 
   if (DEBUG_I2C_TRANSACTIONS)
   {
     Serial.print("On request: ");
-    const byte * pData = reinterpret_cast<byte *>(&m_I2cData);
-    for (size_t i = 0; i < sizeof(m_I2cData); i++)
+    const byte * pData = reinterpret_cast<byte *>(&rFrame);
+    for (size_t i = 0; i < RoborioRioduinoSharedData::GetFrameSize(rFrame); i++)
     {
       Serial.print(*pData++, HEX);
       Serial.print(" ");
@@ -393,43 +460,79 @@ void YtaRioduino::CheckForAndProcessI2cCommand()
 ////////////////////////////////////////////////////////////////////////////////
 /// Method: BuildI2cData
 ///
-/// Details:  Builds the data to send over to the roboRIO.
+/// Details:  Builds the data frame to send over to the roboRIO.  All of the
+///           latest sensor data goes in one frame so the roboRIO gets it with
+///           a single transaction.  The frame is built in the spare buffer and
+///           then made the ready one with a single byte write, so the request
+///           handler always sends one complete frame or the other.
 ////////////////////////////////////////////////////////////////////////////////
 void YtaRioduino::BuildI2cData()
 {
-  // Clear the buffer with a marker in case there's a need to debug
-  memset(&m_I2cData, I2C_BUFFER_MARKER, sizeof(m_I2cData));
-  
-  // Set the header/footer info
-  m_I2cData.m_Header = RoborioRioduinoSharedData::I2C_HEADER_DATA;
-  m_I2cData.m_Footer = RoborioRioduinoSharedData::I2C_FOOTER_DATA;
-  
-  // Indicate gyro data is being sent over
-  m_I2cData.m_DataSelection = RoborioRioduinoSharedData::I2cDataSelection::GYRO_DATA;
-  
-  // Temporary test sending 0 -> 360
-  m_I2cData.m_DataBuffer.m_GyroData.m_xAxisInfo.m_bIsNegative = false;
-  m_I2cData.m_DataBuffer.m_GyroData.m_xAxisInfo.m_Angle = static_cast<uint16_t>(round(m_RobotAbsoluteAngle));
-  return;
+  const uint8_t buildFrame = m_ReadyI2cFrame ^ 1U;
+  I2cDataFrame & rFrame = m_I2cFrames[buildFrame];
   
-  // First get the robot angle since it will be manipulated before sending
-  double robotAngle = m_RobotAngle;
-  
-  // Check if it's negative
-  if (robotAngle < 0.0)
-  {    
-    m_I2cData.m_DataBuffer.m_GyroData.m_xAxisInfo.m_bIsNegative = true;
-    
-    // For simplicity with the different architectures, always send a positive angle
-    robotAngle *= -1.0;
-  }
-  else
+  // Clear the buffer with a marker in case there's a need to debug
+  memset(&rFrame, I2C_BUFFER_MARKER, sizeof(rFrame));
+  
+  // Set the frame info
+  rFrame.m_Header = RoborioRioduinoSharedData::I2C_HEADER_DATA;
+  rFrame.m_Version = RoborioRioduinoSharedData::I2C_PROTOCOL_VERSION;
+  rFrame.m_Sequence = m_I2cSequence++;
+  rFrame.m_PayloadLength = 0U;
+  
+  // The age has to be first, it's filled in when the frame is sent
+  RoborioRioduinoSharedData::SampleAgeI2cData ageData;
+  ageData.m_AgeMs = 0U;
+  AddI2cPayload(rFrame, RoborioRioduinoSharedData::SAMPLE_AGE_DATA, &ageData, sizeof(ageData));
+  
+  // Gyro angles, with the sign carried in the value.  The
+  // heading is relative to the center (-180 to 180), not the
+  // absolute 0 to 360 the old test path sent.
+  // Sonar data would be added here the same way once
+  // sonar sensors are connected to the RIOduino.
+  RoborioRioduinoSharedData::GyroI2cData gyroData;
+  gyroData.m_xAngle = ToGyroI2cAngle(m_RobotAngle);
+  gyroData.m_yAngle = ToGyroI2cAngle(m_RobotYAngle);
+  gyroData.m_zAngle = ToGyroI2cAngle(m_RobotZAngle);
+  AddI2cPayload(rFrame, RoborioRioduinoSharedData::GYRO_DATA, &gyroData, sizeof(gyroData));
+  
+  // The CRC goes right after the last payload
+  rFrame.m_Payloads[rFrame.m_PayloadLength] = RoborioRioduinoSharedData::ComputeFrameCrc(rFrame);
+  
+  m_I2cFrameSampleTimesMs[buildFrame] = m_LastSampleTimeMs;
+  m_ReadyI2cFrame = buildFrame;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Method: AddI2cPayload
+///
+/// Details:  Appends one payload to an I2C data frame, if there's room.
+////////////////////////////////////////////////////////////////////////////////
+void YtaRioduino::AddI2cPayload(I2cDataFrame & rFrame, RoborioRioduinoSharedData::I2cDataSelection selection, const void * pPayload, uint8_t size)
+{
+  const uint8_t length = rFrame.m_PayloadLength;
+  if ((length + I2cDataFrame::I2C_PAYLOAD_OVERHEAD_BYTES + size) > I2cDataFrame::I2C_MAX_PAYLOAD_BYTES)
   {
-    m_I2cData.m_DataBuffer.m_GyroData.m_xAxisInfo.m_bIsNegative = false;
+    DisplayMessage("I2C payload does not fit.");
+    return;
   }
   
-  // Set the angle, deliberately converting to an integer value
-  m_I2cData.m_DataBuffer.m_GyroData.m_xAxisInfo.m_Angle = static_cast<uint16_t>(round(robotAngle));
+  rFrame.m_Payloads[length] = selection;
+  rFrame.m_Payloads[length + 1] = size;
+  memcpy(&rFrame.m_Payloads[length + I2cDataFrame::I2C_PAYLOAD_OVERHEAD_BYTES], pPayload, size);
+  rFrame.m_PayloadLength = length + I2cDataFrame::I2C_PAYLOAD_OVERHEAD_BYTES + size;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Method: ToGyroI2cAngle
+///
+/// Details:  Converts an angle in degrees to the fixed point I2C format.
+////////////////////////////////////////////////////////////////////////////////
+int16_t YtaRioduino::ToGyroI2cAngle(double angle)
+{
+  return static_cast<int16_t>(round(angle * RoborioRioduinoSharedData::GyroI2cData::ANGLE_UNITS_PER_DEGREE));
 }
 
 
@@ -440,7 +543,7 @@ void YtaRioduino::BuildI2cData()
 ////////////////////////////////////////////////////////////////////////////////
 void YtaRioduino::GetGyroData()
 {
-  // This will only be called on demand, no need for time controls
+  // Called on demand or at the streaming rate, no need for time controls
   
   // For normalization to arbitrary angle as center:
   //
@@ -455,6 +558,7 @@ void YtaRioduino::GetGyroData()
   // }
   
   // Get a new sensor event
+  m_LastSampleTimeMs = millis();
   sensors_event_t bnoSensorEvent;
   m_Bno055.getEvent(&bnoSensorEvent);
   
@@ -470,6 +574,8 @@ void YtaRioduino::GetGyroData()
   // The relative angle needs to be computed from the absolute angle.
   m_RobotAbsoluteAngle = bnoSensorEvent.orientation.x;
   m_RobotRelativeAngle = m_RobotAbsoluteAngle - m_RobotCenterPoint;
+  m_RobotYAngle = bnoSensorEvent.orientation.y;
+  m_RobotZAngle = bnoSensorEvent.orientation.z;
   
   // The relative angle can be anywhere from -360 to + 360 at this point.
   // We need an angle between 0 -> 360 only.
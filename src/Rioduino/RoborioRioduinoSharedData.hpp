@@ -43,8 +43,13 @@ namespace RoborioRioduinoSharedData
     // The roboRIO and RIOduino talk over I2C at this address
     static const int I2C_DEVICE_ADDRESS = 4U;
     
-    // A constant indicating the max I2C transaction size that can occur
-    static const unsigned int I2C_MAX_TRANSACTION_SIZE = 16U;
+    // When streaming, the RIOduino samples on its own and the roboRIO
+    // just reads the latest frame.  Otherwise each frame is requested
+    // with the interrupt/data ready handshake.
+    static const bool I2C_STREAMING_MODE = true;
+    
+    // A constant indicating the max I2C transaction size that can occur (the Arduino Wire buffer size)
+    static const unsigned int I2C_MAX_TRANSACTION_SIZE = 32U;
     
     // There are two types of transfers:
     // 1. Commands (master to slave, i.e. roboRIO to RIOduino)
@@ -106,27 +111,49 @@ namespace RoborioRioduinoSharedData
     
     
     ////////////////////////////////////////////////////////////////
-    /// DATA SELECTIONS
+    /// DATA FRAMES (protocol version 2)
     ///
     /// Layout:
-    /// |   0    |     1     |       2-10      |   11   |
-    /// | Header | Selection | Response buffer | Footer |
+    /// |   0    |    1    |    2     |   3    |  4 .. 3+N  |  4+N  |
+    /// | Header | Version | Sequence | Length |  Payloads  | CRC-8 |
+    ///
+    /// Length is the number of payload bytes (N).  The sequence
+    /// counts up once per new frame so repeated or missed frames
+    /// can be detected.  The CRC covers every byte before it.
+    /// Frames are only as long as their payloads, the roboRIO
+    /// reads the maximum size and ignores anything past the CRC.
+    ///
+    /// Each payload:
+    /// |    0      |  1   |  2 .. 1+S  |
+    /// | Selection | Size |    Data    |
+    ///
+    /// Sample age (2 bytes, always the first payload):
+    /// | Milliseconds since the sensors were read |
     ///
-    /// Sonar buffer:
-    /// |   2   |   3   |  4   |  5   |  6   |  7   |  8   |  9   |
+    /// Sonar data (8 bytes):
     /// | frntA | frntB | lftA | lftB | bckA | bckB | rgtA | rgtB |
     ///
-    /// Gyro buffer:
-    /// |  2   |  3-4 |  5   |  6-7 |  8   | 9-10 |
-    /// | xNeg | xAng | yNeg | yAng | zNeg | zAng |
+    /// Gyro data (6 bytes, signed 1/16 degree units):
+    /// | xAngle | yAngle | zAngle |
     ///
     ////////////////////////////////////////////////////////////////
     
-    // Controls which data structure is active in a transfer
+    // The version of the data frame layout
+    static const uint8_t I2C_PROTOCOL_VERSION = 2U;
+    
+    // Identifies the type of each payload in a frame
     enum I2cDataSelection : uint8_t
     {
         SONAR_DATA = 1,
-        GYRO_DATA = 2
+        GYRO_DATA = 2,
+        SAMPLE_AGE_DATA = 3
+    };
+    
+    // Data structure for transferring how old the rest of the frame is.
+    // It's filled in as the frame is sent, which is why it comes first.
+    struct PACKED SampleAgeI2cData
+    {
+        uint16_t m_AgeMs;
     };
     
     // Data structure for transferring sonar data
@@ -144,55 +171,78 @@ namespace RoborioRioduinoSharedData
         Distances m_RightDistances;
     };
     
-    // Data structure for transferring BNO055 gyro data
-    struct GyroI2cData
+    // Data structure for transferring BNO055 gyro data.
+    // Angles are fixed point with the sign in the value.
+    // The heading (x) is -180 to 180 degrees from the center set
+    // by GYRO_READ_NEW_CENTER, positive clockwise.  It used to be
+    // the absolute 0 to 360 degree heading from the sensor.
+    struct PACKED GyroI2cData
     {
-        struct AxisInfo
-        {
-          // Using uint16_t as the roboRIO compiler is padding uint8_t
-          uint16_t m_bIsNegative;
-          uint16_t m_Angle;
-        };
-        
-        AxisInfo m_xAxisInfo;
-        AxisInfo m_yAxisInfo;
-        AxisInfo m_zAxisInfo;
+        int16_t m_xAngle;
+        int16_t m_yAngle;
+        int16_t m_zAngle;
         
-        static const uint16_t MAX_VALID_ANGLE_VALUE = 360U;
+        // The same resolution the BNO055 reports Euler angles in
+        static const int16_t ANGLE_UNITS_PER_DEGREE = 16;
+        static const int16_t MAX_VALID_ANGLE_VALUE = 360 * ANGLE_UNITS_PER_DEGREE;
     };
     
-    // Represents the I2C data that will be transferred
-    struct I2cData
+    // Make sure the payloads are laid out the same on both architectures
+    static_assert(sizeof(SonarI2cData) == 8U, "Sonar payload wrong size.");
+    static_assert(sizeof(GyroI2cData) == 6U, "Gyro payload wrong size.");
+    static_assert(sizeof(SampleAgeI2cData) == 2U, "Sample age payload wrong size.");
+    
+    // Represents the I2C data frame that will be transferred
+    struct I2cDataFrame
     {
-        // From debugging, it looks like I2C transactions should be limited to low sizes
-        static const uint8_t I2C_DATA_EXPECTED_SIZE_BYTES = 16U;
-        static const uint8_t I2C_DATA_BUFFER_SIZE_BYTES = I2C_DATA_EXPECTED_SIZE_BYTES - (2 * sizeof(HeaderFooterType)) - sizeof(I2cDataSelection);
-        
-        // Represents different possible ways of interpreting the data buffer
-        union PACKED DataBuffer
-        {
-            SonarI2cData    m_SonarData;
-            GyroI2cData     m_GyroData;
-            uint8_t         m_RawBuffer[I2C_DATA_BUFFER_SIZE_BYTES];
-        };
-        
-        // Make sure the compiler created the shared buffer correctly
-        static_assert(sizeof(DataBuffer) == I2C_DATA_BUFFER_SIZE_BYTES, "I2C data buffer wrong size.");
-        
-        // Make sure the overlayed data structures fit in the space set aside
-        static_assert(sizeof(SonarI2cData) <= I2C_DATA_BUFFER_SIZE_BYTES, "I2C data buffer not big enough for sonar data.");
-        static_assert(sizeof(GyroI2cData)  <= I2C_DATA_BUFFER_SIZE_BYTES, "I2C data buffer not big enough for gyro data.");
+        // Header, version, sequence, length and CRC
+        static const uint8_t I2C_FRAME_OVERHEAD_BYTES = 5U;
+        // Each payload is preceded by its selection and size
+        static const uint8_t I2C_PAYLOAD_OVERHEAD_BYTES = 2U;
+        // Room for every payload type at once
+        static const uint8_t I2C_MAX_PAYLOAD_BYTES = (3 * I2C_PAYLOAD_OVERHEAD_BYTES) + sizeof(SampleAgeI2cData) + sizeof(SonarI2cData) + sizeof(GyroI2cData);
+        // Where the sample age data sits in the payloads
+        static const uint8_t I2C_SAMPLE_AGE_OFFSET = I2C_PAYLOAD_OVERHEAD_BYTES;
+        static const uint8_t I2C_FRAME_MAX_SIZE_BYTES = I2C_FRAME_OVERHEAD_BYTES + I2C_MAX_PAYLOAD_BYTES;
         
         // The members of the I2C transfer data structure
         HeaderFooterType    m_Header;
-        I2cDataSelection    m_DataSelection;
-        DataBuffer          m_DataBuffer;
-        HeaderFooterType    m_Footer;
+        uint8_t             m_Version;
+        uint8_t             m_Sequence;
+        uint8_t             m_PayloadLength;
+        uint8_t             m_Payloads[I2C_MAX_PAYLOAD_BYTES + 1];  // The CRC follows the last payload
     };
     
     // Make sure the overall data structure has the correct size
-    static_assert(sizeof(I2cData) == I2cData::I2C_DATA_EXPECTED_SIZE_BYTES, "I2C data does not equal expected size.");
-    static_assert(sizeof(I2cData) <= I2C_MAX_TRANSACTION_SIZE, "I2C data exceeds maximum allowed size.");
+    static_assert(sizeof(I2cDataFrame) == I2cDataFrame::I2C_FRAME_MAX_SIZE_BYTES, "I2C data frame does not equal expected size.");
+    static_assert(sizeof(I2cDataFrame) <= I2C_MAX_TRANSACTION_SIZE, "I2C data frame exceeds maximum allowed size.");
+    
+    // How many bytes of a frame are actually in use, including the CRC (check the length is valid first)
+    inline unsigned GetFrameSize(const I2cDataFrame & rFrame)
+    {
+        return (I2cDataFrame::I2C_FRAME_OVERHEAD_BYTES + rFrame.m_PayloadLength);
+    }
+    
+    // CRC-8 (polynomial 0x07), bitwise to keep it small on the RIOduino
+    inline uint8_t ComputeCrc8(const uint8_t * pData, unsigned length)
+    {
+        uint8_t crc = 0U;
+        for (unsigned i = 0U; i < length; i++)
+        {
+            crc ^= pData[i];
+            for (unsigned bit = 0U; bit < 8U; bit++)
+            {
+                crc = ((crc & 0x80U) != 0U) ? static_cast<uint8_t>((crc << 1) ^ 0x07U) : static_cast<uint8_t>(crc << 1);
+            }
+        }
+        return crc;
+    }
+    
+    // The CRC of everything in a frame before the CRC byte
+    inline uint8_t ComputeFrameCrc(const I2cDataFrame & rFrame)
+    {
+        return ComputeCrc8(reinterpret_cast<const uint8_t *>(&rFrame), GetFrameSize(rFrame) - 1U);
+    }
 }
 
 #endif // ROBORIORIODUINOSHAREDDATA_HPP
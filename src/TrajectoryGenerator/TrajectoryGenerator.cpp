@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   TrajectoryGenerator.cpp
+/// @author David Stalter
+///
+/// @details
+/// Offline tool that turns a list of waypoints into a trajectory file the robot
+/// can follow.  It is not part of the robot build, compile it on a PC with:
+///
+///     g++ -std=c++17 -O2 -o TrajectoryGenerator TrajectoryGenerator.cpp
+///
+/// Usage: TrajectoryGenerator CommonRed.txt CommonRed.traj
+///            [max velocity in/s] [max acceleration in/s^2] [max turning acceleration in/s^2]
+///
+/// Each waypoint line is "x y heading", in inches and degrees counter
+/// clockwise from the starting pose.  Blank lines and lines starting with '#'
+/// are ignored.  Put the output in src/main/deploy/trajectories so it gets
+/// deployed with the robot code.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                                        // for trig functions
+#include <cstdio>                                       // for file I/O
+#include <cstdlib>                                      // for atof
+#include <cstring>                                      // for memcpy
+#include <vector>                                       // for std::vector
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "../main/include/TrajectoryRecords.hpp"        // for the trajectory file layout
+
+using namespace TrajectoryRecords;
+
+// Matches the robot loop (YtaRobotAutonomous::ENCODER_DRIVE_PERIOD_S)
+static const double PERIOD_S = 0.02;
+
+// How finely each spline is walked before time is worked out
+static const unsigned SAMPLES_PER_SPLINE = 2000U;
+
+// How long the tangent is at each waypoint, as a fraction of the distance between them
+static const double TANGENT_SCALE = 1.2;
+
+struct Waypoint
+{
+    double  m_X;
+    double  m_Y;
+    double  m_Heading;
+};
+
+// A point along the path before time is known
+struct PathSample
+{
+    double  m_Distance;
+    double  m_X;
+    double  m_Y;
+    double  m_Heading;
+    double  m_Curvature;
+    double  m_Velocity;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ReadWaypoints
+///
+/// Reads the waypoint file.  Returns false if it can't be read
+/// or there aren't at least two waypoints.
+///
+////////////////////////////////////////////////////////////////
+static bool ReadWaypoints(const char * pFileName, std::vector<Waypoint> & rWaypoints)
+{
+    std::FILE * pFile = std::fopen(pFileName, "r");
+    if (pFile == nullptr)
+    {
+        std::fprintf(stderr, "Could not open %s.\n", pFileName);
+        return false;
+    }
+
+    char line[256];
+    while (std::fgets(line, sizeof(line), pFile) != nullptr)
+    {
+        Waypoint waypoint;
+        double headingDegrees = 0.0;
+        if ((line[0] == '#') || (std::sscanf(line, "%lf %lf %lf", &waypoint.m_X, &waypoint.m_Y, &headingDegrees) != 3))
+        {
+            continue;
+        }
+        waypoint.m_Heading = headingDegrees * M_PI / 180.0;
+        rWaypoints.push_back(waypoint);
+    }
+    std::fclose(pFile);
+
+    if (rWaypoints.size() < 2U)
+    {
+        std::fprintf(stderr, "%s needs at least two waypoints.\n", pFileName);
+        return false;
+    }
+    return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SampleSplines
+///
+/// Joins each pair of waypoints with a quintic Hermite spline.
+/// The second derivatives are zero at the waypoints, so the
+/// curvature is continuous (zero) where the splines meet and
+/// the robot never has to change its turn rate instantly.
+///
+////////////////////////////////////////////////////////////////
+static void SampleSplines(const std::vector<Waypoint> & rWaypoints, std::vector<PathSample> & rSamples)
+{
+    double distance = 0.0;
+    double lastX = rWaypoints[0].m_X;
+    double lastY = rWaypoints[0].m_Y;
+
+    for (unsigned spline = 0U; (spline + 1U) < rWaypoints.size(); spline++)
+    {
+        const Waypoint & rStart = rWaypoints[spline];
+        const Waypoint & rEnd = rWaypoints[spline + 1U];
+        const double tangentLength = TANGENT_SCALE * std::hypot(rEnd.m_X - rStart.m_X, rEnd.m_Y - rStart.m_Y);
+        const double startTangentX = tangentLength * std::cos(rStart.m_Heading);
+        const double startTangentY = tangentLength * std::sin(rStart.m_Heading);
+        const double endTangentX = tangentLength * std::cos(rEnd.m_Heading);
+        const double endTangentY = tangentLength * std::sin(rEnd.m_Heading);
+
+        // Splines after the first skip their start, it's the end of the one before
+        for (unsigned i = (spline == 0U) ? 0U : 1U; i <= SAMPLES_PER_SPLINE; i++)
+        {
+            const double t = static_cast<double>(i) / SAMPLES_PER_SPLINE;
+            const double t2 = t * t;
+            const double t3 = t2 * t;
+            const double t4 = t3 * t;
+            const double t5 = t4 * t;
+
+            // Basis functions for the start point, start tangent, end tangent and end point
+            const double h0 = 1.0 - (10.0 * t3) + (15.0 * t4) - (6.0 * t5);
+            const double h1 = t - (6.0 * t3) + (8.0 * t4) - (3.0 * t5);
+            const double h4 = -(4.0 * t3) + (7.0 * t4) - (3.0 * t5);
+            const double h5 = (10.0 * t3) - (15.0 * t4) + (6.0 * t5);
+            const double dh0 = -(30.0 * t2) + (60.0 * t3) - (30.0 * t4);
+            const double dh1 = 1.0 - (18.0 * t2) + (32.0 * t3) - (15.0 * t4);
+            const double dh4 = -(12.0 * t2) + (28.0 * t3) - (15.0 * t4);
+            const double dh5 = (30.0 * t2) - (60.0 * t3) + (30.0 * t4);
+            const double ddh0 = -(60.0 * t) + (180.0 * t2) - (120.0 * t3);
+            const double ddh1 = -(36.0 * t) + (96.0 * t2) - (60.0 * t3);
+            const double ddh4 = -(24.0 * t) + (84.0 * t2) - (60.0 * t3);
+            const double ddh5 = (60.0 * t) - (180.0 * t2) + (120.0 * t3);
+
+            PathSample sample;
+            sample.m_X = (h0 * rStart.m_X) + (h1 * startTangentX) + (h4 * endTangentX) + (h5 * rEnd.m_X);
+            sample.m_Y = (h0 * rStart.m_Y) + (h1 * startTangentY) + (h4 * endTangentY) + (h5 * rEnd.m_Y);
+
+            const double dx = (dh0 * rStart.m_X) + (dh1 * startTangentX) + (dh4 * endTangentX) + (dh5 * rEnd.m_X);
+            const double dy = (dh0 * rStart.m_Y) + (dh1 * startTangentY) + (dh4 * endTangentY) + (dh5 * rEnd.m_Y);
+            const double ddx = (ddh0 * rStart.m_X) + (ddh1 * startTangentX) + (ddh4 * endTangentX) + (ddh5 * rEnd.m_X);
+            const double ddy = (ddh0 * rStart.m_Y) + (ddh1 * startTangentY) + (ddh4 * endTangentY) + (ddh5 * rEnd.m_Y);
+            const double speed = std::hypot(dx, dy);
+
+            sample.m_Heading = std::atan2(dy, dx);
+            sample.m_Curvature = (speed > 0.0) ? (((dx * ddy) - (dy * ddx)) / (speed * speed * speed)) : 0.0;
+
+            distance += std::hypot(sample.m_X - lastX, sample.m_Y - lastY);
+            sample.m_Distance = distance;
+            sample.m_Velocity = 0.0;
+            lastX = sample.m_X;
+            lastY = sample.m_Y;
+
+            rSamples.push_back(sample);
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LimitVelocities
+///
+/// Picks the fastest velocity at each sample that the limits
+/// allow.  Curves are limited by the turning acceleration, then
+/// a forward pass limits speeding up from rest at the start and
+/// a backward pass limits slowing down to rest at the end.
+///
+////////////////////////////////////////////////////////////////
+static void LimitVelocities(std::vector<PathSample> & rSamples, double maxVelocity, double maxAcceleration, double maxTurningAcceleration)
+{
+    for (PathSample & rSample : rSamples)
+    {
+        rSample.m_Velocity = maxVelocity;
+        if (std::abs(rSample.m_Curvature) > 0.0)
+        {
+            rSample.m_Velocity = std::fmin(maxVelocity, std::sqrt(maxTurningAcceleration / std::abs(rSample.m_Curvature)));
+        }
+    }
+
+    rSamples.front().m_Velocity = 0.0;
+    for (unsigned i = 1U; i < rSamples.size(); i++)
+    {
+        const double ds = rSamples[i].m_Distance - rSamples[i - 1U].m_Distance;
+        const double reachable = std::sqrt((rSamples[i - 1U].m_Velocity * rSamples[i - 1U].m_Velocity) + (2.0 * maxAcceleration * ds));
+        rSamples[i].m_Velocity = std::fmin(rSamples[i].m_Velocity, reachable);
+    }
+
+    rSamples.back().m_Velocity = 0.0;
+    for (unsigned i = rSamples.size() - 1U; i > 0U; i--)
+    {
+        const double ds = rSamples[i].m_Distance - rSamples[i - 1U].m_Distance;
+        const double reachable = std::sqrt((rSamples[i].m_Velocity * rSamples[i].m_Velocity) + (2.0 * maxAcceleration * ds));
+        rSamples[i - 1U].m_Velocity = std::fmin(rSamples[i - 1U].m_Velocity, reachable);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ResamplePoints
+///
+/// Works out when the robot reaches each sample (assuming the
+/// velocity changes evenly between them), then picks out one
+/// point per robot loop.
+///
+////////////////////////////////////////////////////////////////
+static void ResamplePoints(const std::vector<PathSample> & rSamples, std::vector<Point> & rPoints)
+{
+    std::vector<double> times(rSamples.size(), 0.0);
+    for (unsigned i = 1U; i < rSamples.size(); i++)
+    {
+        const double ds = rSamples[i].m_Distance - rSamples[i - 1U].m_Distance;
+        const double velocitySum = rSamples[i].m_Velocity + rSamples[i - 1U].m_Velocity;
+        times[i] = times[i - 1U] + ((velocitySum > 0.0) ? ((2.0 * ds) / velocitySum) : 0.0);
+    }
+
+    unsigned sample = 0U;
+    for (unsigned loop = 0U; ; loop++)
+    {
+        const double time = loop * PERIOD_S;
+        while (((sample + 1U) < rSamples.size()) && (times[sample + 1U] <= time))
+        {
+            sample++;
+        }
+
+        Point point;
+        point.m_TimeS = static_cast<float>(time);
+        if ((sample + 1U) >= rSamples.size())
+        {
+            // Past the end, hold the last sample at rest
+            const PathSample & rLast = rSamples.back();
+            point.m_X = static_cast<float>(rLast.m_X);
+            point.m_Y = static_cast<float>(rLast.m_Y);
+            point.m_Heading = static_cast<float>(rLast.m_Heading);
+            point.m_Velocity = 0.0F;
+            point.m_Acceleration = 0.0F;
+            point.m_Curvature = static_cast<float>(rLast.m_Curvature);
+            rPoints.push_back(point);
+            break;
+        }
+
+        const PathSample & rBefore = rSamples[sample];
+        const PathSample & rAfter = rSamples[sample + 1U];
+        const double span = times[sample + 1U] - times[sample];
+        const double fraction = (span > 0.0) ? ((time - times[sample]) / span) : 0.0;
+        const double headingChange = std::remainder(rAfter.m_Heading - rBefore.m_Heading, 2.0 * M_PI);
+
+        point.m_X = static_cast<float>(rBefore.m_X + (fraction * (rAfter.m_X - rBefore.m_X)));
+        point.m_Y = static_cast<float>(rBefore.m_Y + (fraction * (rAfter.m_Y - rBefore.m_Y)));
+        point.m_Heading = static_cast<float>(std::remainder(rBefore.m_Heading + (fraction * headingChange), 2.0 * M_PI));
+        point.m_Velocity = static_cast<float>(rBefore.m_Velocity + (fraction * (rAfter.m_Velocity - rBefore.m_Velocity)));
+        point.m_Acceleration = static_cast<float>((span > 0.0) ? ((rAfter.m_Velocity - rBefore.m_Velocity) / span) : 0.0);
+        point.m_Curvature = static_cast<float>(rBefore.m_Curvature + (fraction * (rAfter.m_Curvature - rBefore.m_Curvature)));
+        rPoints.push_back(point);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method main
+///
+/// Generates a trajectory from the waypoint file and writes it.
+///
+////////////////////////////////////////////////////////////////
+int main(int argc, char * argv[])
+{
+    if ((argc != 3) && (argc != 6))
+    {
+        std::fprintf(stderr, "Usage: %s <waypoints> <output> [max velocity] [max acceleration] [max turning acceleration]\n", argv[0]);
+        return 1;
+    }
+
+    // Defaults are a little under the encoder drive limits, since paths also turn
+    double maxVelocity = 100.0;
+    double maxAcceleration = 80.0;
+    double maxTurningAcceleration = 60.0;
+    if (argc == 6)
+    {
+        maxVelocity = std::atof(argv[3]);
+        maxAcceleration = std::atof(argv[4]);
+        maxTurningAcceleration = std::atof(argv[5]);
+    }
+    if ((maxVelocity <= 0.0) || (maxAcceleration <= 0.0) || (maxTurningAcceleration <= 0.0))
+    {
+        std::fprintf(stderr, "The limits must be positive.\n");
+        return 1;
+    }
+
+    std::vector<Waypoint> waypoints;
+    if (!ReadWaypoints(argv[1], waypoints))
+    {
+        return 1;
+    }
+
+    std::vector<PathSample> samples;
+    SampleSplines(waypoints, samples);
+    LimitVelocities(samples, maxVelocity, maxAcceleration, maxTurningAcceleration);
+
+    std::vector<Point> points;
+    ResamplePoints(samples, points);
+
+    std::FILE * pOutFile = std::fopen(argv[2], "wb");
+    if (pOutFile == nullptr)
+    {
+        std::fprintf(stderr, "Could not create %s.\n", argv[2]);
+        return 1;
+    }
+
+    FileHeader header;
+    std::memcpy(header.m_Magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC));
+    header.m_Version = TRAJECTORY_VERSION;
+    header.m_PointSize = sizeof(Point);
+    header.m_NumPoints = static_cast<uint32_t>(points.size());
+    header.m_PeriodS = static_cast<float>(PERIOD_S);
+
+    const bool bWritten = (std::fwrite(&header, sizeof(header), 1, pOutFile) == 1U)
+                       && (std::fwrite(points.data(), sizeof(Point), points.size(), pOutFile) == points.size());
+    std::fclose(pOutFile);
+    if (!bWritten)
+    {
+        std::fprintf(stderr, "Could not write %s.\n", argv[2]);
+        return 1;
+    }
+
+    std::printf("%s: %.1f in, %.2f s, %u points\n", argv[2], samples.back().m_Distance, points.back().m_TimeS, static_cast<unsigned>(points.size()));
+    return 0;
+}
@@ -15,166 +15,127 @@
 // (none)
 
 // C++ INCLUDES
-#include "RobotUtils.hpp"               // for DEBUG_PRINTS
+#include "RobotTelemetry.hpp"           // for publishing telemetry
+#include "TrapezoidalProfile.hpp"       // for following a motion profile
 #include "YtaRobot.hpp"                 // for robot class declaration
 #include "YtaRobotAutonomous.hpp"       // for autonomous declarations
 
 
 
 ////////////////////////////////////////////////////////////////
-/// @method YtaRobot::GetEncoderRotationsFromInches
-///
-/// Returns a number of encoder turns based on input distance in
-/// inches and a diameter of the object turning.  It is based on
-/// the 4x (4096) quadrature encoders.
-///
-////////////////////////////////////////////////////////////////
-int YtaRobot::GetEncoderRotationsFromInches(int inches, double diameter, bool bUseQuadEncoding)
-{
-    // c = PI*d
-    // (PI*d)/4096 is ratio of one encoder turn to a distance of
-    // travel of one diameter rotations.  To scale up, use cross
-    // multiply and divide.  Therefore:
-    //   PI * d     x(in.)
-    //  -------- = --------
-    //    4096      y(rot)
-    // x and d are inputs, so solve for y.
-    // y = (4096x)/(PI*d)
-    // This is for quadrature encoding, so if analog (single)
-    // encoding is desired, the result needs to be divided by four.
-    // If 4" wheels are in use, 3911.39188 turns = 12"
-    volatile int numerator = QUADRATURE_ENCODING_ROTATIONS * inches;
-    volatile double denominator = M_PI * diameter;
-    volatile int result = numerator / denominator;
-    //int result = (QUADRATURE_ENCODING_ROTATIONS * inches) / (M_PI * diameter);
-    
-    if (!bUseQuadEncoding)
-    {
-        result /= 4;
-    }
-    
-    return result;
-}
-
-
-
-////////////////////////////////////////////////////////////////
-// @method YtaRobot::AutonomousEncoderDrive
+/// @method YtaRobot::AutonomousEncoderDrive
 ///
 /// Autonomous method to drive the robot controlled by the
-/// encoders.
+/// encoders.  It is called once per loop by the autonomous
+/// step engine.  The first call works out a motion profile for
+/// the whole move and saves where the encoders are, since a
+/// tare goes out over CAN and wouldn't show up in the next few
+/// reads.  Distances are measured from there.  Each call then
+/// follows the next setpoint with feed forward plus a
+/// correction for being ahead or behind.  The difference
+/// between the sides steers the robot straight.  It returns
+/// true once the profile is done and the robot has settled at
+/// the distance.
 ///
 ////////////////////////////////////////////////////////////////
-void YtaRobot::AutonomousEncoderDrive(double speed, double distance, RobotDirection direction)
+bool YtaRobot::AutonomousEncoderDrive(double speed, double distance, RobotDirection direction, bool bFirstTick)
 {
     // 20xx LEFT ENCODER VALUE DECREASES GOING FORWARD
     // 20xx RIGHT ENCODER VALUE INCREASES GOING FORWARD
     
-    // 1024 is the encoder output after one rotation
-    // 20xx Wheels are 4", therefore circumference = 4*PI
-    // Ratio is (4*PI)/1024 = PI/256
-    //
-    //   x  |  y  
-    // -----------
-    //  12" | (3072 / PI) = 977.84797
-    //  24" | (6144 / PI) = 1955.6959
-    //  ... | ...
-    // 120" | (30720 / PI) = 9778.4797
-    // 132" | (33792 / PI) = 10756.32767
-    // 144" | (36864 / PI) = 11734.17564
-    
-    // New drive operation, tare encoders
-    m_pLeftDriveMotors->TareEncoder();
-    m_pRightDriveMotors->TareEncoder();
-    
-    // Start the safety timer        
-    m_pSafetyTimer->Reset();
-    m_pSafetyTimer->Start();
+    const int leftEncoder = m_pLeftDriveMotors->GetEncoderValue();
+    const int rightEncoder = m_pRightDriveMotors->GetEncoderValue();
+    if (bFirstTick)
+    {
+        m_EncoderDriveLeftStart = leftEncoder;
+        m_EncoderDriveRightStart = rightEncoder;
+    }
     
-    // Get initial encoder values
     int leftEncVal = 0;
     int rightEncVal = 0;
+    double leftDriveScale = 0.0;
+    double rightDriveScale = 0.0;
     
-    do
+    // Get encoder values to always be positive, based on direction.
+    // Also scale the drive motors for direction.
+    switch (direction)
     {
-        if (!m_pDriverStation->IsAutonomous())
+        case ROBOT_FORWARD:
         {
+            leftEncVal = -(leftEncoder - m_EncoderDriveLeftStart);
+            rightEncVal = rightEncoder - m_EncoderDriveRightStart;
+            leftDriveScale = LEFT_DRIVE_FORWARD_SCALAR;
+            rightDriveScale = RIGHT_DRIVE_FORWARD_SCALAR;
             break;
         }
-        
-        // Set speeds, adjust below if needed
-        double leftDriveSpeed = speed;
-        double rightDriveSpeed = speed;
-        double leftDriveScale = 0.0;
-        double rightDriveScale = 0.0;
-        
-        // Get encoder values to always be positive, based on direction.
-        // Also scale the drive motors for direction.
-        switch (direction)
-        {
-            case ROBOT_FORWARD:
-            {
-                leftEncVal = -(m_pLeftDriveMotors->GetEncoderValue());
-                rightEncVal = m_pRightDriveMotors->GetEncoderValue();
-                leftDriveScale = LEFT_DRIVE_FORWARD_SCALAR;
-                rightDriveScale = RIGHT_DRIVE_FORWARD_SCALAR;
-                break;
-            }
-            case ROBOT_REVERSE:
-            {
-                leftEncVal = m_pLeftDriveMotors->GetEncoderValue();
-                rightEncVal = -(m_pRightDriveMotors->GetEncoderValue());
-                leftDriveScale = LEFT_DRIVE_REVERSE_SCALAR;
-                rightDriveScale = RIGHT_DRIVE_REVERSE_SCALAR;
-                break;
-            }
-            default:
-            {
-                leftDriveSpeed = 0.0;
-                rightDriveSpeed = 0.0;
-                break;
-            }
-        }
-    
-        // If left is ahead of right, slow down left, increase right
-        if (leftEncVal > rightEncVal)
+        case ROBOT_REVERSE:
         {
-            leftDriveSpeed -= YtaRobotAutonomous::ENCODER_COMPENSATE_SPEED;
-            rightDriveSpeed += YtaRobotAutonomous::ENCODER_COMPENSATE_SPEED;
-        }
-        // If right is head of left, slow down right, increase left
-        else if (leftEncVal < rightEncVal)
-        {
-            leftDriveSpeed += YtaRobotAutonomous::ENCODER_COMPENSATE_SPEED;
-            rightDriveSpeed -= YtaRobotAutonomous::ENCODER_COMPENSATE_SPEED;
+            leftEncVal = leftEncoder - m_EncoderDriveLeftStart;
+            rightEncVal = -(rightEncoder - m_EncoderDriveRightStart);
+            leftDriveScale = LEFT_DRIVE_REVERSE_SCALAR;
+            rightDriveScale = RIGHT_DRIVE_REVERSE_SCALAR;
+            break;
         }
-        else
+        default:
         {
+            // Not a drive direction, nothing to do
+            return true;
         }
-        
-        // Motors on
-        m_pLeftDriveMotors->Set(leftDriveSpeed * leftDriveScale);
-        m_pRightDriveMotors->Set(rightDriveSpeed * rightDriveScale);
-        
-        // Send stats back to the smart dashboard
-        if (RobotUtils::DEBUG_PRINTS)
+    }
+    
+    // New move, work out the whole profile up front
+    if (bFirstTick)
+    {
+        m_EncoderDriveSetpointIndex = 0U;
+        if (!m_EncoderDriveProfile.Generate(distance,
+                                            speed * YtaRobotAutonomous::ENCODER_DRIVE_MAX_VELOCITY_IPS,
+                                            YtaRobotAutonomous::ENCODER_DRIVE_MAX_ACCELERATION_IPS2,
+                                            YtaRobotAutonomous::ENCODER_DRIVE_PERIOD_S))
         {
-            SmartDashboard::PutNumber("Enc. L: ", leftEncVal);
-            SmartDashboard::PutNumber("Enc. R: ", rightEncVal);
-            SmartDashboard::PutNumber("Enc Diff: ", std::abs(leftEncVal - rightEncVal));
+            RobotUtils::DisplayMessage("Encoder drive could not profile the move.");
+            return true;
         }
+    }
+    
+    const double leftInches = leftEncVal / ENCODER_TICKS_PER_INCH;
+    const double rightInches = rightEncVal / ENCODER_TICKS_PER_INCH;
+    const double averageInches = (leftInches + rightInches) / 2.0;
+    
+    // Step through the table, holding at the end while the robot settles
+    const TrapezoidalProfile::Setpoint & rSetpoint = m_EncoderDriveProfile.GetSetpoint(m_EncoderDriveSetpointIndex);
+    const bool bProfileFinished = m_EncoderDriveProfile.IsFinished(m_EncoderDriveSetpointIndex);
+    if (!bProfileFinished)
+    {
+        m_EncoderDriveSetpointIndex++;
+    }
+    
+    // Check if the destination has been reached
+    if (bProfileFinished && (std::abs(distance - averageInches) <= YtaRobotAutonomous::ENCODER_DRIVE_TOLERANCE_IN))
+    {
+        return true;
+    }
+    
+    // Feed forward does most of the work, the gains clean up what it misses
+    const double feedForward = (YtaRobotAutonomous::ENCODER_DRIVE_KV * rSetpoint.m_Velocity)
+                             + (YtaRobotAutonomous::ENCODER_DRIVE_KA * rSetpoint.m_Acceleration);
+    
+    // If left is ahead of right, slow down left and speed up right (and vice versa)
+    const double headingCorrection = YtaRobotAutonomous::ENCODER_DRIVE_HEADING_KP * (leftInches - rightInches);
     
-    } while ( (leftEncVal < GetEncoderRotationsFromInches(distance, DRIVE_WHEEL_DIAMETER_INCHES)) 
-           && (rightEncVal < GetEncoderRotationsFromInches(distance, DRIVE_WHEEL_DIAMETER_INCHES))
-           && (m_pSafetyTimer->Get() <= YtaRobotAutonomous::ENCODER_DRIVE_MAX_DELAY_S) );
+    double leftDriveSpeed = feedForward + (YtaRobotAutonomous::ENCODER_DRIVE_KP * (rSetpoint.m_Position - leftInches)) - headingCorrection;
+    double rightDriveSpeed = feedForward + (YtaRobotAutonomous::ENCODER_DRIVE_KP * (rSetpoint.m_Position - rightInches)) + headingCorrection;
+    leftDriveSpeed = RobotUtils::Limit(leftDriveSpeed, DRIVE_MOTOR_UPPER_LIMIT, DRIVE_MOTOR_LOWER_LIMIT);
+    rightDriveSpeed = RobotUtils::Limit(rightDriveSpeed, DRIVE_MOTOR_UPPER_LIMIT, DRIVE_MOTOR_LOWER_LIMIT);
     
-    // Motors back off    
-    m_pLeftDriveMotors->Set(OFF);
-    m_pRightDriveMotors->Set(OFF);
+    // Motors on
+    m_pLeftDriveMotors->Set(leftDriveSpeed * leftDriveScale);
+    m_pRightDriveMotors->Set(rightDriveSpeed * rightDriveScale);
     
-    AutonomousBackDrive(direction);
+    // Send stats back to the smart dashboard
+    RobotTelemetry::Set(RobotTelemetry::LEFT_ENCODER, leftEncVal);
+    RobotTelemetry::Set(RobotTelemetry::RIGHT_ENCODER, rightEncVal);
+    RobotTelemetry::Set(RobotTelemetry::ENCODER_DIFFERENCE, std::abs(leftEncVal - rightEncVal));
+    RobotTelemetry::Set(RobotTelemetry::ENCODER_DRIVE_SETPOINT, rSetpoint.m_Position);
     
-    // Stop and reset the safety timer
-    m_pSafetyTimer->Stop();
-    m_pSafetyTimer->Reset();
+    return false;
 }
@@ -23,48 +23,15 @@
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::AutonomousGyroLeftTurn
 ///
-/// Turns the robot left based on gyro readings.
+/// Turns the robot left based on gyro readings.  It is called
+/// once per loop by the autonomous step engine and returns true
+/// once the robot has settled on the destination angle.
 ///
 ////////////////////////////////////////////////////////////////
-bool YtaRobot::AutonomousGyroLeftTurn(double destAngle, double turnSpeed)
+bool YtaRobot::AutonomousGyroLeftTurn(double destAngle, double turnSpeed, bool bFirstTick)
 {
     // 20xx LEFT TURNS DECREASE GYRO ANGLE
-    // Left turn is left motors back, right motors forward
-    
-    // Left turns are right motors forward, left motors reverse
-    m_pLeftDriveMotors->Set(turnSpeed * LEFT_DRIVE_REVERSE_SCALAR);
-    m_pRightDriveMotors->Set(turnSpeed * RIGHT_DRIVE_FORWARD_SCALAR);
-    
-    m_pSafetyTimer->Reset();
-    m_pSafetyTimer->Start();
-    
-    // Angle will be decreasing.  Assumption: Robot orientation is 0 -> 90 -> 180 -> 270 -> 360.
-    // @todo: This needs improvements for figuring out fastest way to turn and crossing the 0/360 boundary.
-    while ((GetGyroValue(BNO055) > destAngle) && (m_pSafetyTimer->Get() <= SAFETY_TIMER_MAX_VALUE))
-    {
-        if (!m_pDriverStation->IsAutonomous())
-        {
-            break;
-        }
-        
-        SmartDashboard::PutNumber("Gyro angle", GetGyroValue(BNO055));
-    }
-    
-    m_pLeftDriveMotors->Set(OFF);
-    m_pRightDriveMotors->Set(OFF);
-    
-    m_pSafetyTimer->Stop();
-    if (m_pSafetyTimer->Get() > SAFETY_TIMER_MAX_VALUE)
-    {
-        m_pSafetyTimer->Reset();
-        return false;
-    }
-    m_pSafetyTimer->Reset();
-    
-    // Counteract coast
-    AutonomousBackDriveTurn(ROBOT_LEFT);
-    
-    return true;
+    return AutonomousGyroTurn(destAngle, turnSpeed, bFirstTick);
 }
 
 
@@ -72,46 +39,43 @@ bool YtaRobot::AutonomousGyroLeftTurn(double destAngle, double turnSpeed)
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::AutonomousGyroRightTurn
 ///
-/// Turns the robot right based on gyro readings.
+/// Turns the robot right based on gyro readings.  It is called
+/// once per loop by the autonomous step engine and returns true
+/// once the robot has settled on the destination angle.
 ///
 ////////////////////////////////////////////////////////////////
-bool YtaRobot::AutonomousGyroRightTurn(double destAngle, double turnSpeed)
+bool YtaRobot::AutonomousGyroRightTurn(double destAngle, double turnSpeed, bool bFirstTick)
 {
     // 20xx RIGHT TURNS INCREASE GYRO ANGLE
-    // Right turn is left motors forward, right motors back
-    
-    // Right turns are left motors forward, right motors reverse
-    m_pLeftDriveMotors->Set(turnSpeed * LEFT_DRIVE_FORWARD_SCALAR);
-    m_pRightDriveMotors->Set(turnSpeed * RIGHT_DRIVE_REVERSE_SCALAR);
-    
-    m_pSafetyTimer->Reset();
-    m_pSafetyTimer->Start();
-    
-    // Angle will be increasing.  Assumption: Robot orientation is 0 -> 90 -> 180 -> 270 -> 360.
-    // @todo: This needs improvements for figuring out fastest way to turn and crossing the 0/360 boundary.
-    while ((GetGyroValue(BNO055) < destAngle) && (m_pSafetyTimer->Get() <= SAFETY_TIMER_MAX_VALUE))
+    return AutonomousGyroTurn(destAngle, turnSpeed, bFirstTick);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::AutonomousGyroTurn
+///
+/// Turns the robot to an angle with the heading controller.
+/// The controller always takes the shorter way around, so the
+/// left/right of the step only documents the expected turn.
+/// It slows down on its own approaching the angle, which means
+/// no back drive is needed to stop the turn.
+///
+////////////////////////////////////////////////////////////////
+bool YtaRobot::AutonomousGyroTurn(double destAngle, double turnSpeed, bool bFirstTick)
+{
+    if (bFirstTick)
     {
-        if (!m_pDriverStation->IsAutonomous())
-        {
-            break;
-        }
-        
-        SmartDashboard::PutNumber("Gyro angle", GetGyroValue(BNO055));
+        m_HeadingController.Start(destAngle, turnSpeed);
     }
     
-    m_pLeftDriveMotors->Set(OFF);
-    m_pRightDriveMotors->Set(OFF);
-    
-    m_pSafetyTimer->Stop();
-    if (m_pSafetyTimer->Get() > SAFETY_TIMER_MAX_VALUE)
+    const double turnOutput = m_HeadingController.Update(GetGyroValue(BNO055));
+    if (m_HeadingController.IsSettled())
     {
-        m_pSafetyTimer->Reset();
-        return false;
+        return true;
     }
-    m_pSafetyTimer->Reset();
     
-    // Counteract coast
-    AutonomousBackDriveTurn(ROBOT_RIGHT);
+    TurnInPlace(turnOutput);
     
-    return true;
+    return false;
 }
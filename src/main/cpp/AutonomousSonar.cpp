@@ -12,10 +12,10 @@
 // <none>
 
 // C INCLUDES
-// (none)
+#include "frc/RobotController.h"        // for GetFPGATime()
 
 // C++ INCLUDES
-#include "RobotI2c.hpp"                 // for GetSonarData()
+#include "RobotI2c.hpp"                 // for GetSonarSample()
 #include "YtaRobot.hpp"                 // for robot class declaration
 #include "YtaRobotAutonomous.hpp"       // for autonomous declarations
 
@@ -25,11 +25,32 @@
 /// @method YtaRobot::AutonomousSonarDrive
 ///
 /// Autonomous method to drive the robot controlled by the
-/// sonar sensors.
+/// sonar sensors.  The distances have already been filtered by
+/// the I2C thread, and every decision this pass is made from the
+/// same copy of them.  If the RIOduino stops sending sonar data
+/// the robot stops and waits rather than steering on old data.
 ///
 ////////////////////////////////////////////////////////////////
 bool YtaRobot::AutonomousSonarDrive(RobotDirection direction, SonarDriveState driveState, uint32_t destLateralDist, uint32_t destSideDist)
-{    
+{
+    // Take one consistent copy of the filtered sonar data for this pass
+    RobotI2c::SonarSample sonarSample;
+    if (!RobotI2c::GetSonarSample(sonarSample))
+    {
+        // No sonar data yet, try again next loop
+        return false;
+    }
+    
+    if ((RobotController::GetFPGATime() - sonarSample.m_TimestampUs) > YtaRobotAutonomous::SONAR_MAX_SAMPLE_AGE_US)
+    {
+        // The data is too old to steer with, hold still until it's fresh
+        m_pLeftDriveMotors->Set(OFF);
+        m_pRightDriveMotors->Set(OFF);
+        return false;
+    }
+    
+    const SonarI2cData & sonarData = sonarSample.m_Data;
+    
     // Set directions based on drive state
     uint32_t sideDirection = driveState & YtaRobotAutonomous::SONAR_DRIVE_STATE_SIDE_MASK;
     uint32_t lateralDirection = driveState & YtaRobotAutonomous::SONAR_DRIVE_STATE_LATERAL_MASK;
@@ -44,20 +65,20 @@ bool YtaRobot::AutonomousSonarDrive(RobotDirection direction, SonarDriveState dr
     {
         case FORWARD_GUIDE:
         {
-            destGuideSensorA = RobotI2c::GetSonarData()->m_FrontDistances.m_SonarA;
-            destGuideSensorB = RobotI2c::GetSonarData()->m_FrontDistances.m_SonarB;
+            destGuideSensorA = sonarData.m_FrontDistances.m_SonarA;
+            destGuideSensorB = sonarData.m_FrontDistances.m_SonarB;
             switch (sideDirection)
             {
                 case LEFT_GUIDE:
                 {
-                    frontGuideSensor = RobotI2c::GetSonarData()->m_LeftDistances.m_SonarB;
-                    backGuideSensor = RobotI2c::GetSonarData()->m_LeftDistances.m_SonarA;
+                    frontGuideSensor = sonarData.m_LeftDistances.m_SonarB;
+                    backGuideSensor = sonarData.m_LeftDistances.m_SonarA;
                     break;
                 }
                 case RIGHT_GUIDE:
                 {
-                    frontGuideSensor = RobotI2c::GetSonarData()->m_RightDistances.m_SonarA;
-                    backGuideSensor = RobotI2c::GetSonarData()->m_RightDistances.m_SonarB;
+                    frontGuideSensor = sonarData.m_RightDistances.m_SonarA;
+                    backGuideSensor = sonarData.m_RightDistances.m_SonarB;
                     break;
                 }
                 default:
@@ -70,20 +91,20 @@ bool YtaRobot::AutonomousSonarDrive(RobotDirection direction, SonarDriveState dr
         }
         case REVERSE_GUIDE:
         {
-            destGuideSensorA = RobotI2c::GetSonarData()->m_BackDistances.m_SonarA;
-            destGuideSensorB = RobotI2c::GetSonarData()->m_BackDistances.m_SonarB;
+            destGuideSensorA = sonarData.m_BackDistances.m_SonarA;
+            destGuideSensorB = sonarData.m_BackDistances.m_SonarB;
             switch (sideDirection)
             {
                 case LEFT_GUIDE:
                 {
-                    frontGuideSensor = RobotI2c::GetSonarData()->m_LeftDistances.m_SonarA;
-                    backGuideSensor = RobotI2c::GetSonarData()->m_LeftDistances.m_SonarB;
+                    frontGuideSensor = sonarData.m_LeftDistances.m_SonarA;
+                    backGuideSensor = sonarData.m_LeftDistances.m_SonarB;
                     break;
                 }
                 case RIGHT_GUIDE:
                 {
-                    frontGuideSensor = RobotI2c::GetSonarData()->m_RightDistances.m_SonarB;
-                    backGuideSensor = RobotI2c::GetSonarData()->m_RightDistances.m_SonarA;
+                    frontGuideSensor = sonarData.m_RightDistances.m_SonarB;
+                    backGuideSensor = sonarData.m_RightDistances.m_SonarA;
                     break;
                 }
                 default:
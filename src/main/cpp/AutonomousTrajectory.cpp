@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   AutonomousTrajectory.cpp
+/// @author David Stalter
+///
+/// @details
+/// Implementation of autonomous trajectory following routines.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <string>                       // for std::string
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "RobotUtils.hpp"               // for DisplayMessage(), Limit()
+#include "YtaRobot.hpp"                 // for robot class declaration
+#include "YtaRobotAutonomous.hpp"       // for autonomous declarations
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::LoadTrajectories
+///
+/// Reads every autonomous path from the deploy directory.  A
+/// path that's missing or out of date is left empty, and the
+/// step that uses it ends right away.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::LoadTrajectories()
+{
+    static_assert((sizeof(YtaRobotAutonomous::TRAJECTORY_FILE_NAMES) / sizeof(YtaRobotAutonomous::TRAJECTORY_FILE_NAMES[0])) == NUM_TRAJECTORIES,
+                  "Every trajectory needs a file name");
+
+    for (unsigned i = 0U; i < NUM_TRAJECTORIES; i++)
+    {
+        const std::string fileName = std::string(YtaRobotAutonomous::TRAJECTORY_DIRECTORY) + YtaRobotAutonomous::TRAJECTORY_FILE_NAMES[i];
+        if (m_Trajectories[i].Load(fileName.c_str(), YtaRobotAutonomous::ENCODER_DRIVE_PERIOD_S))
+        {
+            RobotUtils::DisplayFormattedMessage("Loaded trajectory %s, %u points.\n", fileName.c_str(), m_Trajectories[i].GetNumPoints());
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::AutonomousTrajectoryDrive
+///
+/// Autonomous method to follow a precomputed trajectory.  It is
+/// called once per loop by the autonomous step engine and moves
+/// one point along the trajectory each call.  The Ramsete
+/// controller compares the odometry pose with the point and
+/// gives a velocity and turn rate, which are split between the
+/// sides of the drive and turned into motor outputs with the
+/// same feed forward the encoder drive uses.  Returns true once
+/// the end of the trajectory is reached.  The trajectories are
+/// from the autonomous start pose, which is where odometry is
+/// reset to when autonomous starts.
+///
+////////////////////////////////////////////////////////////////
+bool YtaRobot::AutonomousTrajectoryDrive(unsigned trajectory, bool bFirstTick)
+{
+    if ((trajectory >= NUM_TRAJECTORIES) || !m_Trajectories[trajectory].IsLoaded())
+    {
+        RobotUtils::DisplayMessage("Trajectory drive has no trajectory to follow.");
+        return true;
+    }
+
+    const Trajectory & rTrajectory = m_Trajectories[trajectory];
+    if (bFirstTick)
+    {
+        m_TrajectoryPointIndex = 0U;
+    }
+
+    // The last point is at rest, so there's nothing left to do once it's reached
+    if (rTrajectory.IsFinished(m_TrajectoryPointIndex))
+    {
+        return true;
+    }
+    const Point & rPoint = rTrajectory.GetPoint(m_TrajectoryPointIndex);
+    m_TrajectoryPointIndex++;
+
+    double velocity = 0.0;
+    double turnRate = 0.0;
+    m_RamseteController.Calculate(m_Odometry.GetPose(), rPoint, velocity, turnRate);
+
+    // Turning left (counter clockwise) slows the left side and speeds up the right
+    const double halfTrackWidth = YtaRobotAutonomous::DRIVE_TRACK_WIDTH_INCHES / 2.0;
+    const double leftVelocity = velocity - (turnRate * halfTrackWidth);
+    const double rightVelocity = velocity + (turnRate * halfTrackWidth);
+    const double accelerationFeedForward = YtaRobotAutonomous::ENCODER_DRIVE_KA * rPoint.m_Acceleration;
+
+    double leftDriveSpeed = (YtaRobotAutonomous::ENCODER_DRIVE_KV * leftVelocity) + accelerationFeedForward;
+    double rightDriveSpeed = (YtaRobotAutonomous::ENCODER_DRIVE_KV * rightVelocity) + accelerationFeedForward;
+    leftDriveSpeed = RobotUtils::Limit(leftDriveSpeed, DRIVE_MOTOR_UPPER_LIMIT, DRIVE_MOTOR_LOWER_LIMIT);
+    rightDriveSpeed = RobotUtils::Limit(rightDriveSpeed, DRIVE_MOTOR_UPPER_LIMIT, DRIVE_MOTOR_LOWER_LIMIT);
+
+    // Motors on
+    m_pLeftDriveMotors->Set(leftDriveSpeed * LEFT_DRIVE_FORWARD_SCALAR);
+    m_pRightDriveMotors->Set(rightDriveSpeed * RIGHT_DRIVE_FORWARD_SCALAR);
+
+    return false;
+}
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   Bno055.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for talking to a BNO055 directly from the
+/// roboRIO.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <chrono>                       // for std::chrono
+#include <thread>                       // for std::this_thread
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "Bno055.hpp"                   // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Bno055::Bno055
+///
+/// Constructor.
+///
+////////////////////////////////////////////////////////////////
+Bno055::Bno055(I2C::Port port, int address) :
+    m_I2c(port, address),
+    m_CenterHeading(0),
+    m_bReadNewCenter(false),
+    m_bInitialized(false)
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Bno055::WriteRegister
+///
+/// Writes one register.  The WPILib I2C calls return true when
+/// the transfer was aborted, so that's flipped here.
+///
+////////////////////////////////////////////////////////////////
+bool Bno055::WriteRegister(Register reg, uint8_t value)
+{
+    return !m_I2c.Write(reg, value);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Bno055::SetOperationMode
+///
+/// Changes the operating mode.  The sensor ignores the bus for
+/// a short time after a mode change.
+///
+////////////////////////////////////////////////////////////////
+bool Bno055::SetOperationMode(uint8_t mode)
+{
+    if (!WriteRegister(OPERATION_MODE_REGISTER, mode))
+    {
+        return false;
+    }
+
+    const unsigned delayMs = (mode == CONFIG_MODE) ? TO_CONFIG_MODE_TIME_MS : FROM_CONFIG_MODE_TIME_MS;
+    std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+    return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Bno055::Initialize
+///
+/// Checks the chip ID and configures the sensor the same way
+/// the Adafruit library on the RIOduino did: normal power, the
+/// external crystal, default units and NDOF fusion.  The chip
+/// may still be booting, so the ID is given one retry.
+///
+////////////////////////////////////////////////////////////////
+bool Bno055::Initialize()
+{
+    m_bInitialized = false;
+
+    uint8_t chipId = 0U;
+    if (m_I2c.Read(CHIP_ID_REGISTER, 1, &chipId) || (chipId != CHIP_ID_VALUE))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(BOOT_TIME_MS));
+        if (m_I2c.Read(CHIP_ID_REGISTER, 1, &chipId) || (chipId != CHIP_ID_VALUE))
+        {
+            return false;
+        }
+    }
+
+    // Registers can only be changed in config mode
+    if (!SetOperationMode(CONFIG_MODE) ||
+        !WriteRegister(PAGE_ID_REGISTER, 0U) ||
+        !WriteRegister(POWER_MODE_REGISTER, NORMAL_POWER_MODE) ||
+        !WriteRegister(UNIT_SELECT_REGISTER, DEFAULT_UNITS) ||
+        !WriteRegister(SYSTEM_TRIGGER_REGISTER, EXTERNAL_CRYSTAL) ||
+        !SetOperationMode(NDOF_MODE))
+    {
+        return false;
+    }
+
+    m_bInitialized = true;
+    return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Bno055::ReadAngles
+///
+/// Reads heading, roll and pitch in one burst.  The heading is
+/// zero to 360 degrees from the sensor, and is turned into -180
+/// to 180 degrees from the center point, like the RIOduino did.
+///
+////////////////////////////////////////////////////////////////
+bool Bno055::ReadAngles(GyroI2cData & rAngles)
+{
+    uint8_t eulerData[EULER_DATA_BYTES];
+    if (!m_bInitialized || m_I2c.Read(EULER_HEADING_LSB, EULER_DATA_BYTES, &eulerData[0]))
+    {
+        return false;
+    }
+
+    const int16_t heading = static_cast<int16_t>(eulerData[0] | (eulerData[1] << 8));
+    const int16_t roll = static_cast<int16_t>(eulerData[2] | (eulerData[3] << 8));
+    const int16_t pitch = static_cast<int16_t>(eulerData[4] | (eulerData[5] << 8));
+
+    if (m_bReadNewCenter)
+    {
+        m_CenterHeading = heading;
+        m_bReadNewCenter = false;
+    }
+
+    int relativeHeading = heading - m_CenterHeading;
+    if (relativeHeading < 0)
+    {
+        relativeHeading += FULL_CIRCLE;
+    }
+    if (relativeHeading > HALF_CIRCLE)
+    {
+        relativeHeading -= FULL_CIRCLE;
+    }
+
+    rAngles.m_xAngle = static_cast<int16_t>(relativeHeading);
+    rAngles.m_yAngle = roll;
+    rAngles.m_zAngle = pitch;
+    return true;
+}
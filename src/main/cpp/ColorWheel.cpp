@@ -0,0 +1,321 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   ColorWheel.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for classifying control panel colors and
+/// controlling the color wheel spinner.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "ColorWheel.hpp"               // for class declaration
+
+// Where each color sits on the panel (red, green, blue, yellow, then repeats)
+static const unsigned PANEL_POSITIONS[ColorWheel::NUM_TARGET_COLORS] = { 2U, 1U, 0U, 3U };
+static const ColorWheel::WheelColor PANEL_ORDER[ColorWheel::NUM_TARGET_COLORS] = { ColorWheel::RED, ColorWheel::GREEN, ColorWheel::BLUE, ColorWheel::YELLOW };
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::ColorWheel
+///
+/// Constructor.  Fills in the classification table.  The
+/// sensor colors are normalized, so blue is whatever red and
+/// green leave over and only two channels need to be binned.
+/// Each bin gets the target nearest to its center, or unknown
+/// if none are close enough.
+///
+////////////////////////////////////////////////////////////////
+ColorWheel::ColorWheel() :
+    m_ClassificationTable(),
+    m_Mode(IDLE),
+    m_StableColor(UNKNOWN),
+    m_CandidateColor(UNKNOWN),
+    m_SensorTargetColor(UNKNOWN),
+    m_CandidateReadCount(0U),
+    m_TransitionCount(0U),
+    m_LoopCount(0U)
+{
+    const double maxDistanceSquared = MAX_MATCH_DISTANCE * MAX_MATCH_DISTANCE;
+
+    for (unsigned redBin = 0U; redBin < TABLE_BINS; redBin++)
+    {
+        for (unsigned greenBin = 0U; greenBin < TABLE_BINS; greenBin++)
+        {
+            const double red = (redBin + 0.5) / TABLE_BINS;
+            const double green = (greenBin + 0.5) / TABLE_BINS;
+            const double blue = 1.0 - red - green;
+
+            uint8_t nearestColor = UNKNOWN;
+            double nearestDistanceSquared = maxDistanceSquared;
+            for (unsigned i = 0U; i < NUM_TARGET_COLORS; i++)
+            {
+                const frc::Color & rTarget = TARGET_COLORS[i];
+                const double targetSum = rTarget.red + rTarget.green + rTarget.blue;
+                const double redError = red - (rTarget.red / targetSum);
+                const double greenError = green - (rTarget.green / targetSum);
+                const double blueError = blue - (rTarget.blue / targetSum);
+                const double distanceSquared = (redError * redError) + (greenError * greenError) + (blueError * blueError);
+
+                if (distanceSquared < nearestDistanceSquared)
+                {
+                    nearestColor = static_cast<uint8_t>(i);
+                    nearestDistanceSquared = distanceSquared;
+                }
+            }
+
+            // Bins past red + green = 1 can't be read, and come out unknown
+            m_ClassificationTable[redBin][greenBin] = (blue < 0.0) ? static_cast<uint8_t>(UNKNOWN) : nearestColor;
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::Classify
+///
+/// Looks up the target color for a sensor reading.
+///
+////////////////////////////////////////////////////////////////
+ColorWheel::WheelColor ColorWheel::Classify(const frc::Color & rColor) const
+{
+    const double sum = rColor.red + rColor.green + rColor.blue;
+    if (sum <= 0.0)
+    {
+        return UNKNOWN;
+    }
+
+    unsigned redBin = static_cast<unsigned>((rColor.red / sum) * TABLE_BINS);
+    unsigned greenBin = static_cast<unsigned>((rColor.green / sum) * TABLE_BINS);
+    redBin = (redBin < TABLE_BINS) ? redBin : (TABLE_BINS - 1U);
+    greenBin = (greenBin < TABLE_BINS) ? greenBin : (TABLE_BINS - 1U);
+
+    return static_cast<WheelColor>(m_ClassificationTable[redBin][greenBin]);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::ParseGameData
+///
+/// Turns the game specific message into the requested color.
+/// The message is empty until stage three is reached.
+///
+////////////////////////////////////////////////////////////////
+ColorWheel::WheelColor ColorWheel::ParseGameData(const std::string & rGameData)
+{
+    if (rGameData.empty())
+    {
+        return UNKNOWN;
+    }
+
+    switch (rGameData[0])
+    {
+        case GAME_DATA_BLUE:
+        {
+            return BLUE;
+        }
+        case GAME_DATA_GREEN:
+        {
+            return GREEN;
+        }
+        case GAME_DATA_RED:
+        {
+            return RED;
+        }
+        case GAME_DATA_YELLOW:
+        {
+            return YELLOW;
+        }
+        default:
+        {
+            return UNKNOWN;
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::IsAdjacent
+///
+/// Returns true if two colors are next to each other on the
+/// panel, in either direction.
+///
+////////////////////////////////////////////////////////////////
+bool ColorWheel::IsAdjacent(WheelColor first, WheelColor second)
+{
+    if ((first >= NUM_TARGET_COLORS) || (second >= NUM_TARGET_COLORS))
+    {
+        return false;
+    }
+
+    const unsigned difference = (PANEL_POSITIONS[first] + NUM_TARGET_COLORS - PANEL_POSITIONS[second]) % NUM_TARGET_COLORS;
+    return ((difference == 1U) || (difference == (NUM_TARGET_COLORS - 1U)));
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::StartRotationControl
+///
+/// Begins spinning the panel and counting transitions.
+///
+////////////////////////////////////////////////////////////////
+void ColorWheel::StartRotationControl()
+{
+    m_Mode = ROTATION_CONTROL;
+    m_TransitionCount = 0U;
+    m_LoopCount = 0U;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::StartPositionControl
+///
+/// Begins turning the panel to the requested color.  The field
+/// sensor is two segments (a quarter turn) away from ours, so
+/// the color to stop on is the one two places away on the
+/// panel, which is the same either way the panel turns.
+///
+////////////////////////////////////////////////////////////////
+void ColorWheel::StartPositionControl(WheelColor fieldTargetColor)
+{
+    if (fieldTargetColor >= NUM_TARGET_COLORS)
+    {
+        Stop();
+        return;
+    }
+
+    m_SensorTargetColor = PANEL_ORDER[(PANEL_POSITIONS[fieldTargetColor] + 2U) % NUM_TARGET_COLORS];
+    m_Mode = POSITION_CONTROL;
+    m_LoopCount = 0U;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::Stop
+///
+/// Stops the spinner.
+///
+////////////////////////////////////////////////////////////////
+void ColorWheel::Stop()
+{
+    m_Mode = IDLE;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::TrackColor
+///
+/// Debounces the sensor colors.  A new color settles once it
+/// has been read enough times in a row.  If it's next to the
+/// last settled color the panel moved one segment.  A color
+/// that isn't next to it is a misread or a segment that went by
+/// too fast, and it is taken without counting, which can only
+/// make rotation control turn a little more.
+///
+////////////////////////////////////////////////////////////////
+void ColorWheel::TrackColor(WheelColor detectedColor)
+{
+    if ((detectedColor == UNKNOWN) || (detectedColor == m_StableColor))
+    {
+        m_CandidateReadCount = 0U;
+        return;
+    }
+
+    if (detectedColor != m_CandidateColor)
+    {
+        m_CandidateColor = detectedColor;
+        m_CandidateReadCount = 0U;
+    }
+
+    m_CandidateReadCount++;
+    if (m_CandidateReadCount < STABLE_COLOR_READS)
+    {
+        return;
+    }
+
+    if (IsAdjacent(m_StableColor, detectedColor))
+    {
+        m_TransitionCount++;
+    }
+
+    m_StableColor = detectedColor;
+    m_CandidateReadCount = 0U;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ColorWheel::Update
+///
+/// Tracks the panel color and returns the spinner output for
+/// the mode that's running.  Once the goal is reached (or it
+/// has run too long) it goes back to idle.
+///
+////////////////////////////////////////////////////////////////
+double ColorWheel::Update(WheelColor detectedColor)
+{
+    TrackColor(detectedColor);
+
+    if (m_Mode == IDLE)
+    {
+        return 0.0;
+    }
+
+    m_LoopCount++;
+    if (m_LoopCount > MAX_CONTROL_LOOPS)
+    {
+        Stop();
+        return 0.0;
+    }
+
+    double output = 0.0;
+    switch (m_Mode)
+    {
+        case ROTATION_CONTROL:
+        {
+            if (m_TransitionCount >= ROTATION_CONTROL_TRANSITIONS)
+            {
+                Stop();
+            }
+            else
+            {
+                output = ROTATION_CONTROL_SPEED;
+            }
+            break;
+        }
+        case POSITION_CONTROL:
+        {
+            if (m_StableColor == m_SensorTargetColor)
+            {
+                Stop();
+            }
+            else
+            {
+                output = POSITION_CONTROL_SPEED;
+            }
+            break;
+        }
+        default:
+        {
+            Stop();
+            break;
+        }
+    }
+
+    return output;
+}
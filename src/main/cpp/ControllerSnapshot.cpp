@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   ControllerSnapshot.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for capturing all of a controller's inputs
+/// once per robot loop.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+#include "frc/DriverStation.h"          // for reading all of a stick's inputs
+
+// C++ INCLUDES
+#include "ControllerSnapshot.hpp"       // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ControllerSnapshot::ControllerSnapshot
+///
+/// Constructor.  Starts out as if nothing is pressed.
+///
+////////////////////////////////////////////////////////////////
+ControllerSnapshot::ControllerSnapshot() :
+    m_Buttons(0U),
+    m_PressedButtons(0U),
+    m_ReleasedButtons(0U),
+    m_Axes(),
+    m_Pov(-1),
+    m_X(0.0),
+    m_Y(0.0)
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ControllerSnapshot::Update
+///
+/// Reads everything from a controller.  The buttons all come
+/// from the driver station in one call as a bitmask, and the
+/// edges come from comparing it against the last one.
+///
+////////////////////////////////////////////////////////////////
+void ControllerSnapshot::Update(GenericHID * pJoystick)
+{
+    // The joysticks may not be assigned yet
+    if (pJoystick == nullptr)
+    {
+        return;
+    }
+
+    DriverStation & rDriverStation = DriverStation::GetInstance();
+    const int port = pJoystick->GetPort();
+
+    const uint32_t buttons = static_cast<uint32_t>(rDriverStation.GetStickButtons(port));
+    m_PressedButtons = buttons & ~m_Buttons;
+    m_ReleasedButtons = ~buttons & m_Buttons;
+    m_Buttons = buttons;
+
+    int axisCount = rDriverStation.GetStickAxisCount(port);
+    if (axisCount > static_cast<int>(MAX_AXES))
+    {
+        axisCount = MAX_AXES;
+    }
+    for (int i = 0; i < static_cast<int>(MAX_AXES); i++)
+    {
+        m_Axes[i] = (i < axisCount) ? rDriverStation.GetStickAxis(port, i) : 0.0;
+    }
+
+    m_Pov = rDriverStation.GetStickPOV(port, 0);
+
+    // These are virtual, each controller type maps them its own way
+    m_X = pJoystick->GetX();
+    m_Y = pJoystick->GetY();
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method ControllerSnapshot::FillLogData
+///
+/// Copies the inputs into the form the match log stores them.
+/// Only the first few axes are kept, which covers every axis
+/// the robot code uses.
+///
+////////////////////////////////////////////////////////////////
+void ControllerSnapshot::FillLogData(RobotLogRecords::ControllerData & rData) const
+{
+    rData.m_Buttons = m_Buttons;
+    rData.m_Pov = static_cast<int16_t>(m_Pov);
+    rData.m_Reserved = 0;
+    rData.m_X = static_cast<float>(m_X);
+    rData.m_Y = static_cast<float>(m_Y);
+
+    for (unsigned i = 0U; i < RobotLogRecords::LOGGED_AXES; i++)
+    {
+        rData.m_Axes[i] = static_cast<float>(m_Axes[i]);
+    }
+}
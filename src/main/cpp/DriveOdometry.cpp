@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   DriveOdometry.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for tracking where the robot is on the field.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                        // for trig functions
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "DriveOdometry.hpp"            // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::DriveOdometry
+///
+/// Constructor.  Starts at the origin.
+///
+////////////////////////////////////////////////////////////////
+DriveOdometry::DriveOdometry() :
+    m_Pose(),
+    m_LastLeftInches(0.0),
+    m_LastRightInches(0.0),
+    m_LastGyroHeading(0.0),
+    m_HeadingOffset(0.0),
+    m_History(),
+    m_HistoryCount(0U),
+    m_NextHistoryEntry(0U)
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::WrapAngle
+///
+/// Wraps an angle in radians to (-pi, pi].
+///
+////////////////////////////////////////////////////////////////
+double DriveOdometry::WrapAngle(double angle)
+{
+    angle = std::remainder(angle, 2.0 * M_PI);
+    if (angle <= -M_PI)
+    {
+        angle += 2.0 * M_PI;
+    }
+    return angle;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::Reset
+///
+/// Puts the robot at a known pose and forgets the history.  The
+/// gyro keeps whatever zero it has, the difference is remembered
+/// as an offset.
+///
+////////////////////////////////////////////////////////////////
+void DriveOdometry::Reset(const Pose & rPose, double leftInches, double rightInches, double gyroHeading, uint64_t timestampUs)
+{
+    m_Pose = rPose;
+    m_Pose.m_Heading = WrapAngle(rPose.m_Heading);
+    m_LastLeftInches = leftInches;
+    m_LastRightInches = rightInches;
+    m_LastGyroHeading = gyroHeading;
+    m_HeadingOffset = m_Pose.m_Heading - gyroHeading;
+
+    m_HistoryCount = 0U;
+    m_NextHistoryEntry = 0U;
+    RecordHistory(timestampUs);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::ResetEncoders
+///
+/// Called when the encoders are tared so the jump in their
+/// values isn't seen as the robot moving.
+///
+////////////////////////////////////////////////////////////////
+void DriveOdometry::ResetEncoders(double leftInches, double rightInches)
+{
+    m_LastLeftInches = leftInches;
+    m_LastRightInches = rightInches;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::Update
+///
+/// Moves the pose by the distance the two sides averaged,
+/// along the heading halfway through the turn.  The gyro is
+/// trusted for heading over the encoder difference since the
+/// wheels slip when turning.  A side that jumps farther than
+/// the robot can drive in one loop (like an encoder being tared
+/// without telling odometry) doesn't move the pose.
+///
+////////////////////////////////////////////////////////////////
+void DriveOdometry::Update(double leftInches, double rightInches, double gyroHeading, uint64_t timestampUs)
+{
+    const double leftChange = leftInches - m_LastLeftInches;
+    const double rightChange = rightInches - m_LastRightInches;
+    double distance = (leftChange + rightChange) / 2.0;
+    if ((std::abs(leftChange) > MAX_ENCODER_CHANGE_INCHES) || (std::abs(rightChange) > MAX_ENCODER_CHANGE_INCHES))
+    {
+        distance = 0.0;
+    }
+
+    const double headingChange = WrapAngle(gyroHeading - m_LastGyroHeading);
+    const double midHeading = m_Pose.m_Heading + (headingChange / 2.0);
+
+    m_Pose.m_X += distance * std::cos(midHeading);
+    m_Pose.m_Y += distance * std::sin(midHeading);
+    m_Pose.m_Heading = WrapAngle(gyroHeading + m_HeadingOffset);
+
+    m_LastLeftInches = leftInches;
+    m_LastRightInches = rightInches;
+    m_LastGyroHeading = gyroHeading;
+
+    RecordHistory(timestampUs);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::RecordHistory
+///
+/// Stores the current pose in the circular history.
+///
+////////////////////////////////////////////////////////////////
+void DriveOdometry::RecordHistory(uint64_t timestampUs)
+{
+    m_History[m_NextHistoryEntry].m_TimestampUs = timestampUs;
+    m_History[m_NextHistoryEntry].m_Pose = m_Pose;
+    m_NextHistoryEntry = (m_NextHistoryEntry + 1U) % HISTORY_SIZE;
+    if (m_HistoryCount < HISTORY_SIZE)
+    {
+        m_HistoryCount++;
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::GetPoseAt
+///
+/// Finds the pose at a time in the history, interpolating
+/// between the two entries around it.  Times newer than the
+/// last update get the current pose.
+///
+////////////////////////////////////////////////////////////////
+bool DriveOdometry::GetPoseAt(uint64_t timestampUs, Pose & rPose) const
+{
+    if (m_HistoryCount == 0U)
+    {
+        return false;
+    }
+
+    // Walk back from the newest entry
+    unsigned newerIndex = (m_NextHistoryEntry + HISTORY_SIZE - 1U) % HISTORY_SIZE;
+    if (timestampUs >= m_History[newerIndex].m_TimestampUs)
+    {
+        rPose = m_History[newerIndex].m_Pose;
+        return true;
+    }
+
+    for (unsigned i = 1U; i < m_HistoryCount; i++)
+    {
+        const unsigned olderIndex = (newerIndex + HISTORY_SIZE - 1U) % HISTORY_SIZE;
+        const HistoryEntry & rOlder = m_History[olderIndex];
+        const HistoryEntry & rNewer = m_History[newerIndex];
+
+        if (timestampUs >= rOlder.m_TimestampUs)
+        {
+            const double span = static_cast<double>(rNewer.m_TimestampUs - rOlder.m_TimestampUs);
+            const double fraction = (span > 0.0) ? (static_cast<double>(timestampUs - rOlder.m_TimestampUs) / span) : 0.0;
+
+            rPose.m_X = rOlder.m_Pose.m_X + (fraction * (rNewer.m_Pose.m_X - rOlder.m_Pose.m_X));
+            rPose.m_Y = rOlder.m_Pose.m_Y + (fraction * (rNewer.m_Pose.m_Y - rOlder.m_Pose.m_Y));
+            rPose.m_Heading = WrapAngle(rOlder.m_Pose.m_Heading + (fraction * WrapAngle(rNewer.m_Pose.m_Heading - rOlder.m_Pose.m_Heading)));
+            return true;
+        }
+
+        newerIndex = olderIndex;
+    }
+
+    // Older than anything kept
+    return false;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method DriveOdometry::AddVisionMeasurement
+///
+/// Corrects the position with a sighting of a target whose
+/// field position is known.  The bearing is the angle to the
+/// target from straight ahead (counter clockwise positive).
+/// The gyro is trusted for heading, so only position changes.
+/// With a range the sighting fixes a point, without one it
+/// fixes the line back from the target the robot must be on,
+/// and the closest point on that line is used.  Either way the
+/// comparison is against the pose at capture time, and a part
+/// of the difference is applied to the pose now.
+///
+////////////////////////////////////////////////////////////////
+bool DriveOdometry::AddVisionMeasurement(double bearing, double rangeInches, double targetX, double targetY, uint64_t captureTimestampUs)
+{
+    Pose capturePose;
+    if (!GetPoseAt(captureTimestampUs, capturePose))
+    {
+        return false;
+    }
+
+    // Direction from the robot to the target on the field
+    const double sightAngle = capturePose.m_Heading + bearing;
+    const double sightX = std::cos(sightAngle);
+    const double sightY = std::sin(sightAngle);
+
+    double measuredX = 0.0;
+    double measuredY = 0.0;
+    if (rangeInches > 0.0)
+    {
+        measuredX = targetX - (rangeInches * sightX);
+        measuredY = targetY - (rangeInches * sightY);
+    }
+    else
+    {
+        const double alongSight = ((targetX - capturePose.m_X) * sightX) + ((targetY - capturePose.m_Y) * sightY);
+        measuredX = targetX - (alongSight * sightX);
+        measuredY = targetY - (alongSight * sightY);
+    }
+
+    const double errorX = measuredX - capturePose.m_X;
+    const double errorY = measuredY - capturePose.m_Y;
+    if (std::hypot(errorX, errorY) > MAX_VISION_CORRECTION_INCHES)
+    {
+        return false;
+    }
+
+    // Shift everything so later lookups agree with the correction
+    const double correctionX = VISION_CORRECTION_GAIN * errorX;
+    const double correctionY = VISION_CORRECTION_GAIN * errorY;
+    m_Pose.m_X += correctionX;
+    m_Pose.m_Y += correctionY;
+    for (unsigned i = 0U; i < HISTORY_SIZE; i++)
+    {
+        m_History[i].m_Pose.m_X += correctionX;
+        m_History[i].m_Pose.m_Y += correctionY;
+    }
+
+    return true;
+}
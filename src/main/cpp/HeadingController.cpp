@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   HeadingController.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for a closed loop controller that turns the
+/// robot to a gyro heading.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                        // for std::abs, std::fmod
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "HeadingController.hpp"        // for class declaration
+#include "RobotUtils.hpp"               // for Limit()
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method HeadingController::HeadingController
+///
+/// Constructor.
+///
+////////////////////////////////////////////////////////////////
+HeadingController::HeadingController(const Gains & rGains) :
+    m_Gains(rGains),
+    m_TargetAngle(0.0),
+    m_MaxOutput(0.0),
+    m_Error(0.0),
+    m_LastAngle(0.0),
+    m_IntegralSum(0.0),
+    m_Output(0.0),
+    m_SettledLoopCount(0U),
+    m_bFirstUpdate(true)
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method HeadingController::GetShortestAngleError
+///
+/// Returns how far to turn to get from the current angle to
+/// the target angle, going whichever way is shorter.  Positive
+/// means the angle needs to increase.  The inputs can be any
+/// angle, they do not need to be between 0 and 360.
+///
+////////////////////////////////////////////////////////////////
+double HeadingController::GetShortestAngleError(double targetAngle, double currentAngle)
+{
+    double error = std::fmod(targetAngle - currentAngle, 360.0);
+
+    if (error > 180.0)
+    {
+        error -= 360.0;
+    }
+    else if (error <= -180.0)
+    {
+        error += 360.0;
+    }
+    else
+    {
+    }
+
+    return error;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method HeadingController::Start
+///
+/// Sets a new heading to turn to and clears everything left
+/// over from the last turn.
+///
+////////////////////////////////////////////////////////////////
+void HeadingController::Start(double targetAngle, double maxOutput)
+{
+    m_TargetAngle = targetAngle;
+    m_MaxOutput = std::abs(maxOutput);
+    m_Error = 0.0;
+    m_IntegralSum = 0.0;
+    m_Output = 0.0;
+    m_SettledLoopCount = 0U;
+    m_bFirstUpdate = true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method HeadingController::Update
+///
+/// Runs the controller for one loop.  The derivative is taken
+/// on the measured angle rather than the error, so changing
+/// the target doesn't kick the output.  Once the robot is on
+/// target and barely moving for long enough, the controller
+/// reports settled.
+///
+////////////////////////////////////////////////////////////////
+double HeadingController::Update(double currentAngle)
+{
+    m_Error = GetShortestAngleError(m_TargetAngle, currentAngle);
+
+    // How far the robot turned since the last loop
+    double rate = 0.0;
+    if (!m_bFirstUpdate)
+    {
+        rate = GetShortestAngleError(currentAngle, m_LastAngle);
+    }
+    m_LastAngle = currentAngle;
+    m_bFirstUpdate = false;
+
+    // Only integrate near the target, otherwise the sum winds up during the turn
+    if (std::abs(m_Error * m_Gains.m_Kp) < m_MaxOutput)
+    {
+        m_IntegralSum += m_Error * m_Gains.m_Ki;
+        m_IntegralSum = RobotUtils::Limit(m_IntegralSum, m_Gains.m_IntegralLimit, -m_Gains.m_IntegralLimit);
+    }
+
+    double output = (m_Error * m_Gains.m_Kp) + m_IntegralSum - (rate * m_Gains.m_Kd);
+    output = RobotUtils::Limit(output, m_MaxOutput, -m_MaxOutput);
+    output = RobotUtils::Limit(output, m_Output + m_Gains.m_MaxOutputChange, m_Output - m_Gains.m_MaxOutputChange);
+    m_Output = output;
+
+    if ((std::abs(m_Error) <= m_Gains.m_ToleranceDegrees) && (std::abs(rate) <= m_Gains.m_MaxSettledRateDegrees))
+    {
+        if (m_SettledLoopCount < m_Gains.m_SettleLoops)
+        {
+            m_SettledLoopCount++;
+        }
+    }
+    else
+    {
+        m_SettledLoopCount = 0U;
+    }
+
+    return m_Output;
+}
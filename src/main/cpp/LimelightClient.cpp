@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   LimelightClient.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for receiving limelight results from network
+/// tables.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <algorithm>                            // for std::max
+
+// C INCLUDES
+#include "frc/RobotController.h"                // for GetFPGATime()
+#include "ntcore_cpp.h"                         // for nt::Now()
+
+// C++ INCLUDES
+#include "LimelightClient.hpp"                  // for class declaration
+
+using namespace frc;
+
+// STATIC MEMBER DATA
+nt::NetworkTableEntry                   LimelightClient::m_TargetXEntry;
+nt::NetworkTableEntry                   LimelightClient::m_TargetYEntry;
+nt::NetworkTableEntry                   LimelightClient::m_TargetAreaEntry;
+nt::NetworkTableEntry                   LimelightClient::m_TargetValidEntry;
+nt::NetworkTableEntry                   LimelightClient::m_LatencyEntry;
+nt::NetworkTableEntry                   LimelightClient::m_CameraModeEntry;
+uint64_t                                LimelightClient::m_LastChange = 0U;
+SeqLockSnapshot<LimelightClient::Frame> LimelightClient::m_FrameSnapshot;
+std::atomic<bool>                       LimelightClient::m_bInitialized(false);
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LimelightClient::Initialize
+///
+/// Looks up every entry the robot uses.  Reference:
+/// http://docs.limelightvision.io/en/latest/networktables_api.html
+///
+////////////////////////////////////////////////////////////////
+void LimelightClient::Initialize(std::shared_ptr<nt::NetworkTable> pLimelightTable)
+{
+    if (m_bInitialized)
+    {
+        return;
+    }
+
+    m_TargetXEntry = pLimelightTable->GetEntry("tx");
+    m_TargetYEntry = pLimelightTable->GetEntry("ty");
+    m_TargetAreaEntry = pLimelightTable->GetEntry("ta");
+    m_TargetValidEntry = pLimelightTable->GetEntry("tv");
+    m_LatencyEntry = pLimelightTable->GetEntry("tl");
+    m_CameraModeEntry = pLimelightTable->GetEntry("camMode");
+
+    m_bInitialized = true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LimelightClient::Update
+///
+/// Copies a frame out of the entries into the snapshot if any
+/// of them changed since the last one.  Only the robot loop
+/// calls this, so the snapshot has a single writer.  The frame
+/// arrived when its newest entry did, which can be most of a
+/// loop ago, so the capture time is worked back from that.
+///
+////////////////////////////////////////////////////////////////
+void LimelightClient::Update()
+{
+    static const double US_PER_MS = 1000.0;
+
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    // Last change times are in network tables time (microseconds)
+    const nt::NetworkTableEntry * const RESULT_ENTRIES[] = {&m_TargetXEntry, &m_TargetYEntry, &m_TargetAreaEntry, &m_TargetValidEntry, &m_LatencyEntry};
+    uint64_t lastChange = 0U;
+    for (const nt::NetworkTableEntry * pEntry : RESULT_ENTRIES)
+    {
+        lastChange = std::max(lastChange, pEntry->GetLastChange());
+    }
+
+    if (lastChange <= m_LastChange)
+    {
+        return;
+    }
+    m_LastChange = lastChange;
+
+    const uint64_t currentTimeUs = RobotController::GetFPGATime();
+    const uint64_t ntTimeUs = nt::Now();
+    const uint64_t sinceArrivalUs = (ntTimeUs > lastChange) ? (ntTimeUs - lastChange) : 0U;
+    const uint64_t arrivalTimeUs = (sinceArrivalUs < currentTimeUs) ? (currentTimeUs - sinceArrivalUs) : 0U;
+
+    Frame frame;
+    frame.m_TargetX = m_TargetXEntry.GetDouble(0.0);
+    frame.m_TargetY = m_TargetYEntry.GetDouble(0.0);
+    frame.m_TargetArea = m_TargetAreaEntry.GetDouble(0.0);
+    frame.m_bTargetValid = (static_cast<int>(m_TargetValidEntry.GetDouble(0.0)) == 1);
+    frame.m_LatencyMs = m_LatencyEntry.GetDouble(0.0) + CAPTURE_LATENCY_MS;
+
+    const uint64_t latencyUs = static_cast<uint64_t>(frame.m_LatencyMs * US_PER_MS);
+    frame.m_CaptureTimestampUs = (latencyUs < arrivalTimeUs) ? (arrivalTimeUs - latencyUs) : 0U;
+
+    m_FrameSnapshot.Publish(frame, arrivalTimeUs);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LimelightClient::GetNewFrame
+///
+/// Gets the latest frame if it hasn't been seen by this caller
+/// yet.  Each caller keeps its own last sequence number, so
+/// more than one controller can follow the frames.  A frame
+/// that has sat too long is not returned even if it's new.
+///
+////////////////////////////////////////////////////////////////
+bool LimelightClient::GetNewFrame(uint32_t & rLastSequenceNumber, FrameSample & rSample)
+{
+    if (m_FrameSnapshot.GetSequenceNumber() == rLastSequenceNumber)
+    {
+        return false;
+    }
+
+    if (!m_FrameSnapshot.Read(rSample))
+    {
+        return false;
+    }
+
+    rLastSequenceNumber = rSample.m_SequenceNumber;
+    return ((RobotController::GetFPGATime() - rSample.m_TimestampUs) <= MAX_FRAME_AGE_US);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LimelightClient::SetCameraMode
+///
+/// Sends a new camera mode to the limelight.
+///
+////////////////////////////////////////////////////////////////
+void LimelightClient::SetCameraMode(int mode)
+{
+    if (m_bInitialized)
+    {
+        m_CameraModeEntry.SetDouble(mode);
+    }
+}
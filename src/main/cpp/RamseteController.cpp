@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RamseteController.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for a Ramsete trajectory following controller.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                        // for trig functions
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "RamseteController.hpp"        // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RamseteController::Calculate
+///
+/// The standard Ramsete law.  The gain k grows with speed, so
+/// the correction is gentle when the trajectory is moving
+/// slowly.  The sideways error is scaled by sin(e)/e, which is
+/// taken as one when the heading error is close to zero.
+///
+////////////////////////////////////////////////////////////////
+void RamseteController::Calculate(const DriveOdometry::Pose & rPose, const TrajectoryRecords::Point & rDesired, double & rVelocity, double & rTurnRate) const
+{
+    // Error in the robot's frame
+    const double fieldErrorX = rDesired.m_X - rPose.m_X;
+    const double fieldErrorY = rDesired.m_Y - rPose.m_Y;
+    const double cosHeading = std::cos(rPose.m_Heading);
+    const double sinHeading = std::sin(rPose.m_Heading);
+    const double errorX = (cosHeading * fieldErrorX) + (sinHeading * fieldErrorY);
+    const double errorY = (cosHeading * fieldErrorY) - (sinHeading * fieldErrorX);
+    const double errorHeading = DriveOdometry::WrapAngle(rDesired.m_Heading - rPose.m_Heading);
+
+    const double desiredVelocity = rDesired.m_Velocity;
+    const double desiredTurnRate = rDesired.m_Velocity * rDesired.m_Curvature;
+
+    const double k = 2.0 * m_Gains.m_Zeta * std::sqrt((desiredTurnRate * desiredTurnRate) + (m_Gains.m_B * desiredVelocity * desiredVelocity));
+    const double sinc = (std::abs(errorHeading) < 1.0e-6) ? 1.0 : (std::sin(errorHeading) / errorHeading);
+
+    rVelocity = (desiredVelocity * std::cos(errorHeading)) + (k * errorX);
+    rTurnRate = desiredTurnRate + (k * errorHeading) + (m_Gains.m_B * desiredVelocity * sinc * errorY);
+}
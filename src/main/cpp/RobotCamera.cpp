@@ -9,161 +9,186 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 // SYSTEM INCLUDES
-// <none>
+#include <algorithm>                            // for std::min
+#include <thread>                               // for std::this_thread
 
 // C INCLUDES
 #include "cameraserver/CameraServer.h"          // for CameraServer instance
 #include "networktables/NetworkTable.h"         // for network tables
 #include "networktables/NetworkTableInstance.h" // for network table instance
+#include "frc/RobotController.h"                // for GetFPGATime()
 
 // C++ INCLUDES
+#include "LimelightClient.hpp"                  // for limelight results
 #include "RobotCamera.hpp"                      // for class declaration
+#include "RobotTelemetry.hpp"                   // for publishing telemetry
+#include "RobotThreads.hpp"                     // for ConfigureCurrentThread()
+#include "RobotTiming.hpp"                      // for ThreadCpuMonitor, JitterMonitor
 #include "RobotUtils.hpp"                       // for DisplayMessage(), DisplayFormattedMessage()
 #include "YtaRobot.hpp"                         // for GetRobotInstance()
 
 // STATIC MEMBER DATA
-std::shared_ptr<NetworkTable>                   RobotCamera::m_pLimelightNetworkTable;
 RobotCamera::UsbCameraStorage                   RobotCamera::m_UsbCameras;
 RobotCamera::UsbCameraInfo *                    RobotCamera::m_pCurrentUsbCamera;
 cs::CvSource                                    RobotCamera::m_CameraOutput;
 int                                             RobotCamera::m_NumUsbCamerasPresent;
+std::atomic<int>                                RobotCamera::m_RequestedUsbCamera(FRONT_USB);
+std::atomic<int>                                RobotCamera::m_RequestedLimelightMode(LIMELIGHT_MODE_NOT_SET);
+int                                             RobotCamera::m_AppliedLimelightMode = LIMELIGHT_MODE_NOT_SET;
 
 cv::Mat                                         RobotCamera::m_SourceMat;
 cv::Mat                                         RobotCamera::m_ResizeOutputMat;
+cv::Mat                                         RobotCamera::m_HsvConvertedMat;
 cv::Mat                                         RobotCamera::m_HsvThresholdOutputMat; 
 cv::Mat                                         RobotCamera::m_ErodeOutputMat;
 cv::Mat                                         RobotCamera::m_ContoursMat;
 cv::Mat                                         RobotCamera::m_FilteredContoursMat;
 cv::Mat                                         RobotCamera::m_VisionTargetMat;
-cv::Mat *                                       RobotCamera::m_pDashboardMat;
+cv::Mat                                         RobotCamera::m_ThresholdInputMat;
+cv::Mat                                         RobotCamera::m_ContourInputMat;
+std::atomic<cv::Mat *>                          RobotCamera::m_pDashboardMat(&RobotCamera::m_SourceMat);
+FrameQueue<RobotCamera::FrameInfo, RobotCamera::FRAME_QUEUE_DEPTH> RobotCamera::m_CaptureQueue;
+FrameQueue<RobotCamera::FrameInfo, RobotCamera::FRAME_QUEUE_DEPTH> RobotCamera::m_ThresholdQueue;
+SeqLockSnapshot<RobotCamera::SearchRegion>      RobotCamera::m_SearchRegionSnapshot;
+RobotCamera::SearchRegion                       RobotCamera::m_TrackedSearchRegion;
+unsigned                                        RobotCamera::m_TrackingMissCount;
 
 std::vector<std::vector<cv::Point>>             RobotCamera::m_Contours;
-std::vector<std::vector<cv::Point>>             RobotCamera::m_FilteredContours;
+std::vector<cv::Vec4i>                          RobotCamera::m_ContourHierarchy;
+std::vector<cv::Point>                          RobotCamera::m_ConvexHull;
+const cv::Mat                                   RobotCamera::ERODE_KERNEL;
 
 std::vector<RobotCamera::VisionTargetReport>    RobotCamera::m_ContourTargetReports;
 RobotCamera::VisionTargetReport                 RobotCamera::m_VisionTargetReport;
-bool                                            RobotCamera::m_bDoFullProcessing;
+SeqLockSnapshot<RobotCamera::VisionTargetReport> RobotCamera::m_VisionTargetSnapshot;
+std::atomic<bool>                               RobotCamera::m_bDoFullProcessing(false);
+std::atomic<int>                                RobotCamera::m_ProcessingScaleDivisor(FULL_SCALE);
 int                                             RobotCamera::m_HeartBeat;
+std::mutex                                      RobotCamera::m_CameraThreadMutex;
+std::condition_variable                         RobotCamera::m_CameraThreadCondition;
 const char *                                    RobotCamera::CAMERA_OUTPUT_NAME = "Camera Output";
 
-Timer                                           RobotCamera::AutonomousCamera::m_AutoCameraTimer;
 double                                          RobotCamera::AutonomousCamera::m_IntegralSum = 0.0;
+uint32_t                                        RobotCamera::AutonomousCamera::m_LastFrameSequence = 0U;
 
 
 ////////////////////////////////////////////////////////////////
 /// @method RobotCamera::AutonomousCamera::AlignToTarget
 ///
 /// This method tries to automatically align the robot to a
-/// target based on feedback from the camera.  It will execute
-/// until it finds the target or a safety timer expires.
+/// target based on feedback from the camera.  It runs one
+/// iteration of the alignment controller per new limelight
+/// frame and returns true once the target is found.  Between
+/// frames the motors keep the last command, so the integral
+/// only counts each frame once.  The autonomous step engine
+/// is responsible for the timeout and turning the motors off.
 ///
 ////////////////////////////////////////////////////////////////
 bool RobotCamera::AutonomousCamera::AlignToTarget(SeekDirection seekDirection, const bool bEnableMotors)
 {
     YtaRobot * pRobotObj = YtaRobot::GetRobotInstance();
-    bool bTargetFound = false;
-    m_AutoCameraTimer.Start();
 
-    while (!bTargetFound && (m_AutoCameraTimer.Get() < MAX_CAMERA_SEARCH_TIME_S))
+    LimelightClient::FrameSample frameSample;
+    if (!LimelightClient::GetNewFrame(m_LastFrameSequence, frameSample))
     {
-        // Reference: http://docs.limelightvision.io/en/latest/getting_started.html#basic-programming
-        double targetX = m_pLimelightNetworkTable->GetNumber("tx", 0.0);
-        //double targetY = m_pLimelightNetworkTable->GetNumber("ty", 0.0);
-        //double targetArea = m_pLimelightNetworkTable->GetNumber("ta", 0.0);
-        //double targetSkew = m_pLimelightNetworkTable->GetNumber("ts", 0.0);
-
-        // 1 = target in view, 0 = target not in view
-        bool bTargetValid = static_cast<bool>(static_cast<int>(m_pLimelightNetworkTable->GetNumber("tv", 0.0)));
-
-        // Reference: http://docs.limelightvision.io/en/latest/cs_seeking.html
-        double steeringAdjust = 0.0;
-        double leftCommand = 0.0;
-        double rightCommand = 0.0;
-
-        if (!bTargetValid)
+        // A limelight that stopped sending can't be steered by
+        if (!LimelightClient::GetLatestFrame(frameSample) ||
+            ((RobotController::GetFPGATime() - frameSample.m_TimestampUs) > LimelightClient::MAX_FRAME_AGE_US))
         {
-            constexpr double STARTING_SEEK_VALUE = 0.2;
-            
-            // No target - rotate to find target
-            if (seekDirection == SEEK_LEFT)
-            {
-                steeringAdjust = STARTING_SEEK_VALUE;
-            }
-            else if (seekDirection == SEEK_RIGHT)
-            {
-                steeringAdjust = -STARTING_SEEK_VALUE;
-            }
-            else
+            m_IntegralSum = 0.0;
+            if (bEnableMotors)
             {
+                pRobotObj->m_pLeftDriveMotors->Set(0.0);
+                pRobotObj->m_pRightDriveMotors->Set(0.0);
             }
-            
-            m_IntegralSum = 0.0;
         }
-        else
-        {
-            // We do see the target, execute aiming code
-
-            double headingError = targetX;
-            // steeringAdjust = Kp * targetX;   //Proportional controller
-            m_IntegralSum += headingError;      // (heading error + last heading error);
 
-            m_IntegralSum = RobotUtils::Limit(m_IntegralSum, INTEGRAL_SUM_LIMIT_VALUE, -INTEGRAL_SUM_LIMIT_VALUE);
+        // Otherwise there is nothing new to act on
+        return false;
+    }
 
-            // Proportional-Integral controller
-            steeringAdjust = (KP * targetX) + (KI * m_IntegralSum);
+    double targetX = frameSample.m_Data.m_TargetX;
+    bool bTargetValid = frameSample.m_Data.m_bTargetValid;
 
-            // Remember to limit the integration term
-            // Reset the integration term when target is out of the frame
-        }
+    // Reference: http://docs.limelightvision.io/en/latest/cs_seeking.html
+    double steeringAdjust = 0.0;
+    double leftCommand = 0.0;
+    double rightCommand = 0.0;
 
-        // The left and right commands both use addition here because
-        // the scaling constants will correct the direction.
-        leftCommand -= steeringAdjust;
-        rightCommand += steeringAdjust;
+    if (!bTargetValid)
+    {
+        constexpr double STARTING_SEEK_VALUE = 0.2;
         
-        // Make sure we don't spin the motors too fast
-        leftCommand = RobotUtils::Limit(leftCommand, MAX_SEEK_MOTOR_SPEED, -MAX_SEEK_MOTOR_SPEED);
-        rightCommand = RobotUtils::Limit(rightCommand, MAX_SEEK_MOTOR_SPEED, -MAX_SEEK_MOTOR_SPEED);
-
-        // Need a way to know when the target is found
-        if (bTargetValid && (leftCommand == 0.0) && (rightCommand == 0.0))
+        // No target - rotate to find target
+        if (seekDirection == SEEK_LEFT)
+        {
+            steeringAdjust = STARTING_SEEK_VALUE;
+        }
+        else if (seekDirection == SEEK_RIGHT)
+        {
+            steeringAdjust = -STARTING_SEEK_VALUE;
+        }
+        else
         {
-            bTargetFound = true;
-            break;
         }
+        
+        m_IntegralSum = 0.0;
+    }
+    else
+    {
+        // We do see the target, execute aiming code
 
-        // min speed 0.25
-        // max 0.5
-        // hardcoding motor commands to test the motor controllers and direction
-        // leftCommand=0.5;
-        // rightCommand=0.5;
+        double headingError = targetX;
+        // steeringAdjust = Kp * targetX;   //Proportional controller
+        m_IntegralSum += headingError;      // (heading error + last heading error);
 
-        // stay above 0.2 commands (new falcon motors might be better)
+        m_IntegralSum = RobotUtils::Limit(m_IntegralSum, INTEGRAL_SUM_LIMIT_VALUE, -INTEGRAL_SUM_LIMIT_VALUE);
 
-        // Set motor speed
-        if (bEnableMotors)
-        {
-            // Steer the robot
-            pRobotObj->m_pLeftDriveMotors->Set(-leftCommand);
-            pRobotObj->m_pRightDriveMotors->Set(rightCommand);
-        }
+        // Proportional-Integral controller
+        steeringAdjust = (KP * targetX) + (KI * m_IntegralSum);
 
-        // Send useful information to smart dashboard.
-        SmartDashboard::PutNumber("Steering adjust", steeringAdjust);
-        SmartDashboard::PutNumber("targetX", targetX);
-        SmartDashboard::PutNumber("Integral sum", m_IntegralSum);
-        SmartDashboard::PutNumber("Target valid", bTargetValid);
+        // Remember to limit the integration term
+        // Reset the integration term when target is out of the frame
     }
 
-    // Motors off
-    pRobotObj->m_pLeftDriveMotors->Set(0.0);
-    pRobotObj->m_pRightDriveMotors->Set(0.0);
+    // The left and right commands both use addition here because
+    // the scaling constants will correct the direction.
+    leftCommand -= steeringAdjust;
+    rightCommand += steeringAdjust;
+    
+    // Make sure we don't spin the motors too fast
+    leftCommand = RobotUtils::Limit(leftCommand, MAX_SEEK_MOTOR_SPEED, -MAX_SEEK_MOTOR_SPEED);
+    rightCommand = RobotUtils::Limit(rightCommand, MAX_SEEK_MOTOR_SPEED, -MAX_SEEK_MOTOR_SPEED);
+
+    // Send useful information to smart dashboard.
+    RobotTelemetry::Set(RobotTelemetry::LIMELIGHT_STEERING_ADJUST, steeringAdjust);
+    RobotTelemetry::Set(RobotTelemetry::LIMELIGHT_TARGET_X, targetX);
+    RobotTelemetry::Set(RobotTelemetry::LIMELIGHT_INTEGRAL_SUM, m_IntegralSum);
+    RobotTelemetry::Set(RobotTelemetry::LIMELIGHT_TARGET_VALID, bTargetValid);
+
+    // Need a way to know when the target is found
+    if (bTargetValid && (leftCommand == 0.0) && (rightCommand == 0.0))
+    {
+        return true;
+    }
+
+    // min speed 0.25
+    // max 0.5
+    // hardcoding motor commands to test the motor controllers and direction
+    // leftCommand=0.5;
+    // rightCommand=0.5;
+
+    // stay above 0.2 commands (new falcon motors might be better)
 
-    // Clean up the timer
-    m_AutoCameraTimer.Stop();
-    m_AutoCameraTimer.Reset();
+    // Set motor speed
+    if (bEnableMotors)
+    {
+        // Steer the robot
+        pRobotObj->m_pLeftDriveMotors->Set(-leftCommand);
+        pRobotObj->m_pRightDriveMotors->Set(rightCommand);
+    }
 
-    return bTargetFound;
+    return false;
 }
 
 
@@ -226,28 +251,74 @@ bool RobotCamera::CreateConfiguredCameras()
 
 
 
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::UpdateCurrentCamera
+///
+/// Switches to the camera the robot code last asked for.  Only
+/// the vision thread changes the current camera, so nothing
+/// needs to guard the pointer while a frame is processed.
+///
+////////////////////////////////////////////////////////////////
+void RobotCamera::UpdateCurrentCamera()
+{
+    UsbCameraInfo * pRequestedCamera = &m_UsbCameras.m_CamerasInfo[m_RequestedUsbCamera];
+    if ((pRequestedCamera != m_pCurrentUsbCamera) && pRequestedCamera->m_bIsPresent)
+    {
+        m_pCurrentUsbCamera = pRequestedCamera;
+    }
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 /// @method RobotCamera::LimelightThread
 ///
 /// This method contains the workflow for using a limelight
-/// camera.
+/// camera.  All the processing happens on the limelight, so the
+/// thread only has to send mode changes.  It stays parked until
+/// the robot code asks for a new mode.
 ///
 ////////////////////////////////////////////////////////////////
 void RobotCamera::LimelightThread()
 {
     // Indicate the thread has been started
     RobotUtils::DisplayMessage("Limelight vision thread detached.");
+    RobotThreads::ConfigureCurrentThread(RobotThreads::CAMERA_THREAD);
     
-    // Get the limelight network table
-    while (m_pLimelightNetworkTable == nullptr)
+    RobotTiming::ThreadCpuMonitor cpuMonitor("Limelight thread");
+    
+    // Get the limelight network table, backing off between attempts
+    std::shared_ptr<NetworkTable> pLimelightTable = nt::NetworkTableInstance::GetDefault().GetTable("limelight");
+    unsigned retryDelayMs = LIMELIGHT_TABLE_RETRY_START_MS;
+    while (pLimelightTable == nullptr)
     {
-        m_pLimelightNetworkTable = nt::NetworkTableInstance::GetDefault().GetTable("limelight");
+        std::this_thread::sleep_for(std::chrono::milliseconds(retryDelayMs));
+        retryDelayMs = std::min(retryDelayMs * 2U, LIMELIGHT_TABLE_RETRY_MAX_MS);
+        pLimelightTable = nt::NetworkTableInstance::GetDefault().GetTable("limelight");
     }
+    LimelightClient::Initialize(pLimelightTable);
     
     // The limelight camera mode will be set by autonomous or teleop
     
     while (true)
     {
+        int requestedMode = LIMELIGHT_MODE_NOT_SET;
+        {
+            // Waking once a report period keeps the CPU usage current
+            std::unique_lock<std::mutex> lock(m_CameraThreadMutex);
+            (void) m_CameraThreadCondition.wait_for(lock,
+                                                    RobotTiming::ThreadCpuMonitor::REPORT_PERIOD,
+                                                    []() { return (m_RequestedLimelightMode != m_AppliedLimelightMode); });
+            requestedMode = m_RequestedLimelightMode;
+        }
+        
+        if (requestedMode != m_AppliedLimelightMode)
+        {
+            LimelightClient::SetCameraMode(requestedMode);
+            m_AppliedLimelightMode = requestedMode;
+        }
+        
+        cpuMonitor.Update();
     }
 }
 
@@ -257,42 +328,21 @@ void RobotCamera::LimelightThread()
 /// @method RobotCamera::VisionThread
 ///
 /// This method contains the workflow of the main vision thread.
+/// The thread blocks waiting for frames while processing is
+/// enabled and parks completely while it is not.  When the
+/// processing is pipelined this thread is only the capture
+/// stage, and the threshold and contour stages get their own
+/// threads connected by frame queues.  The frame rate is then
+/// set by the slowest stage rather than the sum of them all.
 ///
 ////////////////////////////////////////////////////////////////
 void RobotCamera::VisionThread()
 {
     // Indicate the thread has been started
     RobotUtils::DisplayMessage("Vision thread detached.");
-    while (true) {}
+    RobotThreads::ConfigureCurrentThread(RobotThreads::CAMERA_THREAD);
     
-    /*
-    // Me
-    cs::UsbCamera usbCam = CameraServer::GetInstance()->StartAutomaticCapture();
-    usbCam.SetResolution(640, 480);
-    usbCam.SetFPS(30);
-    cs::CvSink usbSink = CameraServer::GetInstance()->GetVideo(usbCam);
-    cs::CvSource outputSource = CameraServer::GetInstance()->PutVideo(CAMERA_OUTPUT_NAME, 640, 480);
-    while (true)
-    {
-        //usbSink.GrabFrame(m_SourceMat);
-        //outputSource.PutFrame(m_SourceMat);
-    }
-    */
-    
-    // Sample WPI code
-    cs::UsbCamera camera = CameraServer::GetInstance()->StartAutomaticCapture();
-    camera.SetResolution(160, 120);
-    camera.SetFPS(30);
-    cs::CvSink cvSink = CameraServer::GetInstance()->GetVideo();
-    cs::CvSource outputStreamStd = CameraServer::GetInstance()->PutVideo("Camera Output", 160, 120);    // "Gray"
-    //cv::Mat source;
-    //cv::Mat output;
-    cv::Mat frame;
-    while(true) {
-        //cvSink.GrabFrame(frame);//source);
-        //cvtColor(source, output, cv::COLOR_BGR2GRAY);
-        //outputStreamStd.PutFrame(frame);//output);
-    }
+    RobotTiming::ThreadCpuMonitor cpuMonitor("Vision thread");
     
     // Clear the memory used for the camera storage
     std::memset(&m_UsbCameras, 0U, sizeof(UsbCameraStorage));
@@ -303,58 +353,152 @@ void RobotCamera::VisionThread()
     // Create the configured camera objects (the buffer was cleared during static initialization)
     bool bAnyCameraPresent = CreateConfiguredCameras();
     
-    // If there were no properly constructed cameras, just loop indefinitely
+    // If there were no properly constructed cameras, there is nothing for the thread to do
     if (!bAnyCameraPresent)
     {
-        while (true)
-        {
-            // Do nothing
-        }
+        RobotUtils::DisplayMessage("No cameras present, vision thread exiting.");
+        return;
     }
     
     // Set the default selected camera
     m_pCurrentUsbCamera = &m_UsbCameras.m_CamerasInfo[FRONT_USB];
     
+    // Frames should arrive at the camera's frame rate
+    RobotTiming::JitterMonitor jitterMonitor("Vision thread", std::chrono::microseconds(1000000 / m_pCurrentUsbCamera->FPS));
+    
     // Connect the output
     m_CameraOutput = CameraServer::GetInstance()->PutVideo(CAMERA_OUTPUT_NAME, m_pCurrentUsbCamera->X_RESOLUTION, m_pCurrentUsbCamera->Y_RESOLUTION);
     
+    // Size the per frame buffers up front
+    m_Contours.reserve(EXPECTED_MAX_CONTOURS);
+    m_ContourHierarchy.reserve(EXPECTED_MAX_CONTOURS);
+    m_ContourTargetReports.reserve(EXPECTED_MAX_CONTOURS);
+    
     // Set the default image to display
     m_pDashboardMat = &m_SourceMat;
     SmartDashboard::PutString("Camera Output", "Default");
     
-    // Default to not doing full processing unless the robot code says otherwise
-    m_bDoFullProcessing = false;
+    if (PIPELINED_PROCESSING)
+    {
+        std::thread thresholdStageThread(ThresholdStageThread);
+        std::thread contourStageThread(ContourStageThread);
+        thresholdStageThread.detach();
+        contourStageThread.detach();
+    }
 
     while (true)
     {
-        // Don't call this in production code - it hogs resources
-        UpdateSmartDashboard();
+        cpuMonitor.Update();
+        
+        // Pick up any camera change from the robot code
+        UpdateCurrentCamera();
+        
+        // The raw camera stream is served by the camera server, so
+        // there is no work to do here unless processing is enabled.
+        if (!m_bDoFullProcessing)
+        {
+            jitterMonitor.Restart();
+            
+            // Waking once a report period keeps the CPU usage current
+            std::unique_lock<std::mutex> lock(m_CameraThreadMutex);
+            (void) m_CameraThreadCondition.wait_for(lock,
+                                                    RobotTiming::ThreadCpuMonitor::REPORT_PERIOD,
+                                                    []() { return (m_bDoFullProcessing || (&m_UsbCameras.m_CamerasInfo[m_RequestedUsbCamera] != m_pCurrentUsbCamera)); });
+            continue;
+        }
         
-        // First, acquire an image from the currently selected camera
-        int grabFrameResult = 0;
-        grabFrameResult = m_pCurrentUsbCamera->m_CamSink.GrabFrame(m_SourceMat);
+        // First, acquire an image from the currently selected camera.
+        // This blocks until a frame arrives or the timeout expires.
+        uint64_t grabFrameResult = m_pCurrentUsbCamera->m_CamSink.GrabFrame(m_SourceMat, GRAB_FRAME_TIMEOUT_S);
         
         // Make sure it was successful before doing more processing
-        if (grabFrameResult == 0)
+        if (grabFrameResult == 0U)
         {
+            if (RobotUtils::DEBUG_PRINTS)
+            {
+                RobotUtils::DisplayFormattedMessage("Vision grab frame failed: %s\n", m_pCurrentUsbCamera->m_CamSink.GetError().c_str());
+            }
             continue;
         }
         
-        if (m_bDoFullProcessing)
+        jitterMonitor.Tick();
+        
+        // Stamp the frame in the same time base the rest of the robot code uses
+        FrameInfo frameInfo;
+        frameInfo.m_CaptureTimestampUs = RobotController::GetFPGATime();
+        
+        PutDashboardFrame(m_SourceMat);
+        
+        if (PIPELINED_PROCESSING)
         {
-            // Filter the image
-            ProcessImage();
-            
-            // Try and identify the reflective tape
-            FindReflectiveTapeTarget();
-            
-            // Calculate some info based on the reflective tape
-            CalculateReflectiveTapeValues();
+            // Swaps the frame out, m_SourceMat gets back a buffer to grab into next
+            m_CaptureQueue.Push(m_SourceMat, frameInfo);
+        }
+        else
+        {
+            ThresholdImage(m_SourceMat, frameInfo);
+            AnalyzeContours(m_ErodeOutputMat, frameInfo);
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::ThresholdStageThread
+///
+/// The pipelined stage that thresholds and erodes the captured
+/// frames.  It stays blocked on the capture queue while the
+/// capture stage is parked.
+///
+////////////////////////////////////////////////////////////////
+void RobotCamera::ThresholdStageThread()
+{
+    RobotThreads::ConfigureCurrentThread(RobotThreads::VISION_THRESHOLD_STAGE);
+    RobotTiming::ThreadCpuMonitor cpuMonitor("Vision threshold stage");
+    
+    while (true)
+    {
+        cpuMonitor.Update();
         
+        FrameInfo frameInfo;
+        if (!m_CaptureQueue.Pop(m_ThresholdInputMat, frameInfo, RobotTiming::ThreadCpuMonitor::REPORT_PERIOD))
+        {
+            continue;
         }
         
-        // Display the image to the dashboard
-        m_CameraOutput.PutFrame(*m_pDashboardMat);
+        ThresholdImage(m_ThresholdInputMat, frameInfo);
+        
+        // Swaps the eroded mat out, it gets back a buffer to erode into next
+        m_ThresholdQueue.Push(m_ErodeOutputMat, frameInfo);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::ContourStageThread
+///
+/// The pipelined stage that finds and measures the contours and
+/// reports the vision target.
+///
+////////////////////////////////////////////////////////////////
+void RobotCamera::ContourStageThread()
+{
+    RobotThreads::ConfigureCurrentThread(RobotThreads::VISION_CONTOUR_STAGE);
+    RobotTiming::ThreadCpuMonitor cpuMonitor("Vision contour stage");
+    
+    while (true)
+    {
+        cpuMonitor.Update();
+        
+        FrameInfo frameInfo;
+        if (!m_ThresholdQueue.Pop(m_ContourInputMat, frameInfo, RobotTiming::ThreadCpuMonitor::REPORT_PERIOD))
+        {
+            continue;
+        }
+        
+        AnalyzeContours(m_ContourInputMat, frameInfo);
     }
 }
 
@@ -363,33 +507,39 @@ void RobotCamera::VisionThread()
 ////////////////////////////////////////////////////////////////
 /// @method RobotCamera::UpdateSmartDashboard
 ///
-/// This method sends new data to the C++ Smart Dashboard.
+/// This method records the vision data for the next telemetry
+/// flush to the smart dashboard.
 ///
 ////////////////////////////////////////////////////////////////
 void RobotCamera::UpdateSmartDashboard()
 {
-    SmartDashboard::PutNumber("HeartBeat",                  m_HeartBeat++);
-    
-    SmartDashboard::PutNumber("Bounding rect X",            m_VisionTargetReport.m_BoundingRectX);
-    SmartDashboard::PutNumber("Bounding rect Y",            m_VisionTargetReport.m_BoundingRectY);
-    SmartDashboard::PutNumber("Bounding rect width",        m_VisionTargetReport.m_BoundingRectWidth);
-    SmartDashboard::PutNumber("Bounding rect height",       m_VisionTargetReport.m_BoundingRectHeight);
-    SmartDashboard::PutNumber("Bounding rect area",         m_VisionTargetReport.m_BoundingRectArea);
-    SmartDashboard::PutNumber("Bounding rect aspect ratio", m_VisionTargetReport.m_BoundingRectAspectRatio);
-    
-    SmartDashboard::PutNumber("Contour area",               m_VisionTargetReport.m_Area);
-    SmartDashboard::PutNumber("Contour perimeter",          m_VisionTargetReport.m_Perimeter);
-    SmartDashboard::PutNumber("Contour convex hull area",   m_VisionTargetReport.m_ConvexHullArea);
-    SmartDashboard::PutNumber("Contour solidity",           m_VisionTargetReport.m_Solidity);
-    SmartDashboard::PutNumber("Contour vertices",           m_VisionTargetReport.m_Vertices);
-    
-    SmartDashboard::PutNumber("Area %",                     m_VisionTargetReport.m_PercentAreaToImageArea);
-    SmartDashboard::PutNumber("Trapezoid %",                m_VisionTargetReport.m_TrapezoidPercent);
-    SmartDashboard::PutNumber("Camera distance, X",         m_VisionTargetReport.m_CameraDistanceX);
-    SmartDashboard::PutNumber("Camera distance, Y",         m_VisionTargetReport.m_CameraDistanceY);
-    SmartDashboard::PutNumber("Ground distance",            m_VisionTargetReport.m_GroundDistance);
-    SmartDashboard::PutNumber("Target in range",            m_VisionTargetReport.m_bTargetInRange);
-    SmartDashboard::PutNumber("Target report valid",        m_VisionTargetReport.m_bIsValid);
+    RobotTelemetry::Set(RobotTelemetry::CAMERA_HEARTBEAT,           m_HeartBeat++);
+    
+    RobotTelemetry::Set(RobotTelemetry::BOUNDING_RECT_X,            m_VisionTargetReport.m_BoundingRectX);
+    RobotTelemetry::Set(RobotTelemetry::BOUNDING_RECT_Y,            m_VisionTargetReport.m_BoundingRectY);
+    RobotTelemetry::Set(RobotTelemetry::BOUNDING_RECT_WIDTH,        m_VisionTargetReport.m_BoundingRectWidth);
+    RobotTelemetry::Set(RobotTelemetry::BOUNDING_RECT_HEIGHT,       m_VisionTargetReport.m_BoundingRectHeight);
+    RobotTelemetry::Set(RobotTelemetry::BOUNDING_RECT_AREA,         m_VisionTargetReport.m_BoundingRectArea);
+    RobotTelemetry::Set(RobotTelemetry::BOUNDING_RECT_ASPECT_RATIO, m_VisionTargetReport.m_BoundingRectAspectRatio);
+    
+    RobotTelemetry::Set(RobotTelemetry::CONTOUR_AREA,               m_VisionTargetReport.m_Area);
+    RobotTelemetry::Set(RobotTelemetry::CONTOUR_PERIMETER,          m_VisionTargetReport.m_Perimeter);
+    RobotTelemetry::Set(RobotTelemetry::CONTOUR_CONVEX_HULL_AREA,   m_VisionTargetReport.m_ConvexHullArea);
+    RobotTelemetry::Set(RobotTelemetry::CONTOUR_SOLIDITY,           m_VisionTargetReport.m_Solidity);
+    RobotTelemetry::Set(RobotTelemetry::CONTOUR_VERTICES,           m_VisionTargetReport.m_Vertices);
+    
+    RobotTelemetry::Set(RobotTelemetry::TARGET_AREA_PERCENT,        m_VisionTargetReport.m_PercentAreaToImageArea);
+    RobotTelemetry::Set(RobotTelemetry::TARGET_TRAPEZOID_PERCENT,   m_VisionTargetReport.m_TrapezoidPercent);
+    RobotTelemetry::Set(RobotTelemetry::CAMERA_DISTANCE_X,          m_VisionTargetReport.m_CameraDistanceX);
+    RobotTelemetry::Set(RobotTelemetry::CAMERA_DISTANCE_Y,          m_VisionTargetReport.m_CameraDistanceY);
+    RobotTelemetry::Set(RobotTelemetry::GROUND_DISTANCE,            m_VisionTargetReport.m_GroundDistance);
+    RobotTelemetry::Set(RobotTelemetry::TARGET_IN_RANGE,            m_VisionTargetReport.m_bTargetInRange);
+    RobotTelemetry::Set(RobotTelemetry::TARGET_REPORT_VALID,        m_VisionTargetReport.m_bIsValid);
+    
+    static const double US_PER_MS = 1000.0;
+    RobotTelemetry::Set(RobotTelemetry::VISION_LATENCY_MS,          (RobotController::GetFPGATime() - m_VisionTargetReport.m_CaptureTimestampUs) / US_PER_MS);
+    RobotTelemetry::Set(RobotTelemetry::VISION_FRAMES_DROPPED,      m_CaptureQueue.GetNumDropped() + m_ThresholdQueue.GetNumDropped());
+    RobotTelemetry::Set(RobotTelemetry::VISION_TRACKING_TARGET,     (m_TrackedSearchRegion.m_Width != 0));
 }
 
 
@@ -456,18 +606,183 @@ void RobotCamera::ToggleCameraProcessedImage()
     
     
 ////////////////////////////////////////////////////////////////
-/// @method RobotCamera::ProcessImage
+/// @method RobotCamera::ThresholdImage
+///
+/// The first half of the vision pipeline.  Filters a frame down
+/// to a binary image in m_ErodeOutputMat.  The frame is first
+/// scaled down if a smaller processing scale is selected.
+/// While a target is being tracked only the region around it is
+/// processed.
+///
+////////////////////////////////////////////////////////////////
+void RobotCamera::ThresholdImage(const cv::Mat & rSourceMat, FrameInfo & rFrameInfo)
+{
+    // Read the scale once, the rest of the pipeline uses what this frame was processed at
+    const int scaleDivisor = m_ProcessingScaleDivisor;
+    rFrameInfo.m_ScaleDivisor = scaleDivisor;
+    
+    const cv::Mat * pProcessingMat = &rSourceMat;
+    if (scaleDivisor > FULL_SCALE)
+    {
+        // Nearest neighbor just decimates, which is the cheapest option
+        const cv::Size processingSize(rSourceMat.size().width / scaleDivisor, rSourceMat.size().height / scaleDivisor);
+        cv::resize(rSourceMat, m_ResizeOutputMat, processingSize, 0.0, 0.0, cv::INTER_NEAREST);
+        pProcessingMat = &m_ResizeOutputMat;
+    }
+    const cv::Mat & rProcessingMat = *pProcessingMat;
+    
+    const cv::Rect searchRegion = GetSearchRegion(rProcessingMat.size(), scaleDivisor);
+    rFrameInfo.m_SearchRegion = searchRegion;
+    
+    // The outputs stay full size so the buffers aren't reallocated as the
+    // region moves.  Only the region is written, so clear the rest of them.
+    m_HsvConvertedMat.create(rProcessingMat.size(), rProcessingMat.type());
+    m_HsvThresholdOutputMat.create(rProcessingMat.size(), CV_8UC1);
+    m_ErodeOutputMat.create(rProcessingMat.size(), CV_8UC1);
+    if (searchRegion.area() < rProcessingMat.size().area())
+    {
+        m_HsvThresholdOutputMat.setTo(cv::Scalar::all(0));
+        m_ErodeOutputMat.setTo(cv::Scalar::all(0));
+    }
+    
+    FilterImageHsv(rProcessingMat, searchRegion);
+    PutDashboardFrame(m_HsvThresholdOutputMat);
+    
+    ErodeImage(searchRegion);
+    PutDashboardFrame(m_ErodeOutputMat);
+}
+
+    
+    
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::AnalyzeContours
+///
+/// The second half of the vision pipeline.  Finds the vision
+/// target in a binary image and publishes the report.
+///
+////////////////////////////////////////////////////////////////
+void RobotCamera::AnalyzeContours(const cv::Mat & rBinaryMat, const FrameInfo & rFrameInfo)
+{
+    const uint64_t captureTimestampUs = rFrameInfo.m_CaptureTimestampUs;
+    const int scaleDivisor = rFrameInfo.m_ScaleDivisor;
+    const cv::Size captureSize(rBinaryMat.size().width * scaleDivisor, rBinaryMat.size().height * scaleDivisor);
+    
+    // The contours are in processed coordinates, the reports are in capture coordinates
+    FindContours(rBinaryMat, rFrameInfo.m_SearchRegion);
+    FilterContours(scaleDivisor);
+    PutDashboardFrame(m_ContoursMat);
+    PutDashboardFrame(m_FilteredContoursMat);
+    
+    // Try and identify the reflective tape
+    FindReflectiveTapeTarget();
+    PutDashboardFrame(m_VisionTargetMat);
+    
+    // Decide where to look in the next frame
+    UpdateSearchRegion(captureSize, captureTimestampUs);
+    
+    // Calculate some info based on the reflective tape
+    CalculateReflectiveTapeValues(captureSize);
+    
+    // Done after finding the target since that clears the report when there isn't one
+    m_VisionTargetReport.m_CaptureTimestampUs = captureTimestampUs;
+    m_VisionTargetSnapshot.Publish(m_VisionTargetReport, captureTimestampUs);
+    
+    // Don't call this in production code - it hogs resources
+    UpdateSmartDashboard();
+}
+
+    
+    
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::GetSearchRegion
+///
+/// Returns the part of the processed frame to search for the
+/// target.  It is the whole frame unless the contour stage is
+/// tracking a target.  The tracked region is kept in capture
+/// coordinates, so it is scaled to the processed frame here.
+///
+////////////////////////////////////////////////////////////////
+cv::Rect RobotCamera::GetSearchRegion(const cv::Size & processingSize, const int scaleDivisor)
+{
+    const cv::Rect fullFrame(0, 0, processingSize.width, processingSize.height);
+    
+    SeqLockSnapshot<SearchRegion>::Sample regionSample;
+    if (!TARGET_TRACKING_ENABLED || !m_SearchRegionSnapshot.Read(regionSample) || (regionSample.m_Data.m_Width == 0))
+    {
+        return fullFrame;
+    }
+    
+    // Round the size up so scaling never cuts off the target, then clip
+    // to the frame in case the camera or the scale changed
+    const SearchRegion & rRegion = regionSample.m_Data;
+    const cv::Rect searchRegion = cv::Rect(rRegion.m_X / scaleDivisor,
+                                           rRegion.m_Y / scaleDivisor,
+                                           (rRegion.m_Width + scaleDivisor - 1) / scaleDivisor,
+                                           (rRegion.m_Height + scaleDivisor - 1) / scaleDivisor) & fullFrame;
+    return (searchRegion.empty() ? fullFrame : searchRegion);
+}
+
+    
+    
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::UpdateSearchRegion
 ///
-/// Processes an image from the camera to try and identify
-/// vision targets.
+/// Tracks the target found in this frame.  The next search is
+/// limited to a padded region around it, and goes back to the
+/// whole frame once the target has been missed too many times
+/// in a row.
 ///
 ////////////////////////////////////////////////////////////////
-void RobotCamera::ProcessImage()
+void RobotCamera::UpdateSearchRegion(const cv::Size & frameSize, const uint64_t captureTimestampUs)
 {
-    FilterImageHsv();
-    ErodeImage();
-    FindContours();
-    FilterContours();
+    if (!TARGET_TRACKING_ENABLED)
+    {
+        return;
+    }
+    
+    SearchRegion nextRegion = m_TrackedSearchRegion;
+    
+    if (m_VisionTargetReport.m_bIsValid)
+    {
+        m_TrackingMissCount = 0U;
+        
+        const int targetX = static_cast<int>(m_VisionTargetReport.m_BoundingRectX);
+        const int targetY = static_cast<int>(m_VisionTargetReport.m_BoundingRectY);
+        const int targetWidth = static_cast<int>(m_VisionTargetReport.m_BoundingRectWidth);
+        const int targetHeight = static_cast<int>(m_VisionTargetReport.m_BoundingRectHeight);
+        const int paddingX = std::max(TRACKING_MIN_PADDING_PIXELS, static_cast<int>(targetWidth * TRACKING_PADDING_RATIO));
+        const int paddingY = std::max(TRACKING_MIN_PADDING_PIXELS, static_cast<int>(targetHeight * TRACKING_PADDING_RATIO));
+        
+        const cv::Rect paddedRegion = cv::Rect(targetX - paddingX, targetY - paddingY, targetWidth + (2 * paddingX), targetHeight + (2 * paddingY))
+                                      & cv::Rect(0, 0, frameSize.width, frameSize.height);
+        nextRegion.m_X = paddedRegion.x;
+        nextRegion.m_Y = paddedRegion.y;
+        nextRegion.m_Width = paddedRegion.width;
+        nextRegion.m_Height = paddedRegion.height;
+    }
+    else if (m_TrackedSearchRegion.m_Width != 0)
+    {
+        m_TrackingMissCount++;
+        if (m_TrackingMissCount < TRACKING_MAX_MISSES)
+        {
+            // Keep looking in the same place for now
+            return;
+        }
+        
+        // Lost the target, back to searching the whole frame
+        nextRegion.m_X = 0;
+        nextRegion.m_Y = 0;
+        nextRegion.m_Width = 0;
+        nextRegion.m_Height = 0;
+    }
+    else
+    {
+        // Already searching the whole frame
+        return;
+    }
+    
+    m_TrackedSearchRegion = nextRegion;
+    m_SearchRegionSnapshot.Publish(nextRegion, captureTimestampUs);
 }
 
     
@@ -479,7 +794,7 @@ void RobotCamera::ProcessImage()
 /// and Value.
 ///
 ////////////////////////////////////////////////////////////////
-void RobotCamera::FilterImageHsv()
+void RobotCamera::FilterImageHsv(const cv::Mat & rSourceMat, const cv::Rect & rSearchRegion)
 {
     // min/max values
     static double hsvThresholdHue[] = {0.0, 180.0};
@@ -500,12 +815,16 @@ void RobotCamera::FilterImageHsv()
     SmartDashboard::PutNumber("V min", hsvThresholdValue[0]);
     SmartDashboard::PutNumber("V max", hsvThresholdValue[1]);
     
-    // Convert to HSV and filter
-    cv::cvtColor(m_SourceMat, m_HsvThresholdOutputMat, cv::COLOR_BGR2HSV);
-    cv::inRange(m_HsvThresholdOutputMat,
+    // Convert to HSV and filter.  The conversion gets its own mat since the
+    // threshold output has one channel, and sharing would reallocate both.
+    // The region headers write straight into the full size mats.
+    cv::Mat hsvRegion = m_HsvConvertedMat(rSearchRegion);
+    cv::Mat thresholdRegion = m_HsvThresholdOutputMat(rSearchRegion);
+    cv::cvtColor(rSourceMat(rSearchRegion), hsvRegion, cv::COLOR_BGR2HSV);
+    cv::inRange(hsvRegion,
                 cv::Scalar(hsvThresholdHue[0], hsvThresholdSaturation[0], hsvThresholdValue[0]),
                 cv::Scalar(hsvThresholdHue[1], hsvThresholdSaturation[1], hsvThresholdValue[1]),
-                m_HsvThresholdOutputMat);
+                thresholdRegion);
 }
 
     
@@ -513,10 +832,10 @@ void RobotCamera::FilterImageHsv()
 ////////////////////////////////////////////////////////////////
 /// @method RobotCamera::ErodeImage
 ///
-/// Erodes an image.
+/// Erodes the search region of the thresholded image.
 ///
 ////////////////////////////////////////////////////////////////
-void RobotCamera::ErodeImage()
+void RobotCamera::ErodeImage(const cv::Rect & rSearchRegion)
 {
     // Erode image
     // @param src input image
@@ -526,8 +845,8 @@ void RobotCamera::ErodeImage()
     // @param iterations number of times erosion is applied.
     // @param borderType pixel extrapolation method, see cv::BorderTypes
     // @param borderValue border value in case of a constant border
-    cv::Mat cvErodeKernel;
-    cv::erode(m_HsvThresholdOutputMat, m_ErodeOutputMat, cvErodeKernel, cv::Point(-1, -1), 1, cv::BORDER_CONSTANT, cv::Scalar(-1));
+    cv::Mat erodeRegion = m_ErodeOutputMat(rSearchRegion);
+    cv::erode(m_HsvThresholdOutputMat(rSearchRegion), erodeRegion, ERODE_KERNEL, cv::Point(-1, -1), 1, cv::BORDER_CONSTANT, cv::Scalar(-1));
 }
 
     
@@ -535,10 +854,12 @@ void RobotCamera::ErodeImage()
 ////////////////////////////////////////////////////////////////
 /// @method RobotCamera::FindContours
 ///
-/// Finds the contours in an image.
+/// Finds the contours in the search region of an image.  The
+/// contour points are offset so they are in full frame
+/// coordinates.
 ///
 ////////////////////////////////////////////////////////////////
-void RobotCamera::FindContours()
+void RobotCamera::FindContours(const cv::Mat & rBinaryMat, const cv::Rect & rSearchRegion)
 {    
     // Find contours
     // @param image Source, an 8-bit single-channel image.
@@ -547,14 +868,18 @@ void RobotCamera::FindContours()
     // @param mode Contour retrieval mode, see cv::RetrievalModes ( ? cv::RETR_EXTERNAL : cv::RETR_LIST)
     // @param method Contour approximation method, see cv::ContourApproximationModes
     // @param offset Optional offset by which every contour point is shifted.
-    std::vector<cv::Vec4i> hierarchy;
-    m_Contours.clear();
-    cv::findContours(m_ErodeOutputMat, m_Contours, hierarchy, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+    // The contour vectors are not cleared first so findContours can reuse their capacity.
+    cv::findContours(rBinaryMat(rSearchRegion), m_Contours, m_ContourHierarchy, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE, rSearchRegion.tl());
     
-    // Reset the contour mats by clearing them
-    m_ContoursMat = cv::Mat::zeros(m_pDashboardMat->size(), m_pDashboardMat->type());
-    m_FilteredContoursMat = cv::Mat::zeros(m_pDashboardMat->size(), m_pDashboardMat->type());
-    m_VisionTargetMat = cv::Mat::zeros(m_pDashboardMat->size(), m_pDashboardMat->type());
+    // Reset the contour mats by clearing them.  They follow the binary mat rather
+    // than the dashboard mat so switching the dashboard view doesn't reallocate
+    // them.  Mat::create() does nothing if the size and type already match.
+    m_ContoursMat.create(rBinaryMat.size(), rBinaryMat.type());
+    m_ContoursMat.setTo(cv::Scalar::all(0));
+    m_FilteredContoursMat.create(rBinaryMat.size(), rBinaryMat.type());
+    m_FilteredContoursMat.setTo(cv::Scalar::all(0));
+    m_VisionTargetMat.create(rBinaryMat.size(), rBinaryMat.type());
+    m_VisionTargetMat.setTo(cv::Scalar::all(0));
     
     // @param image Destination image.
     // @param contours All the input contours. Each contour is stored as a point vector.
@@ -568,10 +893,13 @@ void RobotCamera::FindContours()
 ////////////////////////////////////////////////////////////////
 /// @method RobotCamera::FilterContours
 ///
-/// Filters the contours found by certain criteria.
+/// Filters the contours found by certain criteria.  The
+/// measurements are scaled back to capture resolution first, so
+/// the limits and the reports don't depend on the processing
+/// scale.
 ///
 ////////////////////////////////////////////////////////////////
-void RobotCamera::FilterContours()
+void RobotCamera::FilterContours(const int scaleDivisor)
 {    
     const double FILTER_CONTOURS_MIN_WIDTH      = 0.0;
     const double FILTER_CONTOURS_MAX_WIDTH      = 1000.0;
@@ -587,15 +915,20 @@ void RobotCamera::FilterContours()
     const double FILTER_CONTOURS_MIN_RATIO      = 0.0;
     const double FILTER_CONTOURS_MAX_RATIO      = 1000.0;
     
-    // Filter contours
-    m_FilteredContours.clear();
+    // Filter contours.  The cheap checks on the bounding rectangle and vertex
+    // count run first so most contours never reach area, perimeter or hull.
     m_ContourTargetReports.clear();
-    for (std::vector<cv::Point> contour : m_Contours)
+    const int numContours = static_cast<int>(m_Contours.size());
+    for (int contourIndex = 0; contourIndex < numContours; contourIndex++)
     {
-        VisionTargetReport currentContourReport;
+        const std::vector<cv::Point> & rContour = m_Contours[contourIndex];
         
         // Bounding rectangle filtering
-        cv::Rect boundingRectangle = cv::boundingRect(contour);
+        cv::Rect boundingRectangle = cv::boundingRect(rContour);
+        boundingRectangle.x *= scaleDivisor;
+        boundingRectangle.y *= scaleDivisor;
+        boundingRectangle.width *= scaleDivisor;
+        boundingRectangle.height *= scaleDivisor;
         if ((boundingRectangle.width) < FILTER_CONTOURS_MIN_WIDTH || (boundingRectangle.width > FILTER_CONTOURS_MAX_WIDTH))
         {
             continue;
@@ -604,66 +937,66 @@ void RobotCamera::FilterContours()
         {
             continue;
         }
-        // Fill out bounding rectangle info (done here so the loop can continue if criteria aren't met)
-        currentContourReport.m_BoundingRectX = boundingRectangle.x;
-        currentContourReport.m_BoundingRectY = boundingRectangle.y;
-        currentContourReport.m_BoundingRectWidth = boundingRectangle.width;
-        currentContourReport.m_BoundingRectHeight = boundingRectangle.height;
-        currentContourReport.m_BoundingRectArea = boundingRectangle.width * boundingRectangle.height;
         
-        // Max area is not a standard filtering technique in GRIP
-        double area = cv::contourArea(contour);
-        if ((area < FILTER_CONTOURS_MIN_AREA) || (area > FILTER_CONTOURS_MAX_AREA))
+        // Number of vertices
+        if ((rContour.size() < FILTER_CONTOURS_MIN_VERTICES) || (rContour.size() > FILTER_CONTOURS_MAX_VERTICES))
         {
             continue;
         }
-        currentContourReport.m_Area = area;
         
-        // Max perimeter is not a standard filtering technique in GRIP
-        double perimeter = cv::arcLength(contour, true);
-        if ((perimeter < FILTER_CONTOURS_MIN_PERIMETER) || (perimeter > FILTER_CONTOURS_MAX_PERIMETER))
+        // Aspect ratio
+        double ratio = static_cast<double>(boundingRectangle.width) / static_cast<double>(boundingRectangle.height);
+        if ((ratio < FILTER_CONTOURS_MIN_RATIO) || (ratio > FILTER_CONTOURS_MAX_RATIO))
         {
             continue;
         }
-        currentContourReport.m_Perimeter = perimeter;
         
-        std::vector<cv::Point> hull;
-        cv::convexHull(cv::Mat(contour, true), hull);
-        double hullArea = cv::contourArea(hull);
-        double solidity = 100.0 * (area / hullArea);
-        if ((solidity < FILTER_CONTOURS_SOLIDITY[0]) || (solidity > FILTER_CONTOURS_SOLIDITY[1]))
+        // Max area is not a standard filtering technique in GRIP
+        const double areaScale = static_cast<double>(scaleDivisor * scaleDivisor);
+        double area = cv::contourArea(rContour) * areaScale;
+        if ((area < FILTER_CONTOURS_MIN_AREA) || (area > FILTER_CONTOURS_MAX_AREA))
         {
             continue;
         }
-        currentContourReport.m_ConvexHullArea = hullArea;
-        currentContourReport.m_Solidity = solidity;
         
-        // Number of vertices
-        if ((contour.size() < FILTER_CONTOURS_MIN_VERTICES) || (contour.size() > FILTER_CONTOURS_MAX_VERTICES))
+        // Max perimeter is not a standard filtering technique in GRIP
+        double perimeter = cv::arcLength(rContour, true) * scaleDivisor;
+        if ((perimeter < FILTER_CONTOURS_MIN_PERIMETER) || (perimeter > FILTER_CONTOURS_MAX_PERIMETER))
         {
             continue;
         }
-        currentContourReport.m_Vertices = contour.size();
         
-        // Aspect ratio
-        double ratio = static_cast<double>(boundingRectangle.width) / static_cast<double>(boundingRectangle.height);
-        if ((ratio < FILTER_CONTOURS_MIN_RATIO) || (ratio > FILTER_CONTOURS_MAX_RATIO))
+        cv::convexHull(rContour, m_ConvexHull);
+        double hullArea = cv::contourArea(m_ConvexHull) * areaScale;
+        double solidity = 100.0 * (area / hullArea);
+        if ((solidity < FILTER_CONTOURS_SOLIDITY[0]) || (solidity > FILTER_CONTOURS_SOLIDITY[1]))
         {
             continue;
         }
-        currentContourReport.m_BoundingRectAspectRatio = boundingRectangle.width / boundingRectangle.height;
         
-        // All criteria passed, add this contour
+        // All criteria passed, fill out the report for this contour
+        VisionTargetReport currentContourReport = {};
+        currentContourReport.m_BoundingRectX = boundingRectangle.x;
+        currentContourReport.m_BoundingRectY = boundingRectangle.y;
+        currentContourReport.m_BoundingRectWidth = boundingRectangle.width;
+        currentContourReport.m_BoundingRectHeight = boundingRectangle.height;
+        currentContourReport.m_BoundingRectArea = boundingRectangle.width * boundingRectangle.height;
+        currentContourReport.m_BoundingRectAspectRatio = ratio;
+        currentContourReport.m_Area = area;
+        currentContourReport.m_Perimeter = perimeter;
+        currentContourReport.m_ConvexHullArea = hullArea;
+        currentContourReport.m_Solidity = solidity;
+        currentContourReport.m_Vertices = rContour.size();
+        currentContourReport.m_ContourIndex = contourIndex;
         currentContourReport.m_bIsValid = true;
-        m_FilteredContours.push_back(contour);
         m_ContourTargetReports.push_back(currentContourReport);
+        
+        // @param image Destination image.
+        // @param contours All the input contours. Each contour is stored as a point vector.
+        // @param contourIdx Parameter indicating a contour to draw. If it is negative, all the contours are drawn.
+        // @param color Color of the contours.
+        cv::drawContours(m_FilteredContoursMat, m_Contours, contourIndex, cv::Scalar(255, 255, 255));
     }
-    
-    // @param image Destination image.
-    // @param contours All the input contours. Each contour is stored as a point vector.
-    // @param contourIdx Parameter indicating a contour to draw. If it is negative, all the contours are drawn.
-    // @param color Color of the contours.
-    cv::drawContours(m_FilteredContoursMat, m_FilteredContours, -1, cv::Scalar(255, 255, 255));
 }
 
 
@@ -680,25 +1013,20 @@ void RobotCamera::FindReflectiveTapeTarget()
 {
     if (m_ContourTargetReports.size() > 0)
     {
-        int index = 0;
-        int candidateIndex = 0;
-        double currentMaxArea = 0.0;
+        const VisionTargetReport * pCandidateReport = &m_ContourTargetReports[0];
 
         // Iterate through the contour reports, searching for the best candidate
-        for (VisionTargetReport report : m_ContourTargetReports)
+        for (const VisionTargetReport & rReport : m_ContourTargetReports)
         {
-            if (report.m_Area > currentMaxArea)
+            if (rReport.m_Area > pCandidateReport->m_Area)
             {
-                currentMaxArea = report.m_Area;
-                m_VisionTargetReport = report;
-                candidateIndex = index;
+                pCandidateReport = &rReport;
             }
-            
-            index++;
         }
+        m_VisionTargetReport = *pCandidateReport;
         
         // Draw the candidate contour
-        cv::drawContours(m_VisionTargetMat, m_FilteredContours, candidateIndex, cv::Scalar(255, 255, 255));
+        cv::drawContours(m_VisionTargetMat, m_Contours, m_VisionTargetReport.m_ContourIndex, cv::Scalar(255, 255, 255));
     }
     else
     {
@@ -717,7 +1045,7 @@ void RobotCamera::FindReflectiveTapeTarget()
 /// vision target.
 ///
 ////////////////////////////////////////////////////////////////
-void RobotCamera::CalculateReflectiveTapeValues()
+void RobotCamera::CalculateReflectiveTapeValues(const cv::Size & frameSize)
 {
     // If there is no vision target report available, don't proceed
     if (!m_VisionTargetReport.m_bIsValid)
@@ -727,11 +1055,11 @@ void RobotCamera::CalculateReflectiveTapeValues()
     
     // d = (TargetWidthIn * CAMERA_X_RES) / (2 * TargetWidthPix * tan(1/2 * FOVAng))
     // d = (TargetHeightIn * CAMERA_Y_RES) / (2 * TargetHeightPix * tan(1/2 * FOVAng))
-    m_VisionTargetReport.m_CameraDistanceX = (TARGET_WIDTH_INCHES * m_pCurrentUsbCamera->X_RESOLUTION) /
+    m_VisionTargetReport.m_CameraDistanceX = (TARGET_WIDTH_INCHES * frameSize.width) /
                                              (2.0 * (m_VisionTargetReport.m_BoundingRectWidth) * tan(.5 * CAMERA_FOV_DEGREES * DEGREES_TO_RADIANS));
                                              //(2.0 * (m_VisionTargetReport.m_BoundingRectWidth) * tan(.5 * CALIBRATED_CAMERA_ANGLE * DEGREES_TO_RADIANS));
     
-    m_VisionTargetReport.m_CameraDistanceY = (TARGET_HEIGHT_INCHES * m_pCurrentUsbCamera->Y_RESOLUTION) /
+    m_VisionTargetReport.m_CameraDistanceY = (TARGET_HEIGHT_INCHES * frameSize.height) /
                                              (2.0 * (m_VisionTargetReport.m_BoundingRectHeight) * tan(.5 * CAMERA_FOV_DEGREES * DEGREES_TO_RADIANS));
                                              //(2.0 * (m_VisionTargetReport.m_BoundingRectHeight) * tan(.5 * CALIBRATED_CAMERA_ANGLE * DEGREES_TO_RADIANS));
 
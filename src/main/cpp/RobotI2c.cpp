@@ -10,13 +10,15 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 // SYSTEM INCLUDES
-// <none>
+#include <chrono>                               // for std::chrono
 
 // C INCLUDES
-// (none)
+#include "frc/RobotController.h"                // for GetFPGATime()
 
 // C++ INCLUDES
 #include "RobotI2c.hpp"                         // for class declaration
+#include "RobotThreads.hpp"                     // for ConfigureCurrentThread()
+#include "RobotTiming.hpp"                      // for JitterMonitor
 #include "RobotUtils.hpp"                       // for DisplayMessage()
 #include "YtaRobot.hpp"                         // for I2cSequence() declaration
 
@@ -24,14 +26,33 @@
 DigitalOutput           RobotI2c::m_DigitalOutputToRioduino(ROBORIO_SIGNAL_DIO_PIN);
 DigitalInput            RobotI2c::m_DigitalInputFromRioduino(RIODUINO_SIGNAL_DIO_PIN);
 I2cCommand              RobotI2c::m_I2cRioduinoCommand;
-I2cData                 RobotI2c::m_I2cRioduinoData;
+I2cDataFrame            RobotI2c::m_I2cRioduinoData;
+SeqLockSnapshot<GyroI2cData> RobotI2c::m_GyroSnapshot;
+SonarFilter             RobotI2c::m_SonarFilter;
+SeqLockSnapshot<SonarI2cData> RobotI2c::m_SonarSnapshot;
 I2C                     RobotI2c::m_I2cRioduino(I2C::Port::kMXP, RoborioRioduinoSharedData::I2C_DEVICE_ADDRESS);
+Bno055                  RobotI2c::m_Bno055(I2C::Port::kMXP, Bno055::DEFAULT_ADDRESS);
 bool                    RobotI2c::m_bI2cDataValid           = false;
 bool                    RobotI2c::m_bI2cCommandReady        = false;
 RobotI2c::ThreadPhase   RobotI2c::m_ThreadPhase             = TRIGGER_INTERRUPT;
 unsigned int            RobotI2c::m_ThreadUpdateRateMs      = DEFAULT_UPDATE_RATE_MS;
+unsigned int            RobotI2c::m_HandshakeTimeoutMs      = DEFAULT_HANDSHAKE_TIMEOUT_MS;
+std::atomic<bool>       RobotI2c::m_bThreadEnabled(false);
+std::mutex              RobotI2c::m_ThreadEnableMutex;
+std::condition_variable RobotI2c::m_ThreadEnableCondition;
 unsigned int            RobotI2c::m_NumValidTransactions    = 0U;
 unsigned int            RobotI2c::m_NumInvalidTransactions  = 0U;
+unsigned int            RobotI2c::m_NumRepeatedFrames       = 0U;
+unsigned int            RobotI2c::m_NumMissedFrames         = 0U;
+uint8_t                 RobotI2c::m_LastFrameSequence       = 0U;
+unsigned int            RobotI2c::m_LastSampleAgeMs         = 0U;
+bool                    RobotI2c::m_bFrameSequenceValid     = false;
+double                  RobotI2c::m_HandshakeStartTimestampS = 0.0;
+unsigned int            RobotI2c::m_NumHandshakes           = 0U;
+unsigned int            RobotI2c::m_NumHandshakeTimeouts    = 0U;
+unsigned int            RobotI2c::m_LastHandshakeLatencyUs  = 0U;
+unsigned int            RobotI2c::m_MaxHandshakeLatencyUs   = 0U;
+uint64_t                RobotI2c::m_TotalHandshakeLatencyUs = 0U;
 
 
 
@@ -39,11 +60,18 @@ unsigned int            RobotI2c::m_NumInvalidTransactions  = 0U;
 /// @method RobotI2c::ManualTrigger
 ///
 /// Function that will manually gather I2C data on demand from
-/// the RIOduino instead of using the main thread.
+/// the RIOduino instead of using the main thread.  The snapshot
+/// only allows one writer, so this does nothing while the I2C
+/// thread is enabled.
 ///
 ////////////////////////////////////////////////////////////////
 void RobotI2c::ManualTrigger()
 {
+    if (m_bThreadEnabled)
+    {
+        return;
+    }
+    
     enum I2cPhase
     {
         SEND_REQUEST,
@@ -76,8 +104,8 @@ void RobotI2c::ManualTrigger()
         
         // Request and process data
         //UpdateI2cData();
-        static_cast<void>(m_I2cRioduino.ReadOnly(8, reinterpret_cast<uint8_t *>(&m_I2cRioduinoData)));
-        //UnpackI2cData();
+        UpdateI2cData();
+        UnpackI2cData();
         
         phase = SEND_REQUEST;
     }
@@ -91,17 +119,219 @@ void RobotI2c::ManualTrigger()
 
 
 
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::SetThreadEnabled
+///
+/// Starts or stops the I2C thread's transactions with the
+/// RIOduino.  While stopped the thread sleeps on a condition
+/// variable instead of using any CPU.
+///
+////////////////////////////////////////////////////////////////
+void RobotI2c::SetThreadEnabled(bool bEnabled)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_ThreadEnableMutex);
+        m_bThreadEnabled = bEnabled;
+    }
+    m_ThreadEnableCondition.notify_one();
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::WaitForThreadEnabled
+///
+/// Blocks the I2C thread until it is enabled.
+///
+////////////////////////////////////////////////////////////////
+void RobotI2c::WaitForThreadEnabled()
+{
+    if (m_bThreadEnabled)
+    {
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(m_ThreadEnableMutex);
+    m_ThreadEnableCondition.wait(lock, []() { return m_bThreadEnabled.load(); });
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::WaitForRioduinoHandshake
+///
+/// Sleeps until the RIOduino raises its data ready signal or
+/// the handshake timeout expires.  The latency from the trigger
+/// to the data ready edge is recorded.
+///
+////////////////////////////////////////////////////////////////
+bool RobotI2c::WaitForRioduinoHandshake()
+{
+    static const double MS_PER_S = 1000.0;
+    static const double US_PER_S = 1000000.0;
+    
+    InterruptableSensorBase::WaitResult result = m_DigitalInputFromRioduino.WaitForInterrupt(m_HandshakeTimeoutMs / MS_PER_S, false);
+    
+    // A late edge from a previous timed out transaction may still be
+    // latched, so also make sure the signal is actually high now.
+    if (((result & InterruptableSensorBase::kRisingEdge) == 0) || !m_DigitalInputFromRioduino.Get())
+    {
+        m_NumHandshakeTimeouts++;
+        return false;
+    }
+    
+    double latencyS = m_DigitalInputFromRioduino.ReadRisingTimestamp() - m_HandshakeStartTimestampS;
+    if (latencyS < 0.0)
+    {
+        latencyS = 0.0;
+    }
+    
+    m_LastHandshakeLatencyUs = static_cast<unsigned>(latencyS * US_PER_S);
+    if (m_LastHandshakeLatencyUs > m_MaxHandshakeLatencyUs)
+    {
+        m_MaxHandshakeLatencyUs = m_LastHandshakeLatencyUs;
+    }
+    m_TotalHandshakeLatencyUs += m_LastHandshakeLatencyUs;
+    m_NumHandshakes++;
+    
+    return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::RunBno055
+///
+/// Reads the BNO055 wired to the roboRIO at a fixed rate and
+/// publishes the angles through the same snapshot the RIOduino
+/// data used, so nothing reading the gyro changes.  Commands
+/// that were meant for the RIOduino's BNO055 are handled here
+/// instead.  The RIOduino still has the sonar, so in between
+/// BNO055 reads its newest frame is read at the normal thread
+/// update rate.  It is streaming, so that is a single read that
+/// never waits on the RIOduino.  Until the roboRIO's BNO055
+/// answers, the RIOduino's gyro is used (and gets the gyro
+/// commands).  Initializing is only tried a few times, so a
+/// robot without the sensor wired just keeps the RIOduino gyro.
+///
+////////////////////////////////////////////////////////////////
+void RobotI2c::RunBno055()
+{
+    const std::chrono::milliseconds updatePeriod(BNO055_UPDATE_RATE_MS);
+    std::chrono::steady_clock::time_point nextUpdateTime = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point nextRioduinoReadTime = nextUpdateTime;
+    std::chrono::steady_clock::time_point nextInitializeTime = nextUpdateTime;
+    unsigned numInitializeAttempts = 0U;
+    RobotTiming::JitterMonitor jitterMonitor("I2C thread", updatePeriod);
+    
+    while (true)
+    {
+        // Go back to sleep if the thread was stopped.  A stopped
+        // thread isn't late, so the jitter measurement starts over.
+        if (!m_bThreadEnabled)
+        {
+            WaitForThreadEnabled();
+            jitterMonitor.Restart();
+        }
+        
+        jitterMonitor.Tick();
+        
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        if (!m_Bno055.IsInitialized() && (numInitializeAttempts < BNO055_MAX_INITIALIZE_ATTEMPTS) && (currentTime >= nextInitializeTime))
+        {
+            numInitializeAttempts++;
+            if (m_Bno055.Initialize())
+            {
+                RobotUtils::DisplayMessage("BNO055 initialized, using it for the gyro.");
+            }
+            else if (numInitializeAttempts == BNO055_MAX_INITIALIZE_ATTEMPTS)
+            {
+                RobotUtils::DisplayMessage("No BNO055 detected... check wiring!  Using the RIOduino gyro.");
+            }
+            else
+            {
+                nextInitializeTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(BNO055_RETRY_DELAY_MS);
+            }
+        }
+        
+        if (m_bI2cCommandReady)
+        {
+            if (m_Bno055.IsInitialized() && (m_I2cRioduinoCommand.m_CommandSelection == GYRO_READ_NEW_CENTER))
+            {
+                m_Bno055.RequestNewCenter();
+            }
+            else
+            {
+                SendI2cCommand();
+            }
+            m_bI2cCommandReady = false;
+        }
+        
+        if (m_Bno055.IsInitialized())
+        {
+            const uint64_t timestampUs = RobotController::GetFPGATime();
+            GyroI2cData gyroData;
+            if (m_Bno055.ReadAngles(gyroData))
+            {
+                m_NumValidTransactions++;
+                m_GyroSnapshot.Publish(gyroData, timestampUs);
+            }
+            else
+            {
+                m_NumInvalidTransactions++;
+                
+                if (DEBUG_I2C_TRANSACTIONS)
+                {
+                    RobotUtils::DisplayFormattedMessage("BNO055 read failed (%u total).\n", m_NumInvalidTransactions);
+                }
+            }
+        }
+        
+        // The sonar, and the gyro until the BNO055 is found
+        currentTime = std::chrono::steady_clock::now();
+        if (currentTime >= nextRioduinoReadTime)
+        {
+            UpdateI2cData();
+            UnpackI2cData();
+            nextRioduinoReadTime = currentTime + std::chrono::milliseconds(m_ThreadUpdateRateMs);
+        }
+        
+        // Keep a steady rate, but don't try to catch up after falling behind
+        nextUpdateTime += updatePeriod;
+        currentTime = std::chrono::steady_clock::now();
+        if (nextUpdateTime < currentTime)
+        {
+            nextUpdateTime = currentTime + updatePeriod;
+        }
+        std::this_thread::sleep_until(nextUpdateTime);
+    }
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 /// @method RobotI2c::I2cThread
 ///
-/// The main I2C thread on the robot.
+/// The main I2C thread on the robot.  The data ready signal
+/// from the RIOduino is an interrupt, so the thread is asleep
+/// for everything except the I2C transfers themselves.
+/// When the RIOduino is streaming there is no handshake at all,
+/// each pass is a single read of its newest frame.  If the gyro
+/// is the roboRIO's own BNO055, the BNO055 loop takes over the
+/// thread and reads the RIOduino itself (see RunBno055()).
 ///
 ////////////////////////////////////////////////////////////////
 void RobotI2c::I2cThread()
 {
-    // @todo: Port BNO055 driver from Arduino to roboRIO.
     RobotUtils::DisplayMessage("I2C thread detached.");
-    while (true) {}
+    RobotThreads::ConfigureCurrentThread(RobotThreads::I2C_THREAD);
+    
+    // Synchronous interrupts on the rising edge of the data ready signal
+    m_DigitalInputFromRioduino.RequestInterrupts();
+    m_DigitalInputFromRioduino.SetUpSourceEdge(true, false);
+    
+    // Sleep until the robot code starts the thread
+    WaitForThreadEnabled();
     
     // The RIOduino will have booted well before this.
     // Trigger both of its loop control variables to make
@@ -111,31 +341,55 @@ void RobotI2c::I2cThread()
     std::this_thread::sleep_for(std::chrono::milliseconds(INITIALIZING_DELAY_MS));
     m_DigitalOutputToRioduino.Set(false);
     
+    if (USE_ROBORIO_BNO055)
+    {
+        RunBno055();
+    }
+    
     while (true)
     {
         switch (m_ThreadPhase)
         {
             case TRIGGER_INTERRUPT:
             {
+                if (I2C_STREAMING_MODE)
+                {
+                    // The RIOduino always has a frame ready, just read it
+                    UpdateI2cData();
+                    UnpackI2cData();
+                    m_ThreadPhase = DELAY;
+                    break;
+                }
+                
                 // Trigger the interrupt
+                m_HandshakeStartTimestampS = Timer::GetFPGATimestamp();
                 m_DigitalOutputToRioduino.Set(true);
                 m_ThreadPhase = COLLECT_DATA;
                 break;
             }
             case COLLECT_DATA:
             {
-                // Wait for an indication the data is ready
-                if (m_DigitalInputFromRioduino.Get())
+                // Sleep until the data is ready
+                if (WaitForRioduinoHandshake())
                 {
                     // Get and process new I2C data
                     UpdateI2cData();
                     UnpackI2cData();
+                }
+                else
+                {
+                    m_NumInvalidTransactions++;
                     
-                    // Clear the interrupt trigger
-                    m_DigitalOutputToRioduino.Set(false);
-                    
-                    m_ThreadPhase = DELAY;
+                    if (DEBUG_I2C_TRANSACTIONS)
+                    {
+                        RobotUtils::DisplayFormattedMessage("I2C handshake timeout (%u total).\n", m_NumHandshakeTimeouts);
+                    }
                 }
+                
+                // Clear the interrupt trigger
+                m_DigitalOutputToRioduino.Set(false);
+                
+                m_ThreadPhase = DELAY;
                 break;
             }
             case SEND_COMMAND:
@@ -154,6 +408,9 @@ void RobotI2c::I2cThread()
                 // Relinquish the CPU
                 std::this_thread::sleep_for(std::chrono::milliseconds(m_ThreadUpdateRateMs));
                 
+                // Go back to sleep if the thread was stopped
+                WaitForThreadEnabled();
+                
                 // Check if a request to send a command came in (could be external to this thread)
                 if (m_bI2cCommandReady)
                 {
@@ -198,43 +455,80 @@ void RobotI2c::SendCommand(I2cCommandSelection command)
 
 
 
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::IsI2cFrameValid
+///
+/// Checks that the received frame is one this code understands
+/// and that it arrived intact.
+///
+////////////////////////////////////////////////////////////////
+bool RobotI2c::IsI2cFrameValid()
+{
+    if ((m_I2cRioduinoData.m_Header != I2C_HEADER_DATA) ||
+        (m_I2cRioduinoData.m_Version != I2C_PROTOCOL_VERSION) ||
+        (m_I2cRioduinoData.m_PayloadLength > I2cDataFrame::I2C_MAX_PAYLOAD_BYTES))
+    {
+        return false;
+    }
+    
+    // The length is known to be good, so the CRC position is too
+    return (m_I2cRioduinoData.m_Payloads[m_I2cRioduinoData.m_PayloadLength] == ComputeFrameCrc(m_I2cRioduinoData));
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 /// @method RobotI2c::UnpackI2cData
 ///
-/// Upacks received I2C data.
+/// Upacks received I2C data.  A frame can hold several payloads,
+/// each of which is unpacked and published separately, stamped
+/// with when the RIOduino sampled them.  A frame
+/// with the same sequence as the last one has no new data (the
+/// RIOduino didn't update it in time) and is ignored.
 ///
 ////////////////////////////////////////////////////////////////
 void RobotI2c::UnpackI2cData()
 {
     m_bI2cDataValid = false;
         
-    // Make sure a valid data packet was received
-    if ((m_I2cRioduinoData.m_Header == I2C_HEADER_DATA) &&
-        (m_I2cRioduinoData.m_Footer == I2C_FOOTER_DATA))
+    // Make sure a valid data frame was received
+    if (IsI2cFrameValid())
     {
-        // The unpacking action depends on what kind of data was sent
-        switch (m_I2cRioduinoData.m_DataSelection)
+        uint64_t timestampUs = RobotController::GetFPGATime();
+        const uint8_t sequence = m_I2cRioduinoData.m_Sequence;
+        
+        if (m_bFrameSequenceValid)
         {
-            // Currently only supporting gyro data
-            case I2cDataSelection::GYRO_DATA:
+            if (sequence == m_LastFrameSequence)
             {
-                // Read the angle
-                uint16_t * pRobotAngle = &m_I2cRioduinoData.m_DataBuffer.m_GyroData.m_xAxisInfo.m_Angle;
-                
-                // Make sure a valid angle came over
-                if (*pRobotAngle > RoborioRioduinoSharedData::GyroI2cData::MAX_VALID_ANGLE_VALUE)
-                {
-                    RobotUtils::DisplayMessage("Invalid angle received in I2C transfer.");
-                    *pRobotAngle = 0;
-                }
-                
-                break;
+                m_NumRepeatedFrames++;
+                return;
             }
-            default:
+            
+            // Wraps along with the eight bit sequence
+            m_NumMissedFrames += static_cast<uint8_t>(sequence - m_LastFrameSequence - 1U);
+        }
+        m_LastFrameSequence = sequence;
+        m_bFrameSequenceValid = true;
+        
+        // Walk the payloads
+        const uint8_t * pPayloads = &m_I2cRioduinoData.m_Payloads[0];
+        const unsigned payloadLength = m_I2cRioduinoData.m_PayloadLength;
+        unsigned offset = 0U;
+        while ((offset + I2cDataFrame::I2C_PAYLOAD_OVERHEAD_BYTES) <= payloadLength)
+        {
+            const I2cDataSelection selection = static_cast<I2cDataSelection>(pPayloads[offset]);
+            const uint8_t size = pPayloads[offset + 1U];
+            offset += I2cDataFrame::I2C_PAYLOAD_OVERHEAD_BYTES;
+            
+            // A size that runs off the end means the frame was built wrong
+            if ((offset + size) > payloadLength)
             {
-                // Do nothing in case a bad packet is received
                 break;
             }
+            
+            UnpackI2cPayload(selection, &pPayloads[offset], size, timestampUs);
+            offset += size;
         }
         
         m_NumValidTransactions++;
@@ -246,8 +540,14 @@ void RobotI2c::UnpackI2cData()
         
         if (DEBUG_I2C_TRANSACTIONS)
         {
-            RobotUtils::DisplayMessage("Invalid I2C metadata.");
+            RobotUtils::DisplayMessage("Invalid I2C frame.");
             RobotUtils::DisplayFormattedMessage("Transactions - Valid: %u, Invalid: %u\n", m_NumValidTransactions, m_NumInvalidTransactions);
+            RobotUtils::DisplayFormattedMessage("Frames - Repeated: %u, Missed: %u, Last age: %u ms\n", m_NumRepeatedFrames, m_NumMissedFrames, m_LastSampleAgeMs);
+            RobotUtils::DisplayFormattedMessage("Handshake - Timeouts: %u, Last: %u us, Max: %u us, Mean: %u us\n",
+                                                m_NumHandshakeTimeouts,
+                                                m_LastHandshakeLatencyUs,
+                                                m_MaxHandshakeLatencyUs,
+                                                (m_NumHandshakes > 0U) ? static_cast<unsigned>(m_TotalHandshakeLatencyUs / m_NumHandshakes) : 0U);
             RobotUtils::DisplayMessage("Dumping buffer...");
             
             uint8_t * pData = reinterpret_cast<uint8_t *>(&m_I2cRioduinoData);
@@ -259,3 +559,81 @@ void RobotI2c::UnpackI2cData()
         }
     }
 }
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::UnpackI2cPayload
+///
+/// Unpacks one payload and publishes it for the robot loop.
+/// Payloads of an unexpected size or unknown type are skipped.
+///
+////////////////////////////////////////////////////////////////
+void RobotI2c::UnpackI2cPayload(I2cDataSelection selection, const uint8_t * pPayload, uint8_t size, uint64_t & rTimestampUs)
+{
+    static const uint64_t US_PER_MS = 1000U;
+    
+    switch (selection)
+    {
+        case I2cDataSelection::SAMPLE_AGE_DATA:
+        {
+            if (size == sizeof(SampleAgeI2cData))
+            {
+                SampleAgeI2cData ageData;
+                std::memcpy(&ageData, pPayload, sizeof(ageData));
+                
+                // The age comes first, so the rest of the frame gets stamped with when it was sampled
+                m_LastSampleAgeMs = ageData.m_AgeMs;
+                const uint64_t ageUs = static_cast<uint64_t>(ageData.m_AgeMs) * US_PER_MS;
+                if (ageUs < rTimestampUs)
+                {
+                    rTimestampUs -= ageUs;
+                }
+            }
+            break;
+        }
+        case I2cDataSelection::SONAR_DATA:
+        {
+            if (size == sizeof(SonarI2cData))
+            {
+                SonarI2cData sonarData;
+                std::memcpy(&sonarData, pPayload, sizeof(sonarData));
+                
+                // Run the new readings through the filter and publish the result
+                const SonarI2cData filteredData = m_SonarFilter.Filter(sonarData);
+                m_SonarSnapshot.Publish(filteredData, rTimestampUs);
+            }
+            break;
+        }
+        case I2cDataSelection::GYRO_DATA:
+        {
+            if (size == sizeof(GyroI2cData))
+            {
+                GyroI2cData gyroData;
+                std::memcpy(&gyroData, pPayload, sizeof(gyroData));
+                
+                // Once the roboRIO's BNO055 is running it is the only gyro source
+                if (m_Bno055.IsInitialized())
+                {
+                    break;
+                }
+                
+                // Make sure a valid angle came over
+                const int16_t angle = gyroData.m_xAngle;
+                if ((angle > GyroI2cData::MAX_VALID_ANGLE_VALUE) || (angle < -GyroI2cData::MAX_VALID_ANGLE_VALUE))
+                {
+                    RobotUtils::DisplayMessage("Invalid angle received in I2C transfer.");
+                    break;
+                }
+                
+                m_GyroSnapshot.Publish(gyroData, rTimestampUs);
+            }
+            break;
+        }
+        default:
+        {
+            // Do nothing in case a newer RIOduino sends something unknown
+            break;
+        }
+    }
+}
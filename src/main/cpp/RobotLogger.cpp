@@ -0,0 +1,352 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotLogger.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for the binary match data logger.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <algorithm>                            // for std::min
+#include <cstring>                              // for memcpy, strlen
+#include <sys/stat.h>                           // for mkdir, stat
+#include <thread>                               // for std::thread
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "RobotLogger.hpp"                      // for class declaration
+#include "RobotThreads.hpp"                     // for ConfigureCurrentThread()
+
+// STATIC MEMBER DATA
+RobotLogger::Slot                       RobotLogger::m_Ring[RING_CAPACITY];
+std::atomic<uint32_t>                   RobotLogger::m_EnqueuePosition(0U);
+uint32_t                                RobotLogger::m_DequeuePosition          = 0U;
+std::atomic<uint32_t>                   RobotLogger::m_NextSequence(0U);
+std::atomic<uint32_t>                   RobotLogger::m_NextMessageId(0U);
+std::atomic<uint32_t>                   RobotLogger::m_NumDropped(0U);
+std::atomic<bool>                       RobotLogger::m_bRunning(false);
+std::chrono::steady_clock::time_point   RobotLogger::m_StartTime;
+std::FILE *                             RobotLogger::m_pLogFile                 = nullptr;
+uint64_t                                RobotLogger::m_LogFileBytesLeft         = 0U;
+RobotLogger::Record                     RobotLogger::m_DrainBuffer[DRAIN_BATCH_RECORDS];
+constexpr std::chrono::milliseconds     RobotLogger::DRAIN_PERIOD;
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::Initialize
+///
+/// Sets up the ring, opens a new log file and starts the drain
+/// thread.  Anything logged before this, or when there is no
+/// log file, is not kept.
+///
+////////////////////////////////////////////////////////////////
+void RobotLogger::Initialize()
+{
+    if (m_bRunning)
+    {
+        return;
+    }
+
+    // Each slot starts out free for the record at its own position
+    for (uint32_t i = 0U; i < RING_CAPACITY; i++)
+    {
+        m_Ring[i].m_Sequence.store(i, std::memory_order_relaxed);
+    }
+    m_EnqueuePosition.store(0U, std::memory_order_relaxed);
+    m_DequeuePosition = 0U;
+    m_StartTime = std::chrono::steady_clock::now();
+
+    m_pLogFile = OpenLogFile();
+    if (m_pLogFile == nullptr)
+    {
+        return;
+    }
+
+    std::thread drainThread(DrainThread);
+    drainThread.detach();
+
+    m_bRunning.store(true, std::memory_order_release);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::OpenLogFile
+///
+/// Opens the first unused log file name and writes the file
+/// header.  The sizes of the logs already there decide how big
+/// the new one can get.  Returns nullptr if there's nowhere to
+/// log or no room left, in which case nothing is logged.
+///
+////////////////////////////////////////////////////////////////
+std::FILE * RobotLogger::OpenLogFile()
+{
+    // It's fine if this already exists
+    static_cast<void>(mkdir(LOG_DIRECTORY, 0755));
+
+    char fileName[64];
+    char unusedFileName[64] = {};
+    uint64_t directoryBytes = 0U;
+    for (unsigned i = 0U; i < MAX_LOG_FILES; i++)
+    {
+        static_cast<void>(std::snprintf(fileName, sizeof(fileName), "%s/robot_%03u.ytalog", LOG_DIRECTORY, i));
+
+        struct stat fileInfo;
+        if (stat(fileName, &fileInfo) == 0)
+        {
+            directoryBytes += static_cast<uint64_t>(fileInfo.st_size);
+        }
+        else if (unusedFileName[0] == '\0')
+        {
+            std::memcpy(unusedFileName, fileName, sizeof(unusedFileName));
+        }
+        else
+        {
+        }
+    }
+
+    if (unusedFileName[0] == '\0')
+    {
+        std::printf("Every log file name is used, delete old logs to log again.\n");
+        return nullptr;
+    }
+
+    if (directoryBytes >= MAX_LOG_DIRECTORY_BYTES)
+    {
+        std::printf("The logs in %s are at the size limit, delete old logs to log again.\n", LOG_DIRECTORY);
+        return nullptr;
+    }
+
+    std::FILE * pFile = std::fopen(unusedFileName, "wb");
+    if (pFile == nullptr)
+    {
+        std::printf("Could not open a log file, nothing will be logged.\n");
+        return nullptr;
+    }
+
+    RobotLogRecords::FileHeader fileHeader;
+    std::memcpy(fileHeader.m_Magic, RobotLogRecords::LOG_MAGIC, sizeof(fileHeader.m_Magic));
+    fileHeader.m_Version = RobotLogRecords::LOG_VERSION;
+    fileHeader.m_RecordSize = RobotLogRecords::RECORD_SIZE_BYTES;
+    static_cast<void>(std::fwrite(&fileHeader, sizeof(fileHeader), 1U, pFile));
+
+    m_LogFileBytesLeft = std::min(MAX_LOG_FILE_BYTES, MAX_LOG_DIRECTORY_BYTES - directoryBytes);
+    std::printf("Logging to %s.\n", unusedFileName);
+    return pFile;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::FillHeader
+///
+/// Fills in the parts of a record header every record needs.
+///
+////////////////////////////////////////////////////////////////
+void RobotLogger::FillHeader(Record & rRecord, RobotLogRecords::RecordType type, uint8_t robotMode)
+{
+    const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - m_StartTime;
+
+    rRecord.m_Header.m_TimestampUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    rRecord.m_Header.m_Sequence = m_NextSequence.fetch_add(1U, std::memory_order_relaxed);
+    rRecord.m_Header.m_Type = type;
+    rRecord.m_Header.m_RobotMode = robotMode;
+    rRecord.m_Header.m_Length = 0U;
+    rRecord.m_Header.m_Flags = 0U;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::Push
+///
+/// Adds a record to the ring.  Each slot's sequence tells a
+/// writer whether the slot is free for its position, so writers
+/// only have to agree on the position (one compare and swap)
+/// and never wait on each other or the drain thread.
+///
+////////////////////////////////////////////////////////////////
+bool RobotLogger::Push(const Record & rRecord)
+{
+    uint32_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+    Slot * pSlot = nullptr;
+
+    while (true)
+    {
+        pSlot = &m_Ring[position & RING_INDEX_MASK];
+        const uint32_t sequence = pSlot->m_Sequence.load(std::memory_order_acquire);
+        const int32_t difference = static_cast<int32_t>(sequence - position);
+
+        if (difference == 0)
+        {
+            // Slot is free, try to claim it
+            if (m_EnqueuePosition.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The drain thread hasn't emptied this slot yet, the ring is full
+            m_NumDropped.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            // Another writer got here first
+            position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    pSlot->m_Record = rRecord;
+    pSlot->m_Sequence.store(position + 1U, std::memory_order_release);
+    return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::Pop
+///
+/// Takes the oldest record out of the ring and frees the slot
+/// for the writer one lap later.
+///
+////////////////////////////////////////////////////////////////
+bool RobotLogger::Pop(Record & rRecord)
+{
+    Slot & rSlot = m_Ring[m_DequeuePosition & RING_INDEX_MASK];
+    const uint32_t sequence = rSlot.m_Sequence.load(std::memory_order_acquire);
+
+    if (static_cast<int32_t>(sequence - (m_DequeuePosition + 1U)) < 0)
+    {
+        return false;
+    }
+
+    rRecord = rSlot.m_Record;
+    rSlot.m_Sequence.store(m_DequeuePosition + RING_CAPACITY, std::memory_order_release);
+    m_DequeuePosition++;
+    return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::LogLoop
+///
+/// Logs one loop record.
+///
+////////////////////////////////////////////////////////////////
+void RobotLogger::LogLoop(uint8_t robotMode, const RobotLogRecords::LoopData & rLoopData)
+{
+    if (!m_bRunning.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    Record record = {};
+    FillHeader(record, RobotLogRecords::RECORD_LOOP, robotMode);
+    record.m_Loop = rLoopData;
+    static_cast<void>(Push(record));
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::LogText
+///
+/// Logs a copy of a text message, it isn't printed here.
+/// Messages that don't fit in one record are split across
+/// several with the same message id, flagged as continuing.
+///
+////////////////////////////////////////////////////////////////
+void RobotLogger::LogText(const char * pText)
+{
+    if (!m_bRunning.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    const uint32_t messageId = m_NextMessageId.fetch_add(1U, std::memory_order_relaxed);
+    size_t remainingBytes = std::strlen(pText);
+    do
+    {
+        const size_t chunkBytes = (remainingBytes < RobotLogRecords::TEXT_RECORD_BYTES) ? remainingBytes : RobotLogRecords::TEXT_RECORD_BYTES;
+
+        Record record = {};
+        FillHeader(record, RobotLogRecords::RECORD_TEXT, RobotLogRecords::NO_ROBOT_MODE);
+        record.m_Header.m_Length = static_cast<uint8_t>(chunkBytes);
+        record.m_Text.m_MessageId = messageId;
+        std::memcpy(record.m_Text.m_Text, pText, chunkBytes);
+
+        pText += chunkBytes;
+        remainingBytes -= chunkBytes;
+        if (remainingBytes > 0U)
+        {
+            record.m_Header.m_Flags |= RobotLogRecords::TEXT_CONTINUES_FLAG;
+        }
+
+        static_cast<void>(Push(record));
+    }
+    while (remainingBytes > 0U);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotLogger::DrainThread
+///
+/// Runs at a lower priority than the robot code.  Each time it
+/// wakes up it empties the ring in batches and writes them to
+/// the log file.  When the file reaches its size limit it is
+/// closed and logging stops.
+///
+////////////////////////////////////////////////////////////////
+void RobotLogger::DrainThread()
+{
+    RobotThreads::ConfigureCurrentThread(RobotThreads::LOGGER_DRAIN);
+
+    uint32_t lastReportedDropped = 0U;
+
+    while (true)
+    {
+        std::this_thread::sleep_for(DRAIN_PERIOD);
+
+        unsigned numRecords = 0U;
+        do
+        {
+            numRecords = 0U;
+            while ((numRecords < DRAIN_BATCH_RECORDS) && Pop(m_DrainBuffer[numRecords]))
+            {
+                numRecords++;
+            }
+
+            const uint64_t batchBytes = static_cast<uint64_t>(numRecords) * sizeof(Record);
+            if (batchBytes > m_LogFileBytesLeft)
+            {
+                m_bRunning.store(false, std::memory_order_release);
+                std::fclose(m_pLogFile);
+                m_pLogFile = nullptr;
+                std::printf("The log file is at its size limit, nothing more will be logged.\n");
+                return;
+            }
+
+            static_cast<void>(std::fwrite(m_DrainBuffer, sizeof(Record), numRecords, m_pLogFile));
+            m_LogFileBytesLeft -= batchBytes;
+        }
+        while (numRecords == DRAIN_BATCH_RECORDS);
+
+        const uint32_t numDropped = m_NumDropped.load(std::memory_order_relaxed);
+        if (numDropped != lastReportedDropped)
+        {
+            std::printf("Logger dropped %u records.\n", static_cast<unsigned>(numDropped - lastReportedDropped));
+            lastReportedDropped = numDropped;
+        }
+
+        std::fflush(m_pLogFile);
+    }
+}
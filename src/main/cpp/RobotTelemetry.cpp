@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotTelemetry.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for publishing robot telemetry to the smart
+/// dashboard in batches.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cassert>                              // for assert
+#include <cmath>                                // for std::isnan
+#include <limits>                               // for quiet_NaN
+#include <memory>                               // for std::shared_ptr
+
+// C INCLUDES
+#include "networktables/NetworkTableInstance.h" // for nt::NetworkTableInstance
+
+// C++ INCLUDES
+#include "RobotTelemetry.hpp"                   // for class declaration
+#include "RobotUtils.hpp"                       // for ASSERT, DEBUG_PRINTS
+
+// STATIC MEMBER DATA
+nt::NetworkTableEntry                   RobotTelemetry::m_Entries[NUM_TELEMETRY_VALUES];
+std::atomic<double>                     RobotTelemetry::m_Values[NUM_TELEMETRY_VALUES];
+double                                  RobotTelemetry::m_FlushedValues[NUM_TELEMETRY_VALUES];
+std::atomic<RobotTelemetry::Verbosity>  RobotTelemetry::m_Verbosity(RobotUtils::DEBUG_PRINTS ? VERBOSITY_DEBUG : VERBOSITY_MATCH);
+std::atomic<bool>                       RobotTelemetry::m_bResendRequested(false);
+unsigned                                RobotTelemetry::m_FlushIntervalLoops    = DEFAULT_FLUSH_INTERVAL_LOOPS;
+unsigned                                RobotTelemetry::m_FlushLoopCount        = 0U;
+bool                                    RobotTelemetry::m_bInitialized          = false;
+const RobotTelemetry::ValueInfo         RobotTelemetry::VALUE_INFO[NUM_TELEMETRY_VALUES] =
+{
+    {"Heartbeat",                       VERBOSITY_MATCH,    NUMBER},
+    {"Gyro angle",                      VERBOSITY_MATCH,    NUMBER},
+    {"Auto step",                       VERBOSITY_MATCH,    NUMBER},
+    {"x-axis input",                    VERBOSITY_DEBUG,    NUMBER},
+    {"y-axis input",                    VERBOSITY_DEBUG,    NUMBER},
+    {"Left drive speed",                VERBOSITY_DEBUG,    NUMBER},
+    {"Right drive speed",               VERBOSITY_DEBUG,    NUMBER},
+    {"Left temperature (F)",            VERBOSITY_MATCH,    NUMBER},
+    {"Right temperature (F)",           VERBOSITY_MATCH,    NUMBER},
+    {"Raw left trigger",                VERBOSITY_DEBUG,    NUMBER},
+    {"Raw right trigger",               VERBOSITY_DEBUG,    NUMBER},
+    {"Normalized left trigger",         VERBOSITY_DEBUG,    NUMBER},
+    {"Normalized right trigger",        VERBOSITY_DEBUG,    NUMBER},
+    {"Enc. L: ",                        VERBOSITY_DEBUG,    NUMBER},
+    {"Enc. R: ",                        VERBOSITY_DEBUG,    NUMBER},
+    {"Enc Diff: ",                      VERBOSITY_DEBUG,    NUMBER},
+    {"Encoder drive setpoint (in)",     VERBOSITY_DEBUG,    NUMBER},
+    {"Odometry x (in)",                 VERBOSITY_MATCH,    NUMBER},
+    {"Odometry y (in)",                 VERBOSITY_MATCH,    NUMBER},
+    {"Odometry heading (deg)",          VERBOSITY_MATCH,    NUMBER},
+    {"Color sensor red",                VERBOSITY_DEBUG,    NUMBER},
+    {"Color sensor green",              VERBOSITY_DEBUG,    NUMBER},
+    {"Color sensor blue",               VERBOSITY_DEBUG,    NUMBER},
+    {"Color sensor IR distance",        VERBOSITY_DEBUG,    NUMBER},
+    {"Color sensor proximity",          VERBOSITY_DEBUG,    NUMBER},
+    {"Color sensor color",              VERBOSITY_DEBUG,    NUMBER},
+    {"Steering adjust",                 VERBOSITY_DEBUG,    NUMBER},
+    {"targetX",                         VERBOSITY_DEBUG,    NUMBER},
+    {"Integral sum",                    VERBOSITY_DEBUG,    NUMBER},
+    {"Target valid",                    VERBOSITY_MATCH,    NUMBER},
+    {"HeartBeat",                       VERBOSITY_MATCH,    NUMBER},
+    {"Bounding rect X",                 VERBOSITY_DEBUG,    NUMBER},
+    {"Bounding rect Y",                 VERBOSITY_DEBUG,    NUMBER},
+    {"Bounding rect width",             VERBOSITY_DEBUG,    NUMBER},
+    {"Bounding rect height",            VERBOSITY_DEBUG,    NUMBER},
+    {"Bounding rect area",              VERBOSITY_DEBUG,    NUMBER},
+    {"Bounding rect aspect ratio",      VERBOSITY_DEBUG,    NUMBER},
+    {"Contour area",                    VERBOSITY_DEBUG,    NUMBER},
+    {"Contour perimeter",               VERBOSITY_DEBUG,    NUMBER},
+    {"Contour convex hull area",        VERBOSITY_DEBUG,    NUMBER},
+    {"Contour solidity",                VERBOSITY_DEBUG,    NUMBER},
+    {"Contour vertices",                VERBOSITY_DEBUG,    NUMBER},
+    {"Area %",                          VERBOSITY_DEBUG,    NUMBER},
+    {"Trapezoid %",                     VERBOSITY_DEBUG,    NUMBER},
+    {"Camera distance, X",              VERBOSITY_DEBUG,    NUMBER},
+    {"Camera distance, Y",              VERBOSITY_DEBUG,    NUMBER},
+    {"Ground distance",                 VERBOSITY_MATCH,    NUMBER},
+    {"Target in range",                 VERBOSITY_MATCH,    NUMBER},
+    {"Target report valid",             VERBOSITY_MATCH,    NUMBER},
+    {"Vision latency (ms)",             VERBOSITY_MATCH,    NUMBER},
+    {"Vision frames dropped",           VERBOSITY_DEBUG,    NUMBER},
+    {"Vision tracking target",          VERBOSITY_MATCH,    BOOLEAN},
+    {"Shooter RPM",                     VERBOSITY_MATCH,    NUMBER},
+    {"Shooter target RPM",              VERBOSITY_DEBUG,    NUMBER},
+    {"Shooter at speed",                VERBOSITY_MATCH,    BOOLEAN},
+    {"Turret angle (deg)",              VERBOSITY_MATCH,    NUMBER},
+    {"Turret target angle (deg)",       VERBOSITY_DEBUG,    NUMBER},
+    {"Turret tracking",                 VERBOSITY_MATCH,    BOOLEAN},
+    {"Color wheel target color",        VERBOSITY_MATCH,    NUMBER},
+    {"Color wheel transitions",         VERBOSITY_DEBUG,    NUMBER},
+    {"Color wheel active",              VERBOSITY_MATCH,    BOOLEAN}
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTelemetry::Initialize
+///
+/// Looks up the smart dashboard entry for every value.  Values
+/// start out unset so nothing is sent until code records them.
+///
+////////////////////////////////////////////////////////////////
+void RobotTelemetry::Initialize()
+{
+    if (m_bInitialized)
+    {
+        return;
+    }
+
+    std::shared_ptr<nt::NetworkTable> pSmartDashboardTable = nt::NetworkTableInstance::GetDefault().GetTable("SmartDashboard");
+
+    for (unsigned i = 0U; i < NUM_TELEMETRY_VALUES; i++)
+    {
+        // Catches the name table falling out of sync with the enum
+        ASSERT(VALUE_INFO[i].m_pName != nullptr);
+
+        m_Entries[i] = pSmartDashboardTable->GetEntry(VALUE_INFO[i].m_pName);
+        m_Values[i].store(std::numeric_limits<double>::quiet_NaN(), std::memory_order_relaxed);
+    }
+
+    InvalidateFlushedValues();
+    m_bInitialized = true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTelemetry::InvalidateFlushedValues
+///
+/// Forgets what was last sent.  NaN never compares equal, so
+/// every value that has been set goes out on the next flush.
+///
+////////////////////////////////////////////////////////////////
+void RobotTelemetry::InvalidateFlushedValues()
+{
+    for (unsigned i = 0U; i < NUM_TELEMETRY_VALUES; i++)
+    {
+        m_FlushedValues[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTelemetry::Flush
+///
+/// Sends every enabled value that changed since the last flush.
+/// Only runs every few loops so the network traffic and the
+/// cost to the robot loop stay low.
+///
+////////////////////////////////////////////////////////////////
+void RobotTelemetry::Flush()
+{
+    if (!m_bInitialized)
+    {
+        return;
+    }
+
+    m_FlushLoopCount++;
+    if (m_FlushLoopCount < m_FlushIntervalLoops)
+    {
+        return;
+    }
+    m_FlushLoopCount = 0U;
+
+    if (m_bResendRequested.exchange(false))
+    {
+        InvalidateFlushedValues();
+    }
+
+    const Verbosity verbosity = m_Verbosity;
+    if (verbosity == VERBOSITY_OFF)
+    {
+        return;
+    }
+
+    for (unsigned i = 0U; i < NUM_TELEMETRY_VALUES; i++)
+    {
+        const ValueInfo & rInfo = VALUE_INFO[i];
+        if (rInfo.m_Verbosity > verbosity)
+        {
+            continue;
+        }
+
+        // Skip values that were never set or haven't changed
+        const double value = m_Values[i].load(std::memory_order_relaxed);
+        if (std::isnan(value) || (value == m_FlushedValues[i]))
+        {
+            continue;
+        }
+
+        switch (rInfo.m_Type)
+        {
+            case NUMBER:
+            {
+                m_Entries[i].SetDouble(value);
+                break;
+            }
+            case BOOLEAN:
+            {
+                m_Entries[i].SetBoolean(value != 0.0);
+                break;
+            }
+            default:
+            {
+                // Should never happen
+                ASSERT(false);
+                break;
+            }
+        }
+
+        m_FlushedValues[i] = value;
+    }
+}
@@ -45,6 +45,8 @@ void YtaRobot::TestPeriodic()
 {
     // Log a mode change if one occurred
     CheckAndUpdateRobotMode(ROBOT_MODE_TEST);
+    
+    UpdateControllerInputs();
 
     //AutonomousTestCode();
     TeleopTestCode();
@@ -101,7 +103,7 @@ void YtaRobot::TeleopTestCode()
     RobotUtils::DisplayFormattedMessage("x: %f, y: %f, z: %f\n", x, y, z);
 
     // Sample code for testing the detect trigger change code
-    TriggerChangeValues testValues(m_pControlJoystick, 10);
+    TriggerChangeValues testValues(&m_ControlInputs, 10);
     if ( testValues.DetectChange() )
     {
         RobotUtils::DisplayMessage("Trigger change detected!");
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotThreads.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for configuring how the robot's threads are
+/// scheduled.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <pthread.h>                            // for pthread_setname_np, pthread_setaffinity_np
+#include <sched.h>                              // for cpu_set_t
+#include <sys/resource.h>                       // for setpriority
+#include <sys/syscall.h>                        // for SYS_gettid
+#include <unistd.h>                             // for syscall
+
+// C INCLUDES
+#include "frc/Threads.h"                        // for SetCurrentThreadPriority()
+
+// C++ INCLUDES
+#include "RobotThreads.hpp"                     // for class declaration
+#include "RobotUtils.hpp"                       // for DisplayFormattedMessage()
+
+using namespace frc;
+
+// STATIC MEMBER DATA
+const RobotThreads::ThreadConfig RobotThreads::THREAD_CONFIGS[NUM_THREADS] =
+{
+    // The main thread keeps its name, the deploy tools find the robot program by it
+    // Name                 Real time   Priority    Core
+    {nullptr,               true,       15,         ANY_CORE},      // ROBOT_LOOP
+    {"I2cThread",           true,       14,         ANY_CORE},      // I2C_THREAD
+    {"CameraThread",        false,      0,          VISION_CORE},   // CAMERA_THREAD
+    {"VisionThreshold",     false,      0,          VISION_CORE},   // VISION_THRESHOLD_STAGE
+    {"VisionContour",       false,      0,          VISION_CORE},   // VISION_CONTOUR_STAGE
+    {"LoggerDrain",         false,      10,         ANY_CORE}       // LOGGER_DRAIN
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotThreads::ConfigureCurrentThread
+///
+/// Names the calling thread, sets its scheduling policy and
+/// priority, and pins it to its core.  Each step that fails is
+/// reported and skipped, the thread still runs either way.
+///
+////////////////////////////////////////////////////////////////
+void RobotThreads::ConfigureCurrentThread(ThreadId thread)
+{
+    const ThreadConfig & rConfig = THREAD_CONFIGS[thread];
+    const char * pDisplayName = (rConfig.m_pName != nullptr) ? rConfig.m_pName : "Robot loop";
+
+    if (rConfig.m_pName != nullptr)
+    {
+        if (pthread_setname_np(pthread_self(), rConfig.m_pName) != 0)
+        {
+            RobotUtils::DisplayFormattedMessage("Couldn't name the %s thread.\n", pDisplayName);
+        }
+    }
+
+    // Threads inherit the policy of the thread that created them,
+    // so normal threads are set back to normal explicitly
+    if (!SetCurrentThreadPriority(rConfig.m_bRealTime, rConfig.m_bRealTime ? rConfig.m_Priority : 0))
+    {
+        RobotUtils::DisplayFormattedMessage("Couldn't set the %s thread priority.\n", pDisplayName);
+    }
+
+    // Linux nice values are per thread
+    if (!rConfig.m_bRealTime && (rConfig.m_Priority != 0))
+    {
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), rConfig.m_Priority) != 0)
+        {
+            RobotUtils::DisplayFormattedMessage("Couldn't set the %s thread nice value.\n", pDisplayName);
+        }
+    }
+
+    if (rConfig.m_Core != ANY_CORE)
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(rConfig.m_Core, &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+        {
+            RobotUtils::DisplayFormattedMessage("Couldn't pin the %s thread to core %d.\n", pDisplayName, rConfig.m_Core);
+        }
+    }
+}
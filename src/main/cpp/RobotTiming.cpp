@@ -0,0 +1,353 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotTiming.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for measuring how long the robot periodic
+/// functions and sequences take to execute.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <algorithm>                            // for nth_element, std::max
+#include <cstring>                              // for memset
+#include <ctime>                                // for clock_gettime
+#include <string>                               // for std::string
+
+// C INCLUDES
+#include "frc/smartdashboard/SmartDashboard.h"  // for interacting with the smart dashboard
+
+// C++ INCLUDES
+#include "RobotTiming.hpp"                      // for class declaration
+#include "RobotUtils.hpp"                       // for DisplayFormattedMessage()
+
+using namespace frc;
+
+// STATIC MEMBER DATA
+RobotTiming::SectionStatistics  RobotTiming::m_SectionStatistics[NUM_TIMED_SECTIONS];
+uint32_t                        RobotTiming::m_ScratchSamples[SAMPLE_WINDOW_SIZE];
+unsigned                        RobotTiming::m_PublishLoopCount     = 0U;
+unsigned                        RobotTiming::m_NextPublishSection   = 0U;
+RobotTiming::TimedSection       RobotTiming::m_LastOverrunSection   = TELEOP_LOOP;
+const char * const              RobotTiming::SECTION_NAMES[NUM_TIMED_SECTIONS] =
+{
+    "TeleopPeriodic",
+    "DriveControlSequence",
+    "IntakeSequence",
+    "TurretSequence",
+    "ShooterSequence",
+    "ColorSequence",
+    "PneumaticSequence",
+    "HangSequence"
+};
+const RobotTiming::DashboardKeys RobotTiming::DASHBOARD_KEYS;
+constexpr std::chrono::milliseconds RobotTiming::ThreadCpuMonitor::REPORT_PERIOD;
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::FindSlowestSequence
+///
+/// Looks at the most recent sample from each sequence and
+/// returns the one that took the longest.
+///
+////////////////////////////////////////////////////////////////
+RobotTiming::TimedSection RobotTiming::FindSlowestSequence()
+{
+    TimedSection slowestSection = TELEOP_LOOP;
+    uint32_t slowestTimeUs = 0U;
+
+    // Skip the loop itself, it's always the slowest
+    for (unsigned section = TELEOP_LOOP + 1U; section < NUM_TIMED_SECTIONS; section++)
+    {
+        if (m_SectionStatistics[section].m_LastSampleUs > slowestTimeUs)
+        {
+            slowestTimeUs = m_SectionStatistics[section].m_LastSampleUs;
+            slowestSection = static_cast<TimedSection>(section);
+        }
+    }
+
+    return slowestSection;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::DashboardKeys::DashboardKeys
+///
+/// Builds the smart dashboard key of each statistic for every
+/// section from the section names.
+///
+////////////////////////////////////////////////////////////////
+RobotTiming::DashboardKeys::DashboardKeys()
+{
+    for (unsigned i = 0U; i < NUM_TIMED_SECTIONS; i++)
+    {
+        const std::string sectionName(SECTION_NAMES[i]);
+        m_MinKeys[i] = sectionName + " min (ms)";
+        m_MeanKeys[i] = sectionName + " mean (ms)";
+        m_MaxKeys[i] = sectionName + " max (ms)";
+        m_P99Keys[i] = sectionName + " p99 (ms)";
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::PublishSummary
+///
+/// Computes min/mean/max/p99 over the sample window and sends
+/// them to the smart dashboard.  Only one section is published
+/// per call, and only every few loops, to keep the network
+/// traffic and the statistics cost down.
+///
+////////////////////////////////////////////////////////////////
+void RobotTiming::PublishSummary()
+{
+    m_PublishLoopCount++;
+    if (m_PublishLoopCount < PUBLISH_INTERVAL_LOOPS)
+    {
+        return;
+    }
+    m_PublishLoopCount = 0U;
+
+    const SectionStatistics & rStatistics = m_SectionStatistics[m_NextPublishSection];
+    const unsigned numSamples = rStatistics.m_NumWindowSamples;
+    const unsigned section = m_NextPublishSection;
+    m_NextPublishSection = (m_NextPublishSection + 1U) % NUM_TIMED_SECTIONS;
+
+    if (numSamples == 0U)
+    {
+        return;
+    }
+
+    uint32_t minUs = rStatistics.m_Samples[0];
+    uint32_t maxUs = rStatistics.m_Samples[0];
+    uint64_t sumUs = 0U;
+    for (unsigned i = 0U; i < numSamples; i++)
+    {
+        const uint32_t sampleUs = rStatistics.m_Samples[i];
+        minUs = std::min(minUs, sampleUs);
+        maxUs = std::max(maxUs, sampleUs);
+        sumUs += sampleUs;
+        m_ScratchSamples[i] = sampleUs;
+    }
+
+    // Partial sort a copy so the window order is preserved
+    const unsigned p99Index = (numSamples * 99U) / 100U;
+    std::nth_element(&m_ScratchSamples[0], &m_ScratchSamples[p99Index], &m_ScratchSamples[numSamples]);
+
+    static const double US_PER_MS = 1000.0;
+    SmartDashboard::PutNumber(DASHBOARD_KEYS.m_MinKeys[section], minUs / US_PER_MS);
+    SmartDashboard::PutNumber(DASHBOARD_KEYS.m_MeanKeys[section], (static_cast<double>(sumUs) / numSamples) / US_PER_MS);
+    SmartDashboard::PutNumber(DASHBOARD_KEYS.m_MaxKeys[section], maxUs / US_PER_MS);
+    SmartDashboard::PutNumber(DASHBOARD_KEYS.m_P99Keys[section], m_ScratchSamples[p99Index] / US_PER_MS);
+
+    if (&rStatistics == &m_SectionStatistics[TELEOP_LOOP])
+    {
+        SmartDashboard::PutNumber("Loop overruns", rStatistics.m_NumOverruns);
+        SmartDashboard::PutString("Last overrun cause", SECTION_NAMES[m_LastOverrunSection]);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::DisplayHistograms
+///
+/// Prints the histogram of every section that has samples.  The
+/// histograms cover everything since the last reset, not just
+/// the sample window.
+///
+////////////////////////////////////////////////////////////////
+void RobotTiming::DisplayHistograms()
+{
+    for (unsigned section = 0U; section < NUM_TIMED_SECTIONS; section++)
+    {
+        const SectionStatistics & rStatistics = m_SectionStatistics[section];
+        if (rStatistics.m_TotalSamples == 0U)
+        {
+            continue;
+        }
+
+        unsigned largestBucketCount = 0U;
+        for (unsigned bucket = 0U; bucket < NUM_HISTOGRAM_BUCKETS; bucket++)
+        {
+            largestBucketCount = std::max(largestBucketCount, rStatistics.m_Histogram[bucket]);
+        }
+
+        RobotUtils::DisplayFormattedMessage("%s: %u samples, %u over %u us\n",
+                                            SECTION_NAMES[section],
+                                            rStatistics.m_TotalSamples,
+                                            rStatistics.m_NumOverruns,
+                                            LOOP_BUDGET_US);
+
+        for (unsigned bucket = 0U; bucket < NUM_HISTOGRAM_BUCKETS; bucket++)
+        {
+            const unsigned count = rStatistics.m_Histogram[bucket];
+            if (count == 0U)
+            {
+                continue;
+            }
+
+            char bar[HISTOGRAM_BAR_MAX_WIDTH + 1U];
+            const unsigned barWidth = std::max(1U, (count * HISTOGRAM_BAR_MAX_WIDTH) / largestBucketCount);
+            std::memset(bar, '#', barWidth);
+            bar[barWidth] = '\0';
+
+            if (bucket == (NUM_HISTOGRAM_BUCKETS - 1U))
+            {
+                RobotUtils::DisplayFormattedMessage("  >=%5u us %8u %s\n", bucket * HISTOGRAM_BUCKET_WIDTH_US, count, bar);
+            }
+            else
+            {
+                RobotUtils::DisplayFormattedMessage("  <%6u us %8u %s\n", (bucket + 1U) * HISTOGRAM_BUCKET_WIDTH_US, count, bar);
+            }
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::ResetStatistics
+///
+/// Clears all recorded samples and histograms.
+///
+////////////////////////////////////////////////////////////////
+void RobotTiming::ResetStatistics()
+{
+    std::memset(&m_SectionStatistics, 0, sizeof(m_SectionStatistics));
+    m_PublishLoopCount = 0U;
+    m_NextPublishSection = 0U;
+    m_LastOverrunSection = TELEOP_LOOP;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::ThreadCpuMonitor::ThreadCpuMonitor
+///
+/// Constructor for a ThreadCpuMonitor object.
+///
+////////////////////////////////////////////////////////////////
+RobotTiming::ThreadCpuMonitor::ThreadCpuMonitor(const char * pThreadName) :
+    m_DashboardKey(std::string(pThreadName) + " CPU %"),
+    m_LastCpuTimeNs(GetThreadCpuTimeNs()),
+    m_LastReportTime(std::chrono::steady_clock::now())
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::ThreadCpuMonitor::GetThreadCpuTimeNs
+///
+/// Returns the CPU time consumed by the calling thread.
+///
+////////////////////////////////////////////////////////////////
+uint64_t RobotTiming::ThreadCpuMonitor::GetThreadCpuTimeNs()
+{
+    static const uint64_t NS_PER_S = 1000000000U;
+
+    timespec cpuTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) != 0)
+    {
+        return 0U;
+    }
+
+    return (static_cast<uint64_t>(cpuTime.tv_sec) * NS_PER_S) + static_cast<uint64_t>(cpuTime.tv_nsec);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::ThreadCpuMonitor::Update
+///
+/// Publishes the percentage of one core the thread used since
+/// the last report, once a report period has gone by.
+///
+////////////////////////////////////////////////////////////////
+void RobotTiming::ThreadCpuMonitor::Update()
+{
+    const std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+    const std::chrono::nanoseconds elapsedTime = currentTime - m_LastReportTime;
+    if (elapsedTime < REPORT_PERIOD)
+    {
+        return;
+    }
+
+    const uint64_t currentCpuTimeNs = GetThreadCpuTimeNs();
+    const double cpuPercent = (100.0 * (currentCpuTimeNs - m_LastCpuTimeNs)) / elapsedTime.count();
+    SmartDashboard::PutNumber(m_DashboardKey, cpuPercent);
+
+    m_LastCpuTimeNs = currentCpuTimeNs;
+    m_LastReportTime = currentTime;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::JitterMonitor::JitterMonitor
+///
+/// Constructor for a JitterMonitor object.
+///
+////////////////////////////////////////////////////////////////
+RobotTiming::JitterMonitor::JitterMonitor(const char * pLoopName, std::chrono::microseconds expectedPeriod) :
+    m_MaxDashboardKey(std::string(pLoopName) + " jitter max (ms)"),
+    m_MeanDashboardKey(std::string(pLoopName) + " jitter mean (ms)"),
+    m_ExpectedPeriod(expectedPeriod),
+    m_LastTickTime(),
+    m_LastReportTime(),
+    m_MaxJitter(0),
+    m_TotalJitter(0),
+    m_NumPeriods(0U),
+    m_bStarted(false)
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::JitterMonitor::Tick
+///
+/// Compares the time since the last tick to the expected
+/// period.  Early and late both count, since either one means
+/// the loop didn't run when it should have.  The first tick
+/// only starts the measurement.
+///
+////////////////////////////////////////////////////////////////
+void RobotTiming::JitterMonitor::Tick()
+{
+    const std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+    if (!m_bStarted)
+    {
+        m_LastTickTime = currentTime;
+        m_LastReportTime = currentTime;
+        m_bStarted = true;
+        return;
+    }
+
+    const std::chrono::microseconds period = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - m_LastTickTime);
+    const std::chrono::microseconds jitter = (period > m_ExpectedPeriod) ? (period - m_ExpectedPeriod) : (m_ExpectedPeriod - period);
+    m_LastTickTime = currentTime;
+
+    m_MaxJitter = std::max(m_MaxJitter, jitter);
+    m_TotalJitter += jitter;
+    m_NumPeriods++;
+
+    if ((currentTime - m_LastReportTime) < ThreadCpuMonitor::REPORT_PERIOD)
+    {
+        return;
+    }
+
+    static const double US_PER_MS = 1000.0;
+    SmartDashboard::PutNumber(m_MaxDashboardKey, m_MaxJitter.count() / US_PER_MS);
+    SmartDashboard::PutNumber(m_MeanDashboardKey, (m_TotalJitter.count() / US_PER_MS) / m_NumPeriods);
+
+    m_MaxJitter = std::chrono::microseconds(0);
+    m_TotalJitter = std::chrono::microseconds(0);
+    m_NumPeriods = 0U;
+    m_LastReportTime = currentTime;
+}
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   SonarFilter.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for filtering the sonar readings from the
+/// RIOduino.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cstring>                      // for memcpy
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "SonarFilter.hpp"              // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SonarFilter::SonarFilter
+///
+/// Constructor.
+///
+////////////////////////////////////////////////////////////////
+SonarFilter::SonarFilter() :
+    m_Windows(),
+    m_NumRejected(0U)
+{
+    Reset();
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SonarFilter::Reset
+///
+/// Empties every sensor's window.
+///
+////////////////////////////////////////////////////////////////
+void SonarFilter::Reset()
+{
+    for (unsigned i = 0U; i < NUM_SENSORS; i++)
+    {
+        m_Windows[i].m_NumSamples = 0U;
+        m_Windows[i].m_NextSample = 0U;
+        m_Windows[i].m_NumRejectedInRow = 0U;
+        m_Windows[i].m_Median = 0U;
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SonarFilter::Filter
+///
+/// Runs each of the eight readings through its sensor's window.
+/// The sonar structure is just eight bytes, so it's treated as
+/// an array of readings.
+///
+////////////////////////////////////////////////////////////////
+SonarI2cData SonarFilter::Filter(const SonarI2cData & rRawData)
+{
+    uint8_t rawSamples[NUM_SENSORS];
+    std::memcpy(&rawSamples[0], &rRawData, sizeof(rawSamples));
+
+    uint8_t filteredSamples[NUM_SENSORS];
+    for (unsigned i = 0U; i < NUM_SENSORS; i++)
+    {
+        AddSample(m_Windows[i], rawSamples[i]);
+        filteredSamples[i] = m_Windows[i].m_Median;
+    }
+
+    SonarI2cData filteredData;
+    std::memcpy(&filteredData, &filteredSamples[0], sizeof(filteredData));
+    return filteredData;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SonarFilter::AddSample
+///
+/// Adds a reading to a window, unless it looks like an outlier.
+/// When the outliers keep coming the window is started over
+/// from the new reading so the filter follows a real change
+/// right away instead of blending old and new distances.
+///
+////////////////////////////////////////////////////////////////
+void SonarFilter::AddSample(SensorWindow & rWindow, uint8_t sample)
+{
+    if (rWindow.m_NumSamples > 0U)
+    {
+        const int difference = static_cast<int>(sample) - static_cast<int>(rWindow.m_Median);
+        const unsigned distance = static_cast<unsigned>((difference < 0) ? -difference : difference);
+
+        if (distance > OUTLIER_DISTANCE_INCHES)
+        {
+            m_NumRejected++;
+            rWindow.m_NumRejectedInRow++;
+            if (rWindow.m_NumRejectedInRow <= MAX_REJECTED_IN_ROW)
+            {
+                return;
+            }
+
+            // Too many in a row, the distance really changed
+            rWindow.m_NumSamples = 0U;
+            rWindow.m_NextSample = 0U;
+        }
+    }
+
+    rWindow.m_NumRejectedInRow = 0U;
+    rWindow.m_Samples[rWindow.m_NextSample] = sample;
+    rWindow.m_NextSample = (rWindow.m_NextSample + 1U) % WINDOW_SIZE;
+    if (rWindow.m_NumSamples < WINDOW_SIZE)
+    {
+        rWindow.m_NumSamples++;
+    }
+
+    rWindow.m_Median = GetMedian(rWindow);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SonarFilter::GetMedian
+///
+/// Sorts a copy of the window's readings and takes the middle
+/// one.  The window is only a few readings, so a simple
+/// insertion sort is all that's needed.  Before the window
+/// fills, the samples are always at the front of the buffer.
+///
+////////////////////////////////////////////////////////////////
+uint8_t SonarFilter::GetMedian(const SensorWindow & rWindow)
+{
+    uint8_t sorted[WINDOW_SIZE];
+    for (unsigned i = 0U; i < rWindow.m_NumSamples; i++)
+    {
+        const uint8_t sample = rWindow.m_Samples[i];
+        unsigned j = i;
+        while ((j > 0U) && (sorted[j - 1U] > sample))
+        {
+            sorted[j] = sorted[j - 1U];
+            j--;
+        }
+        sorted[j] = sample;
+    }
+
+    return sorted[rWindow.m_NumSamples / 2U];
+}
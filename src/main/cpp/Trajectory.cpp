@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   Trajectory.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for a precomputed trajectory loaded from the
+/// deploy directory.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                        // for std::abs
+#include <cstdio>                       // for file I/O
+#include <cstring>                      // for memcmp
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "RobotUtils.hpp"               // for DisplayFormattedMessage()
+#include "Trajectory.hpp"               // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Trajectory::Load
+///
+/// Reads a whole trajectory file into the table.  The file has
+/// to be from this version of the generator, with points spaced
+/// the same as the robot loop.  Anything wrong leaves the
+/// trajectory empty so autonomous can skip it.
+///
+////////////////////////////////////////////////////////////////
+bool Trajectory::Load(const char * pFileName, double periodS)
+{
+    m_NumPoints = 0U;
+
+    std::FILE * pFile = std::fopen(pFileName, "rb");
+    if (pFile == nullptr)
+    {
+        RobotUtils::DisplayFormattedMessage("Trajectory %s not found.\n", pFileName);
+        return false;
+    }
+
+    FileHeader header;
+    bool bHeaderValid = (std::fread(&header, sizeof(header), 1, pFile) == 1U);
+    bHeaderValid = bHeaderValid
+                && (std::memcmp(header.m_Magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC)) == 0)
+                && (header.m_Version == TRAJECTORY_VERSION)
+                && (header.m_PointSize == sizeof(Point))
+                && (header.m_NumPoints > 0U)
+                && (header.m_NumPoints <= MAX_POINTS)
+                && (std::abs(header.m_PeriodS - periodS) < 0.0001);
+    if (!bHeaderValid)
+    {
+        RobotUtils::DisplayFormattedMessage("Trajectory %s has a bad header.\n", pFileName);
+        std::fclose(pFile);
+        return false;
+    }
+
+    if (std::fread(&m_Points[0], sizeof(Point), header.m_NumPoints, pFile) != header.m_NumPoints)
+    {
+        RobotUtils::DisplayFormattedMessage("Trajectory %s is truncated.\n", pFileName);
+        std::fclose(pFile);
+        return false;
+    }
+
+    std::fclose(pFile);
+    m_NumPoints = header.m_NumPoints;
+    return true;
+}
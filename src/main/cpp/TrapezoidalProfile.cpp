@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   TrapezoidalProfile.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for a precomputed trapezoidal motion profile.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                        // for std::sqrt, std::ceil
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "TrapezoidalProfile.hpp"       // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method TrapezoidalProfile::Generate
+///
+/// Fills the setpoint table for a move of some distance.  The
+/// move accelerates at the limit up to the cruise velocity,
+/// holds it, then decelerates to stop right at the distance.
+/// If there isn't room to reach the cruise velocity, the peak
+/// is wherever the acceleration and deceleration meet.  Units
+/// are up to the caller, they only need to agree.  If the move
+/// will not fit in the table, the profile is left holding at
+/// the start.
+///
+////////////////////////////////////////////////////////////////
+bool TrapezoidalProfile::Generate(double distance, double maxVelocity, double maxAcceleration, double periodS)
+{
+    // Start out as a move that goes nowhere
+    m_Setpoints[0] = {0.0F, 0.0F, 0.0F};
+    m_NumSetpoints = 1U;
+
+    if ((distance <= 0.0) || (maxVelocity <= 0.0) || (maxAcceleration <= 0.0) || (periodS <= 0.0))
+    {
+        return (distance == 0.0);
+    }
+
+    // Assume cruise velocity is reached, then check
+    double peakVelocity = maxVelocity;
+    double accelTimeS = peakVelocity / maxAcceleration;
+    double accelDistance = 0.5 * maxAcceleration * accelTimeS * accelTimeS;
+    if ((2.0 * accelDistance) > distance)
+    {
+        // Triangle, the halfway point is where velocity peaks
+        peakVelocity = std::sqrt(distance * maxAcceleration);
+        accelTimeS = peakVelocity / maxAcceleration;
+        accelDistance = 0.5 * distance;
+    }
+    const double cruiseTimeS = (distance - (2.0 * accelDistance)) / peakVelocity;
+    const double totalTimeS = (2.0 * accelTimeS) + cruiseTimeS;
+
+    // One extra setpoint so the table ends resting at the distance
+    const unsigned numSetpoints = static_cast<unsigned>(std::ceil(totalTimeS / periodS)) + 1U;
+    if (numSetpoints > MAX_SETPOINTS)
+    {
+        return false;
+    }
+
+    for (unsigned i = 0U; i < numSetpoints; i++)
+    {
+        const double timeS = i * periodS;
+        double position = distance;
+        double velocity = 0.0;
+        double acceleration = 0.0;
+
+        if (timeS < accelTimeS)
+        {
+            position = 0.5 * maxAcceleration * timeS * timeS;
+            velocity = maxAcceleration * timeS;
+            acceleration = maxAcceleration;
+        }
+        else if (timeS < (accelTimeS + cruiseTimeS))
+        {
+            position = accelDistance + (peakVelocity * (timeS - accelTimeS));
+            velocity = peakVelocity;
+        }
+        else if (timeS < totalTimeS)
+        {
+            const double remainingTimeS = totalTimeS - timeS;
+            position = distance - (0.5 * maxAcceleration * remainingTimeS * remainingTimeS);
+            velocity = maxAcceleration * remainingTimeS;
+            acceleration = -maxAcceleration;
+        }
+        else
+        {
+        }
+
+        m_Setpoints[i] = {static_cast<float>(position), static_cast<float>(velocity), static_cast<float>(acceleration)};
+    }
+
+    m_NumSetpoints = numSetpoints;
+    return true;
+}
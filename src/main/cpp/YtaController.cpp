@@ -13,11 +13,12 @@
 // <none>
 
 // C INCLUDES
-#include "frc/smartdashboard/SmartDashboard.h"  // for interacting with the smart dashboard
+// (none)
 
 // C++ INCLUDES
 #include "YtaController.hpp"                    // for class declaration
-#include "RobotUtils.hpp"                       // for ASSERT, DEBUG_PRINTS
+#include "RobotTelemetry.hpp"                   // for publishing telemetry
+#include "RobotUtils.hpp"                       // for ASSERT
 
 // STATIC MEMBER DATA
 // (none)
@@ -46,21 +47,13 @@ YtaController::YtaController(CustomControllerType controllerType, int port, bool
 /// @method YtaController::GetX
 ///
 /// Returns x-axis input.  This method is pure virtual in the
-/// base class and must be implemented.
+/// base class and must be implemented.  Sensitivity scaling is
+/// part of the drive shaping tables.
 ///
 ////////////////////////////////////////////////////////////////
 double YtaController::GetX(JoystickHand hand) const
 {
-    // x-axis controls are very sensitive on this
-    // controller, so scale them back.
-    double xAxisValue = GetRawAxis(CONTROLLER_MAPPINGS->AXIS_MAPPINGS.LEFT_X_AXIS);
-    
-    if (IS_DRIVE_CONTROLLER)
-    {
-        xAxisValue *= X_AXIS_DRIVE_SENSITIVITY_SCALING;
-    }
-
-    return xAxisValue;
+    return GetRawAxis(CONTROLLER_MAPPINGS->AXIS_MAPPINGS.LEFT_X_AXIS);
 }
 
 
@@ -69,7 +62,8 @@ double YtaController::GetX(JoystickHand hand) const
 /// @method YtaController::GetY
 ///
 /// Returns y-axis input.  This method is pure virtual in the
-/// base class and must be implemented.
+/// base class and must be implemented.  Sensitivity scaling is
+/// part of the drive shaping tables.
 ///
 ////////////////////////////////////////////////////////////////
 double YtaController::GetY(JoystickHand hand) const
@@ -84,32 +78,24 @@ double YtaController::GetY(JoystickHand hand) const
     // Right trigger is the 'forward' value input.
     double rightTriggerValue = GetRawAxis(CONTROLLER_MAPPINGS->AXIS_MAPPINGS.RIGHT_TRIGGER);
 
-    if (RobotUtils::DEBUG_PRINTS)
-    {
-        SmartDashboard::PutNumber("Raw left trigger", leftTriggerValue);
-        SmartDashboard::PutNumber("Raw right trigger", rightTriggerValue);
-    }
-
     // Normalize (controller specific code).
     // After this, left will be 0->+1, right will be -1->0.
+    const double rawLeftTriggerValue = leftTriggerValue;
+    const double rawRightTriggerValue = rightTriggerValue;
     NormalizeTriggers(leftTriggerValue, rightTriggerValue);
 
-    if (RobotUtils::DEBUG_PRINTS)
+    // Both controllers would share the trigger telemetry, so only the driver's goes out
+    if (IS_DRIVE_CONTROLLER)
     {
-        SmartDashboard::PutNumber("Normalized left trigger", leftTriggerValue);
-        SmartDashboard::PutNumber("Normalized right trigger", rightTriggerValue);
+        RobotTelemetry::Set(RobotTelemetry::RAW_LEFT_TRIGGER, rawLeftTriggerValue);
+        RobotTelemetry::Set(RobotTelemetry::RAW_RIGHT_TRIGGER, rawRightTriggerValue);
+        RobotTelemetry::Set(RobotTelemetry::NORMALIZED_LEFT_TRIGGER, leftTriggerValue);
+        RobotTelemetry::Set(RobotTelemetry::NORMALIZED_RIGHT_TRIGGER, rightTriggerValue);
     }
     
     // Hopefully only one trigger is being pushed, but in
     // case both are being pressed, the value will be combined.
-    double yAxisValue =  leftTriggerValue + rightTriggerValue;
-    
-    if (IS_DRIVE_CONTROLLER)
-    {
-        yAxisValue *= Y_AXIS_DRIVE_SENSITIVITY_SCALING;
-    }
-
-    return yAxisValue;
+    return (leftTriggerValue + rightTriggerValue);
 }
 
 
@@ -21,7 +21,10 @@
 // C++ INCLUDES
 #include "YtaRobot.hpp"                 // for class declaration (and other headers)
 #include "RobotCamera.hpp"              // for interacting with cameras
+#include "LimelightClient.hpp"          // for limelight results
 #include "RobotI2c.hpp"                 // for I2cThread()
+#include "RobotThreads.hpp"             // for ConfigureCurrentThread()
+#include "RobotTiming.hpp"              // for ScopedTimer and timing statistics
 #include "RobotUtils.hpp"               // for Trim(), Limit() and DisplayMessage()
 
 // STATIC MEMBER VARIABLES
@@ -36,6 +39,16 @@ YtaRobot * YtaRobot::m_pThis;
 ////////////////////////////////////////////////////////////////
 YtaRobot::YtaRobot() :
     m_AutonomousChooser                 (),
+    m_pAutonomousSteps                  (nullptr),
+    m_AutonomousStepIndex               (0U),
+    m_bAutonomousStepStarted            (false),
+    m_EncoderDriveProfile               (),
+    m_EncoderDriveSetpointIndex         (0U),
+    m_EncoderDriveLeftStart             (0),
+    m_EncoderDriveRightStart            (0),
+    m_Trajectories                      (),
+    m_RamseteController                 (RAMSETE_CONTROLLER_GAINS),
+    m_TrajectoryPointIndex              (0U),
     m_pDriverStation                    (&DriverStation::GetInstance()),
     m_pDriveJoystick                    (nullptr),
     m_pControlJoystick                  (nullptr),
@@ -45,13 +58,27 @@ YtaRobot::YtaRobot() :
     m_pControlLogitechExtreme           (new Joystick(CONTROL_JOYSTICK_PORT)),
     m_pDriveXboxGameSir                 (new XboxController(DRIVE_JOYSTICK_PORT)),
     m_pControlXboxGameSir               (new XboxController(CONTROL_JOYSTICK_PORT)),
-    m_pLeftDriveMotors                  (new TalonMotorGroup<TalonFX>(NUMBER_OF_LEFT_DRIVE_MOTORS, LEFT_MOTORS_CAN_START_ID, MotorGroupControlMode::FOLLOW, FeedbackDevice::CTRE_MagEncoder_Relative)),
-    m_pRightDriveMotors                 (new TalonMotorGroup<TalonFX>(NUMBER_OF_RIGHT_DRIVE_MOTORS, RIGHT_MOTORS_CAN_START_ID, MotorGroupControlMode::FOLLOW, FeedbackDevice::CTRE_MagEncoder_Relative)),
-    m_pShooterMotors                    (new TalonMotorGroup<TalonFX>(NUMBER_OF_SHOOTER_MOTORS, SHOOTER_MOTORS_CAN_START_ID, MotorGroupControlMode::INVERSE, FeedbackDevice::None)),
-    m_pWinchMotor                       (new TalonFX(WINCH_MOTOR_CAN_ID)),
-    m_pIntakeMotor                      (new TalonSRX(INTAKE_MOTOR_CAN_ID)),
-    m_pTurretMotor                      (new TalonSRX(TURRET_MOTOR_CAN_ID)),
-    m_pColorWheelMotor                  (new TalonSRX(COLOR_WHEEL_MOTOR_CAN_ID)),
+    m_DriveInputs                       (),
+    m_ControlInputs                     (),
+    m_pLeftDriveMotors                  (new DriveMotorGroup(LEFT_MOTORS_CAN_START_ID, FeedbackDevice::IntegratedSensor)),
+    m_pRightDriveMotors                 (new DriveMotorGroup(RIGHT_MOTORS_CAN_START_ID, FeedbackDevice::IntegratedSensor)),
+    m_pShooterMotors                    (new ShooterMotorGroup(SHOOTER_MOTORS_CAN_START_ID, FeedbackDevice::IntegratedSensor)),
+    m_pWinchMotor                       (new CachedTalon<TalonFX>(WINCH_MOTOR_CAN_ID)),
+    m_pIntakeMotor                      (new CachedTalon<TalonSRX>(INTAKE_MOTOR_CAN_ID)),
+    m_pTurretMotor                      (new CachedTalon<TalonSRX>(TURRET_MOTOR_CAN_ID)),
+    m_pColorWheelMotor                  (new CachedTalon<TalonSRX>(COLOR_WHEEL_MOTOR_CAN_ID)),
+    m_LeftDriveSlewLimiter              (DRIVE_SLEW_RATE_PER_LOOP),
+    m_RightDriveSlewLimiter             (DRIVE_SLEW_RATE_PER_LOOP),
+    m_MotorStatusLoopCount              (0U),
+    m_ShooterTargetRpm                  (OFF),
+    m_ShooterAtSpeedLoopCount           (0U),
+    m_bShooterAtSpeed                   (false),
+    m_TurretTargetAngle                 (TURRET_CENTER_ANGLE_DEGREES),
+    m_bTurretTracking                   (false),
+    m_bTurretAtCenter                   (false),
+    m_HeadingController                 (HEADING_CONTROLLER_GAINS),
+    m_Odometry                          (),
+    m_OdometryFrameSequence             (0U),
     m_pLedsEnableRelay                  (new Relay(LEDS_ENABLE_RELAY_ID)),
     m_pRedLedRelay                      (new Relay(RED_LED_RELAY_ID)),
     m_pGreenLedRelay                    (new Relay(GREEN_LED_RELAY_ID)),
@@ -68,10 +95,12 @@ YtaRobot::YtaRobot() :
     m_pShooterSolenoidTrigger           (nullptr),
     m_pHangerRaiseSolenoidTrigger       (nullptr),
     m_pHangerExtendSolenoidTrigger      (nullptr),
+    m_pTurretTrackingTrigger            (nullptr),
+    m_pColorWheelRotationTrigger        (nullptr),
+    m_pColorWheelPositionTrigger        (nullptr),
     m_pAutonomousTimer                  (new Timer()),
     m_pInchingDriveTimer                (new Timer()),
     m_pDirectionalAlignTimer            (new Timer()),
-    m_pSafetyTimer                      (new Timer()),
     m_pAccelerometer                    (new BuiltInAccelerometer),
     m_pAdxrs450Gyro                     (nullptr),
     m_Bno055Angle                       (),
@@ -82,13 +111,15 @@ YtaRobot::YtaRobot() :
     m_pSerialPort                       (new SerialPort(SERIAL_PORT_BAUD_RATE, SerialPort::kMXP, SERIAL_PORT_NUM_DATA_BITS, SerialPort::kParity_None, SerialPort::kStopBits_One)),
     m_I2cThread                         (RobotI2c::I2cThread),
     m_pColorSensor                      (new rev::ColorSensorV3(I2C::Port::kOnboard)),
-    m_pColorMatcher                     (new rev::ColorMatch()),
+    m_ColorWheel                        (),
+    m_FieldTargetColor                  (ColorWheel::UNKNOWN),
+    m_GameDataLoopCount                 (0U),
     m_RobotMode                         (ROBOT_MODE_NOT_SET),
     m_RobotDriveState                   (MANUAL_CONTROL),
     m_AllianceColor                     (m_pDriverStation->GetAlliance()),
     m_bDriveSwap                        (false),
     m_HeartBeat                         (0U),
-    m_GameData                          ("")
+    m_LoopJitterMonitor                 ("Robot loop", std::chrono::milliseconds(ROBOT_LOOP_PERIOD_MS))
 {
     RobotUtils::DisplayMessage("Robot constructor.");
     
@@ -197,14 +228,36 @@ YtaRobot::YtaRobot() :
     RobotUtils::DisplayFormattedMessage("The drive reverse axis is: %d\n", YtaController::GetControllerMapping(DRIVE_CUSTOM_CONTROLLER_TYPE)->AXIS_MAPPINGS.LEFT_TRIGGER);
     RobotUtils::DisplayFormattedMessage("The drive left/right axis is: %d\n", YtaController::GetControllerMapping(DRIVE_CUSTOM_CONTROLLER_TYPE)->AXIS_MAPPINGS.LEFT_X_AXIS);
     
-    // @todo: Figure out how to assign these sooner to a valid joystick (pass by reference?).
-    // Since the triggers use a joystick object, they can't be created until the joysticks are assigned
-    m_pToggleFullProcessingTrigger  = new TriggerChangeValues(m_pDriveJoystick, CAMERA_TOGGLE_FULL_PROCESSING_BUTTON);
-    m_pToggleProcessedImageTrigger  = new TriggerChangeValues(m_pDriveJoystick, CAMERA_TOGGLE_PROCESSED_IMAGE_BUTTON);
-    m_pIntakeSolenoidTrigger = new TriggerChangeValues(m_pControlJoystick, INTAKE_SOLENOID_CHANGE_STATE_BUTTON);
-    m_pShooterSolenoidTrigger = new TriggerChangeValues(m_pControlJoystick, SHOOTER_SOLENOID_CHANGE_STATE_BUTTON);
-    m_pHangerRaiseSolenoidTrigger = new TriggerChangeValues(m_pDriveJoystick, HANG_RAISE_SOLENOID_CHANGE_STATE_BUTTON);
-    m_pHangerExtendSolenoidTrigger = new TriggerChangeValues(m_pDriveJoystick, HANG_EXT_SOLENOID_CHANGE_STATE_BUTTON);
+    // The triggers look at the controller snapshots, which are updated from the joysticks assigned above
+    m_pToggleFullProcessingTrigger  = new TriggerChangeValues(&m_DriveInputs, CAMERA_TOGGLE_FULL_PROCESSING_BUTTON);
+    m_pToggleProcessedImageTrigger  = new TriggerChangeValues(&m_DriveInputs, CAMERA_TOGGLE_PROCESSED_IMAGE_BUTTON);
+    m_pIntakeSolenoidTrigger = new TriggerChangeValues(&m_ControlInputs, INTAKE_SOLENOID_CHANGE_STATE_BUTTON);
+    m_pShooterSolenoidTrigger = new TriggerChangeValues(&m_ControlInputs, SHOOTER_SOLENOID_CHANGE_STATE_BUTTON);
+    m_pHangerRaiseSolenoidTrigger = new TriggerChangeValues(&m_DriveInputs, HANG_RAISE_SOLENOID_CHANGE_STATE_BUTTON);
+    m_pHangerExtendSolenoidTrigger = new TriggerChangeValues(&m_DriveInputs, HANG_EXT_SOLENOID_CHANGE_STATE_BUTTON);
+    m_pTurretTrackingTrigger = new TriggerChangeValues(&m_ControlInputs, TURRET_TRACKING_TOGGLE_BUTTON);
+    m_pColorWheelRotationTrigger = new TriggerChangeValues(&m_ControlInputs, COLOR_WHEEL_ROTATION_BUTTON);
+    m_pColorWheelPositionTrigger = new TriggerChangeValues(&m_ControlInputs, COLOR_WHEEL_POSITION_BUTTON);
+    
+    // Keep shots consistent as the battery sags, and let the Talons hold the shooter speed if configured
+    m_pShooterMotors->ConfigureVoltageCompensation(SHOOTER_VOLTAGE_COMPENSATION_VOLTS);
+    if (SHOOTER_VELOCITY_CONTROL_ENABLED)
+    {
+        m_pShooterMotors->ConfigureVelocityControl(SHOOTER_VELOCITY_PID);
+    }
+    
+    // The turret holds positions on its own encoder.  The robot has to
+    // be turned on with the turret centered, after that the center hall
+    // sensor keeps the encoder honest.
+    m_pTurretMotor->ConfigSelectedFeedbackSensor(FeedbackDevice::CTRE_MagEncoder_Relative, 0, 0);
+    YtaTalon::ConfigurePidSlot(m_pTurretMotor, 0, TURRET_POSITION_PID);
+    m_pTurretMotor->ConfigPeakOutputForward(TURRET_MAX_OUTPUT, 0);
+    m_pTurretMotor->ConfigPeakOutputReverse(-TURRET_MAX_OUTPUT, 0);
+    m_pTurretMotor->ConfigForwardSoftLimitThreshold(static_cast<int>((TURRET_MAX_ANGLE_DEGREES - TURRET_CENTER_ANGLE_DEGREES) * TURRET_ENCODER_TICKS_PER_DEGREE), 0);
+    m_pTurretMotor->ConfigReverseSoftLimitThreshold(static_cast<int>((TURRET_MIN_ANGLE_DEGREES - TURRET_CENTER_ANGLE_DEGREES) * TURRET_ENCODER_TICKS_PER_DEGREE), 0);
+    m_pTurretMotor->ConfigForwardSoftLimitEnable(true, 0);
+    m_pTurretMotor->ConfigReverseSoftLimitEnable(true, 0);
+    m_pTurretMotor->SetSelectedSensorPosition(0, 0, 0);
     
     // Construct the ADXRS450 gyro if configured
     if (ADXRS450_GYRO_PRESENT)
@@ -219,12 +272,7 @@ YtaRobot::YtaRobot() :
     // Spawn the vision and I2C threads
     m_CameraThread.detach();
     m_I2cThread.detach();
-
-    // Add the target color values to the matcher
-    m_pColorMatcher->AddColorMatch(BLUE_TARGET_COLOR);
-    m_pColorMatcher->AddColorMatch(GREEN_TARGET_COLOR);
-    m_pColorMatcher->AddColorMatch(RED_TARGET_COLOR);
-    m_pColorMatcher->AddColorMatch(YELLOW_TARGET_COLOR);
+    RobotI2c::SetThreadEnabled(true);
 }
 
 
@@ -237,8 +285,14 @@ YtaRobot::YtaRobot() :
 ////////////////////////////////////////////////////////////////
 void YtaRobot::RobotInit()
 {
+    RobotLogger::Initialize();
     RobotUtils::DisplayMessage("RobotInit called.");
     SetStaticThisInstance();
+    RobotThreads::ConfigureCurrentThread(RobotThreads::ROBOT_LOOP);
+    RobotTelemetry::Initialize();
+    
+    // Read the paths now so autonomous never waits on the file system
+    LoadTrajectories();
 }
 
 
@@ -258,6 +312,108 @@ void YtaRobot::RobotPeriodic()
         RobotUtils::DisplayMessage("RobotPeriodic called.");
         bRobotPeriodicStarted = true;
     }
+    
+    // Runs every loop in every mode, so it sees every period
+    m_LoopJitterMonitor.Tick();
+    
+    // Before anything this loop could want a new frame
+    LimelightClient::Update();
+    
+    // The robot can be pushed around while disabled, so always track it
+    UpdateOdometry();
+    
+    RobotTelemetry::Flush();
+    
+    // Teleop and test read the controllers before their sequences run,
+    // which is ahead of this.  Other modes read them here so the log
+    // and the button edges never hold a stale snapshot.
+    if ((m_RobotMode != ROBOT_MODE_TELEOP) && (m_RobotMode != ROBOT_MODE_TEST))
+    {
+        UpdateControllerInputs();
+    }
+    
+    // Nothing worth logging happens while disabled
+    if (m_RobotMode != ROBOT_MODE_DISABLED)
+    {
+        LogLoopData();
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::UpdateOdometry
+///
+/// Updates the field pose from the drive encoders and gyro.  If
+/// the limelight sees the target, the bearing to it is used to
+/// correct the position, compared against where the robot was
+/// when the limelight captured the frame.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::UpdateOdometry()
+{
+    // The gyro reads clockwise, odometry counts counter clockwise
+    const double gyroHeading = -GetGyroValue(BNO055) * DEGREES_TO_RADIANS;
+    m_Odometry.Update(GetLeftDriveInches(), GetRightDriveInches(), gyroHeading, RobotController::GetFPGATime());
+    
+    // Each frame is only used once, or it would pull the pose too hard
+    LimelightClient::FrameSample frameSample;
+    if (LimelightClient::GetNewFrame(m_OdometryFrameSequence, frameSample) && frameSample.m_Data.m_bTargetValid)
+    {
+        // The limelight angle is positive to the right, flip it to match
+        static_cast<void>(m_Odometry.AddVisionMeasurement(-frameSample.m_Data.m_TargetX * DEGREES_TO_RADIANS,
+                                                          0.0,
+                                                          VISION_TARGET_X_INCHES,
+                                                          VISION_TARGET_Y_INCHES,
+                                                          frameSample.m_Data.m_CaptureTimestampUs));
+    }
+    
+    const DriveOdometry::Pose & rPose = m_Odometry.GetPose();
+    RobotTelemetry::Set(RobotTelemetry::ODOMETRY_X, rPose.m_X);
+    RobotTelemetry::Set(RobotTelemetry::ODOMETRY_Y, rPose.m_Y);
+    RobotTelemetry::Set(RobotTelemetry::ODOMETRY_HEADING, rPose.m_Heading / DEGREES_TO_RADIANS);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::LogLoopData
+///
+/// Logs a snapshot of the robot to the match log.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::LogLoopData()
+{
+    RobotLogRecords::LoopData loopData = {};
+    FillLoopData(loopData);
+    RobotLogger::LogLoop(static_cast<uint8_t>(m_RobotMode), loopData);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::FillLoopData
+///
+/// Gathers a snapshot of the robot for the match log.  The
+/// values are all ones the robot already has on hand, so this
+/// doesn't go out to any hardware.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::FillLoopData(RobotLogRecords::LoopData & rLoopData)
+{
+    m_DriveInputs.FillLogData(rLoopData.m_DriveController);
+    m_ControlInputs.FillLogData(rLoopData.m_ControlController);
+    
+    // Only teleop has a timed loop
+    rLoopData.m_LoopTimeUs = (m_RobotMode == ROBOT_MODE_TELEOP) ? RobotTiming::GetLastSampleUs(RobotTiming::TELEOP_LOOP) : 0U;
+    
+    // What the code commanded, so a replay compares like with like
+    rLoopData.m_LeftDriveOutput = static_cast<float>(m_pLeftDriveMotors->GetLastOutput());
+    rLoopData.m_RightDriveOutput = static_cast<float>(m_pRightDriveMotors->GetLastOutput());
+    rLoopData.m_LeftEncoder = m_pLeftDriveMotors->GetEncoderValue();
+    rLoopData.m_RightEncoder = m_pRightDriveMotors->GetEncoderValue();
+    rLoopData.m_GyroAngle = static_cast<float>(m_Bno055Angle);
+    rLoopData.m_ShooterRpm = static_cast<float>(ConvertTalonVelocityToRpm(m_pShooterMotors->GetVelocity()));
 }
 
 
@@ -275,19 +431,26 @@ void YtaRobot::InitialStateSetup()
     // Start with motors off
     m_pLeftDriveMotors->Set(OFF);
     m_pRightDriveMotors->Set(OFF);
+    m_LeftDriveSlewLimiter.Reset();
+    m_RightDriveSlewLimiter.Reset();
     m_pShooterMotors->Set(OFF);
-    m_pWinchMotor->Set(ControlMode::PercentOutput, OFF);
-    m_pIntakeMotor->Set(ControlMode::PercentOutput, OFF);
-    m_pTurretMotor->Set(ControlMode::PercentOutput, OFF);
-    m_pColorWheelMotor->Set(ControlMode::PercentOutput, OFF);
+    m_pWinchMotor->SetIfChanged(ControlMode::PercentOutput, OFF);
+    m_pIntakeMotor->SetIfChanged(ControlMode::PercentOutput, OFF);
+    m_pTurretMotor->SetIfChanged(ControlMode::PercentOutput, OFF);
+    m_bTurretTracking = false;
+    m_pColorWheelMotor->SetIfChanged(ControlMode::PercentOutput, OFF);
+    m_ColorWheel.Stop();
+    
+    // Check for new game data right away
+    m_FieldTargetColor = ColorWheel::UNKNOWN;
+    m_GameDataLoopCount = GAME_DATA_CHECK_INTERVAL_LOOPS;
     
     // Configure brake or coast for the drive motors
     m_pLeftDriveMotors->SetBrakeMode();
     m_pRightDriveMotors->SetBrakeMode();
     
     // Tare encoders
-    m_pLeftDriveMotors->TareEncoder();
-    m_pRightDriveMotors->TareEncoder();
+    TareDriveEncoders();
 
     // Solenoids
     m_pIntakeSolenoid->Set(DoubleSolenoid::kOff);
@@ -306,8 +469,6 @@ void YtaRobot::InitialStateSetup()
     m_pInchingDriveTimer->Reset();
     m_pDirectionalAlignTimer->Stop();
     m_pDirectionalAlignTimer->Reset();
-    m_pSafetyTimer->Stop();
-    m_pSafetyTimer->Reset();
     
     // Just in case constructor was called before these were set (likely the case)
     m_AllianceColor = m_pDriverStation->GetAlliance();
@@ -338,10 +499,14 @@ void YtaRobot::TeleopInit()
     
     // Tele-op won't do detailed processing of the images unless instructed to
     RobotCamera::SetFullProcessing(false);
+    RobotCamera::SetProcessingScale(RobotCamera::FULL_SCALE);
     RobotCamera::SetLimelightMode(RobotCamera::DRIVER_CAMERA);
     
     // Indicate to the I2C thread to get data less often
     RobotI2c::SetThreadUpdateRate(I2C_RUN_INTERVAL_MS);
+    
+    // Each teleop run gets its own timing statistics
+    RobotTiming::ResetStatistics();
 }
 
 
@@ -360,27 +525,61 @@ void YtaRobot::TeleopPeriodic()
 
     HeartBeat();
 
-    DriveControlSequence();
+    {
+        // Times the whole loop, the sequences are timed individually below
+        RobotTiming::ScopedTimer loopTimer(RobotTiming::TELEOP_LOOP);
 
-    IntakeSequence();
+        // Every sequence works from the same controller inputs this loop
+        UpdateControllerInputs();
 
-    TurretSequence();
+        {
+            RobotTiming::ScopedTimer sequenceTimer(RobotTiming::DRIVE_CONTROL_SEQUENCE);
+            DriveControlSequence();
+        }
 
-    ShooterSequence();
+        {
+            RobotTiming::ScopedTimer sequenceTimer(RobotTiming::INTAKE_SEQUENCE);
+            IntakeSequence();
+        }
 
-    //ColorSequence();
+        {
+            RobotTiming::ScopedTimer sequenceTimer(RobotTiming::TURRET_SEQUENCE);
+            TurretSequence();
+        }
 
-    //LedSequence();
+        {
+            RobotTiming::ScopedTimer sequenceTimer(RobotTiming::SHOOTER_SEQUENCE);
+            ShooterSequence();
+        }
+
+        {
+            RobotTiming::ScopedTimer sequenceTimer(RobotTiming::COLOR_SEQUENCE);
+            ColorSequence();
+        }
 
-    PneumaticSequence();
+        //LedSequence();
 
-    HangSequence();
+        {
+            RobotTiming::ScopedTimer sequenceTimer(RobotTiming::PNEUMATIC_SEQUENCE);
+            PneumaticSequence();
+        }
 
-    //SerialPortSequence();
-    
-    //I2cSequence();
-    
-    //CameraSequence();
+        {
+            RobotTiming::ScopedTimer sequenceTimer(RobotTiming::HANG_SEQUENCE);
+            HangSequence();
+        }
+
+        //SerialPortSequence();
+        
+        //I2cSequence();
+        
+        //CameraSequence();
+
+        MotorStatusSequence();
+    }
+
+    // Not part of the timed loop so publishing doesn't skew the results
+    RobotTiming::PublishSummary();
 }
 
 
@@ -395,11 +594,11 @@ void YtaRobot::IntakeSequence()
 {
     double intakeMotorSpeed = OFF;
 
-    if (m_pControlJoystick->GetRawButton(INTAKE_FORWARD_BUTTON))
+    if (m_ControlInputs.GetButton(INTAKE_FORWARD_BUTTON))
     {
         intakeMotorSpeed = INTAKE_MOTOR_SPEED;
     }
-    else if (m_pControlJoystick->GetRawButton(INTAKE_REVERSE_BUTTON))
+    else if (m_ControlInputs.GetButton(INTAKE_REVERSE_BUTTON))
     {
         intakeMotorSpeed = -INTAKE_MOTOR_SPEED;
     }
@@ -408,7 +607,7 @@ void YtaRobot::IntakeSequence()
         intakeMotorSpeed = OFF;
     }
 
-    m_pIntakeMotor->Set(ControlMode::PercentOutput, intakeMotorSpeed);
+    m_pIntakeMotor->SetIfChanged(ControlMode::PercentOutput, intakeMotorSpeed);
 }
 
 
@@ -416,11 +615,32 @@ void YtaRobot::IntakeSequence()
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::TurretSequence
 ///
-/// This method contains the main workflow for the turret.
+/// This method contains the main workflow for the turret.  A
+/// button toggles between the joystick and tracking the vision
+/// target.  Either way, nothing here waits, so the robot can
+/// keep driving while the turret aims.
 ///
 ////////////////////////////////////////////////////////////////
 void YtaRobot::TurretSequence()
 {
+    UpdateTurretReference();
+
+    if (m_pTurretTrackingTrigger->DetectChange())
+    {
+        m_bTurretTracking = !m_bTurretTracking;
+
+        // Hold where the turret is until the target is seen
+        m_TurretTargetAngle = GetTurretAngle();
+    }
+
+    RobotTelemetry::Set(RobotTelemetry::TURRET_TRACKING, m_bTurretTracking);
+
+    if (m_bTurretTracking)
+    {
+        TurretTrackTarget();
+        return;
+    }
+
     bool bLeftMovementAllowed = true;
     bool bRightMovementAllowed = true;
 
@@ -436,20 +656,97 @@ void YtaRobot::TurretSequence()
         bLeftMovementAllowed = false;
     }
 
-    double turretControlValue = m_pControlJoystick->GetRawAxis(TURRET_CONTROL_AXIS);
+    double turretControlValue = m_ControlInputs.GetAxis(TURRET_CONTROL_AXIS);
 
     if ((turretControlValue < 0.0) && bRightMovementAllowed)
     {
-        m_pTurretMotor->Set(ControlMode::PercentOutput, turretControlValue * TURRET_MOTOR_SCALING_VALUE);
+        m_pTurretMotor->SetIfChanged(ControlMode::PercentOutput, turretControlValue * TURRET_MOTOR_SCALING_VALUE);
     }
     else if ((turretControlValue > 0.0) && bLeftMovementAllowed)
     {
-        m_pTurretMotor->Set(ControlMode::PercentOutput, turretControlValue * TURRET_MOTOR_SCALING_VALUE);
+        m_pTurretMotor->SetIfChanged(ControlMode::PercentOutput, turretControlValue * TURRET_MOTOR_SCALING_VALUE);
     }
     else
     {
-        m_pTurretMotor->Set(ControlMode::PercentOutput, OFF);
+        m_pTurretMotor->SetIfChanged(ControlMode::PercentOutput, OFF);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::UpdateTurretReference
+///
+/// Sets the turret encoder back to zero when the magnet first
+/// reaches the center hall sensor.  Belt slip and the time the
+/// turret was moved by hand while disabled would otherwise add
+/// up over a match.  Only the edge is used, the encoder isn't
+/// written again while the turret sits on the sensor.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::UpdateTurretReference()
+{
+    // False means the magnet is present
+    const bool bAtCenter = !m_pTurretCenterHallSensor->Get();
+    if (bAtCenter && !m_bTurretAtCenter)
+    {
+        m_pTurretMotor->SetSelectedSensorPosition(0, 0, 0);
     }
+    m_bTurretAtCenter = bAtCenter;
+
+    RobotTelemetry::Set(RobotTelemetry::TURRET_ANGLE, GetTurretAngle());
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::TurretTrackTarget
+///
+/// Aims the turret at the limelight target.  The limelight is
+/// fixed to the chassis, so its angle to the target is from the
+/// way the robot was pointing when the frame was captured.  The
+/// robot may have turned since then, so the turn since capture
+/// (from the odometry history) is taken back out.  The aim is
+/// kept inside the soft limits, and the hall sensors at the
+/// ends stop it going further if the encoder is wrong.  When
+/// the target isn't visible the last aim is held.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::TurretTrackTarget()
+{
+    // The latest frame is used every loop (not just when it's new) so the robot's turn keeps being taken out
+    LimelightClient::FrameSample frameSample;
+    if (LimelightClient::GetLatestFrame(frameSample) &&
+        ((RobotController::GetFPGATime() - frameSample.m_TimestampUs) <= LimelightClient::MAX_FRAME_AGE_US) &&
+        frameSample.m_Data.m_bTargetValid)
+    {
+        double turnSinceCaptureDegrees = 0.0;
+        DriveOdometry::Pose capturePose;
+        if (m_Odometry.GetPoseAt(frameSample.m_Data.m_CaptureTimestampUs, capturePose))
+        {
+            turnSinceCaptureDegrees = DriveOdometry::WrapAngle(m_Odometry.GetPose().m_Heading - capturePose.m_Heading) / DEGREES_TO_RADIANS;
+        }
+
+        // The limelight angle is positive to the right, turret angles increase to the left
+        m_TurretTargetAngle = TURRET_FORWARD_ANGLE_DEGREES - frameSample.m_Data.m_TargetX - turnSinceCaptureDegrees;
+    }
+
+    m_TurretTargetAngle = RobotUtils::Limit(m_TurretTargetAngle, TURRET_MAX_ANGLE_DEGREES, TURRET_MIN_ANGLE_DEGREES);
+
+    // Hall sensors are the last line of defense (false = magnet present)
+    const double turretAngle = GetTurretAngle();
+    if (!m_pTurretLeftHallSensor->Get() && (m_TurretTargetAngle > turretAngle))
+    {
+        m_TurretTargetAngle = turretAngle;
+    }
+    if (!m_pTurretRightHallSensor->Get() && (m_TurretTargetAngle < turretAngle))
+    {
+        m_TurretTargetAngle = turretAngle;
+    }
+
+    m_pTurretMotor->SetIfChanged(ControlMode::Position, (m_TurretTargetAngle - TURRET_CENTER_ANGLE_DEGREES) * TURRET_ENCODER_TICKS_PER_DEGREE);
+
+    RobotTelemetry::Set(RobotTelemetry::TURRET_TARGET_ANGLE, m_TurretTargetAngle);
 }
 
 
@@ -462,24 +759,67 @@ void YtaRobot::TurretSequence()
 ////////////////////////////////////////////////////////////////
 void YtaRobot::ShooterSequence()
 {
-    double shooterMotorSpeed = 0.0;
+    double shooterMotorSpeed = OFF;
+    double shooterTargetRpm = OFF;
     
-    if (m_pControlJoystick->GetRawButton(SHOOTER_FAST_BUTTON))
+    if (m_ControlInputs.GetButton(SHOOTER_FAST_BUTTON))
     {
-        // Negative motor value spins in the desired direction
-        shooterMotorSpeed = -SHOOTER_FAST_MOTOR_SPEED;
+        shooterMotorSpeed = SHOOTER_FAST_MOTOR_SPEED;
+        shooterTargetRpm = SHOOTER_FAST_RPM;
     }
-    else if (m_pControlJoystick->GetRawButton(SHOOTER_SLOW_BUTTON))
+    else if (m_ControlInputs.GetButton(SHOOTER_SLOW_BUTTON))
+    {
+        shooterMotorSpeed = SHOOTER_SLOW_MOTOR_SPEED;
+        shooterTargetRpm = SHOOTER_SLOW_RPM;
+    }
+    
+    // A new target has to be reached before the shooter is ready again
+    if (shooterTargetRpm != m_ShooterTargetRpm)
+    {
+        m_ShooterAtSpeedLoopCount = 0U;
+        m_bShooterAtSpeed = false;
+    }
+    m_ShooterTargetRpm = shooterTargetRpm;
+
+    if (shooterTargetRpm == OFF)
+    {
+        // Let the flywheel coast down instead of braking it with the closed loop
+        m_pShooterMotors->Set(OFF);
+    }
+    else if (SHOOTER_VELOCITY_CONTROL_ENABLED)
     {
         // Negative motor value spins in the desired direction
-        shooterMotorSpeed = -SHOOTER_SLOW_MOTOR_SPEED;
+        m_pShooterMotors->SetVelocity(-ConvertRpmToTalonVelocity(shooterTargetRpm));
+        
+        const double shooterRpm = -ConvertTalonVelocityToRpm(m_pShooterMotors->GetVelocity());
+        if (std::abs(shooterRpm - shooterTargetRpm) <= SHOOTER_AT_SPEED_TOLERANCE_RPM)
+        {
+            if (m_ShooterAtSpeedLoopCount < SHOOTER_AT_SPEED_LOOPS)
+            {
+                m_ShooterAtSpeedLoopCount++;
+            }
+        }
+        else
+        {
+            m_ShooterAtSpeedLoopCount = 0U;
+        }
+        
+        // Require a few loops in tolerance so a pass through the target on the way up doesn't count
+        m_bShooterAtSpeed = (m_ShooterAtSpeedLoopCount >= SHOOTER_AT_SPEED_LOOPS);
+        
+        RobotTelemetry::Set(RobotTelemetry::SHOOTER_RPM, shooterRpm);
     }
     else
     {
-        shooterMotorSpeed = OFF;
+        // Negative motor value spins in the desired direction
+        m_pShooterMotors->Set(-shooterMotorSpeed);
+        
+        // There's no feedback in open loop, so timing is left to the operator
+        m_bShooterAtSpeed = true;
     }
-
-    m_pShooterMotors->Set(shooterMotorSpeed);
+    
+    RobotTelemetry::Set(RobotTelemetry::SHOOTER_TARGET_RPM, shooterTargetRpm);
+    RobotTelemetry::Set(RobotTelemetry::SHOOTER_AT_SPEED, m_bShooterAtSpeed);
 }
 
 
@@ -494,11 +834,11 @@ void YtaRobot::HangSequence()
 {
     double winchMotorSpeed = OFF;
 
-    if (m_pDriveJoystick->GetRawButton(WINCH_FORWARD_BUTTON))
+    if (m_DriveInputs.GetButton(WINCH_FORWARD_BUTTON))
     {
         winchMotorSpeed = WINCH_MOTOR_SPEED;
     }
-    else if (m_pDriveJoystick->GetRawButton(WINCH_REVERSE_BUTTON))
+    else if (m_DriveInputs.GetButton(WINCH_REVERSE_BUTTON))
     {
         winchMotorSpeed = -WINCH_MOTOR_SPEED;
     }
@@ -507,7 +847,34 @@ void YtaRobot::HangSequence()
         winchMotorSpeed = OFF;
     }
 
-    m_pWinchMotor->Set(ControlMode::PercentOutput, winchMotorSpeed);
+    m_pWinchMotor->SetIfChanged(ControlMode::PercentOutput, winchMotorSpeed);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::MotorStatusSequence
+///
+/// This method reads motor status that changes slowly, such as
+/// temperature.  Every read is a CAN transaction, so these are
+/// only done about once a second rather than every loop.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::MotorStatusSequence()
+{
+    m_MotorStatusLoopCount++;
+    if (m_MotorStatusLoopCount < MOTOR_STATUS_INTERVAL_LOOPS)
+    {
+        return;
+    }
+    m_MotorStatusLoopCount = 0U;
+
+    // Retrieve motor temperatures
+    double leftTemp = ConvertCelsiusToFahrenheit(m_pLeftDriveMotors->GetMotorObject()->GetTemperature());
+    double rightTemp = ConvertCelsiusToFahrenheit(m_pRightDriveMotors->GetMotorObject()->GetTemperature());
+
+    RobotTelemetry::Set(RobotTelemetry::LEFT_DRIVE_TEMPERATURE, leftTemp);
+    RobotTelemetry::Set(RobotTelemetry::RIGHT_DRIVE_TEMPERATURE, rightTemp);
 }
 
 
@@ -521,76 +888,61 @@ void YtaRobot::HangSequence()
 ////////////////////////////////////////////////////////////////
 void YtaRobot::ColorSequence()
 {
-    m_GameData = frc::DriverStation::GetInstance().GetGameSpecificMessage();
-    
-    // Sample code uses 'if m_GameData.length() > 0' too.
-    frc::Color targetColor = {0.0, 0.0, 0.0};
-    switch (m_GameData[0])
+    // The game data only shows up once, so stop checking after it does
+    if (m_FieldTargetColor == ColorWheel::UNKNOWN)
     {
-        case GAME_DATA_BLUE:
+        m_GameDataLoopCount++;
+        if (m_GameDataLoopCount >= GAME_DATA_CHECK_INTERVAL_LOOPS)
         {
-            targetColor = BLUE_TARGET_COLOR;
-            break;
+            m_GameDataLoopCount = 0U;
+            m_FieldTargetColor = ColorWheel::ParseGameData(m_pDriverStation->GetGameSpecificMessage());
         }
-        case GAME_DATA_GREEN:
+    }
+
+    // Pressing either button again (or the other one) stops the spinner
+    if (m_pColorWheelRotationTrigger->DetectChange())
+    {
+        if (m_ColorWheel.GetMode() == ColorWheel::IDLE)
         {
-            targetColor = GREEN_TARGET_COLOR;
-            break;
+            m_ColorWheel.StartRotationControl();
         }
-        case GAME_DATA_RED:
+        else
         {
-            targetColor = RED_TARGET_COLOR;
-            break;
+            m_ColorWheel.Stop();
         }
-        case GAME_DATA_YELLOW:
+    }
+    else if (m_pColorWheelPositionTrigger->DetectChange())
+    {
+        if (m_ColorWheel.GetMode() == ColorWheel::IDLE)
         {
-            targetColor = YELLOW_TARGET_COLOR;
-            break;
+            m_ColorWheel.StartPositionControl(m_FieldTargetColor);
         }
-        default:
+        else
         {
-            break;
+            m_ColorWheel.Stop();
         }
     }
-
-    frc::Color detectedColor = m_pColorSensor->GetColor();
-    double irDistance = m_pColorSensor->GetIR();
-    uint32_t proximity = m_pColorSensor->GetProximity();
-
-    double confidence = 0.0;
-    frc::Color matchedColor = m_pColorMatcher->MatchClosestColor(detectedColor, confidence);
-
-    std::string colorString = "";
-    if (matchedColor == BLUE_TARGET_COLOR)
-    {
-      colorString = "Blue";
-    }
-    else if (matchedColor == RED_TARGET_COLOR)
-    {
-      colorString = "Red";
-    }
-    else if (matchedColor == GREEN_TARGET_COLOR)
-    {
-      colorString = "Green";
-    }
-    else if (matchedColor == YELLOW_TARGET_COLOR)
-    {
-      colorString = "Yellow";
-    }
     else
     {
-      colorString = "Unknown";
     }
-    
-    if (RobotUtils::DEBUG_PRINTS)
+
+    const frc::Color detectedColor = m_pColorSensor->GetColor();
+    const ColorWheel::WheelColor wheelColor = m_ColorWheel.Classify(detectedColor);
+    m_pColorWheelMotor->SetIfChanged(ControlMode::PercentOutput, m_ColorWheel.Update(wheelColor));
+
+    RobotTelemetry::Set(RobotTelemetry::COLOR_SENSOR_COLOR, wheelColor);
+    RobotTelemetry::Set(RobotTelemetry::COLOR_WHEEL_TARGET_COLOR, m_FieldTargetColor);
+    RobotTelemetry::Set(RobotTelemetry::COLOR_WHEEL_TRANSITIONS, m_ColorWheel.GetTransitionCount());
+    RobotTelemetry::Set(RobotTelemetry::COLOR_WHEEL_ACTIVE, m_ColorWheel.GetMode() != ColorWheel::IDLE);
+
+    // Every read is another trip on the I2C bus, so the raw values are only for debugging
+    if (RobotTelemetry::IsEnabled(RobotTelemetry::VERBOSITY_DEBUG))
     {
-        SmartDashboard::PutNumber("Color sensor red", detectedColor.red);
-        SmartDashboard::PutNumber("Color sensor green", detectedColor.green);
-        SmartDashboard::PutNumber("Color sensor blue", detectedColor.blue);
-        SmartDashboard::PutNumber("Color sensor IR distance", irDistance);
-        SmartDashboard::PutNumber("Color sensor proximity", proximity);
-        SmartDashboard::PutString("Color sensor detected color", colorString);
-        SmartDashboard::PutNumber("Color sensor match confidence", confidence);
+        RobotTelemetry::Set(RobotTelemetry::COLOR_SENSOR_RED, detectedColor.red);
+        RobotTelemetry::Set(RobotTelemetry::COLOR_SENSOR_GREEN, detectedColor.green);
+        RobotTelemetry::Set(RobotTelemetry::COLOR_SENSOR_BLUE, detectedColor.blue);
+        RobotTelemetry::Set(RobotTelemetry::COLOR_SENSOR_IR_DISTANCE, m_pColorSensor->GetIR());
+        RobotTelemetry::Set(RobotTelemetry::COLOR_SENSOR_PROXIMITY, m_pColorSensor->GetProximity());
     }
 }
 
@@ -650,7 +1002,8 @@ void YtaRobot::PneumaticSequence()
 
     static DoubleSolenoid::Value shooterSolenoidState = m_pShooterSolenoid->Get();
 
-    if (m_pShooterSolenoidTrigger->DetectChange())
+    // Don't feed a ball while the shooter is still spinning up or recovering from the last shot
+    if (m_pShooterSolenoidTrigger->DetectChange() && IsShooterReadyToFire())
     {
         switch (shooterSolenoidState)
         {
@@ -785,22 +1138,13 @@ void YtaRobot::SerialPortSequence()
 /// @method YtaRobot::I2cSequence
 ///
 /// This method contains the main workflow for interaction with
-/// the I2C bus.
+/// the I2C bus.  The I2C thread keeps the gyro and sonar data
+/// current on its own, and it is the only thing allowed to
+/// publish them, so the robot loop just reads the snapshots.
 ///
 ////////////////////////////////////////////////////////////////
 void YtaRobot::I2cSequence()
 {
-    static std::chrono::time_point<std::chrono::high_resolution_clock> currentTime;
-    static std::chrono::time_point<std::chrono::high_resolution_clock> oldTime;
-    currentTime = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> elapsed = currentTime - oldTime;
-    if (elapsed.count() > I2C_RUN_INTERVAL_MS)
-    {
-        RobotI2c::ManualTrigger();
-        //static_cast<void>(GetGyroValue(BNO055));
-        
-        oldTime = currentTime;
-    }
 }
 
 
@@ -819,11 +1163,11 @@ void YtaRobot::CameraSequence()
     // @note: Use std::chrono is precise time control is needed.
     
     // Check for any change in camera
-    if (m_pDriveJoystick->GetRawButton(SELECT_FRONT_CAMERA_BUTTON))
+    if (m_DriveInputs.GetButton(SELECT_FRONT_CAMERA_BUTTON))
     {
         RobotCamera::SetCamera(RobotCamera::FRONT_USB);
     }
-    else if (m_pDriveJoystick->GetRawButton(SELECT_BACK_CAMERA_BUTTON))
+    else if (m_DriveInputs.GetButton(SELECT_BACK_CAMERA_BUTTON))
     {
         RobotCamera::SetCamera(RobotCamera::BACK_USB);
     }
@@ -868,6 +1212,8 @@ void YtaRobot::DriveControlSequence()
         // If an align is in progress, do not accept manual driver input
         if (m_RobotDriveState == DIRECTIONAL_ALIGN)
         {
+            m_LeftDriveSlewLimiter.Reset();
+            m_RightDriveSlewLimiter.Reset();
             return;
         }
     }
@@ -877,6 +1223,8 @@ void YtaRobot::DriveControlSequence()
         // If a directional inch occurred, just return
         if (DirectionalInch())
         {
+            m_LeftDriveSlewLimiter.Reset();
+            m_RightDriveSlewLimiter.Reset();
             return;
         }
     }
@@ -927,18 +1275,16 @@ void YtaRobot::DriveControlSequence()
     //   +1
     
     // Get driver X/Y inputs
-    double xAxisDrive = m_pDriveJoystick->GetX();
-    double yAxisDrive = m_pDriveJoystick->GetY();
+    double xAxisDrive = m_DriveInputs.GetX();
+    double yAxisDrive = m_DriveInputs.GetY();
 
-    if (RobotUtils::DEBUG_PRINTS)
-    {
-        SmartDashboard::PutNumber("x-axis input", xAxisDrive);
-        SmartDashboard::PutNumber("y-axis input", yAxisDrive);
-    }
+    RobotTelemetry::Set(RobotTelemetry::X_AXIS_INPUT, xAxisDrive);
+    RobotTelemetry::Set(RobotTelemetry::Y_AXIS_INPUT, yAxisDrive);
     
-    // Make sure axes inputs clear a certain threshold.  This will help to drive straight.
-    xAxisDrive = RobotUtils::Trim((xAxisDrive * throttleControl), JOYSTICK_TRIM_UPPER_LIMIT, JOYSTICK_TRIM_LOWER_LIMIT);
-    yAxisDrive = RobotUtils::Trim((yAxisDrive * throttleControl), JOYSTICK_TRIM_UPPER_LIMIT, JOYSTICK_TRIM_LOWER_LIMIT);
+    // Shape the inputs (deadband, curve and sensitivity, all from a
+    // lookup table), then throttle them.  The deadband helps to drive straight.
+    xAxisDrive = DRIVE_SHAPING_TABLES->X_AXIS.Evaluate(xAxisDrive) * throttleControl;
+    yAxisDrive = DRIVE_SHAPING_TABLES->Y_AXIS.Evaluate(yAxisDrive) * throttleControl;
 
     // If the swap direction button was pressed, negate y value
     if (m_bDriveSwap)
@@ -957,32 +1303,24 @@ void YtaRobot::DriveControlSequence()
     if (SLOW_DRIVE_ENABLED)
     {
         // Get the slow drive control joystick input
-        double xAxisSlowDrive = m_pDriveJoystick->GetRawAxis(DRIVE_SLOW_X_AXIS);
-        xAxisSlowDrive = RobotUtils::Trim((xAxisSlowDrive * DRIVE_SLOW_THROTTLE_VALUE), JOYSTICK_TRIM_UPPER_LIMIT, JOYSTICK_TRIM_LOWER_LIMIT);
+        double xAxisSlowDrive = SLOW_DRIVE_SHAPING_TABLE.Evaluate(m_DriveInputs.GetAxis(DRIVE_SLOW_X_AXIS));
         
         // If the normal x-axis drive is non-zero, use it.  Otherwise use the slow drive input, which could also be zero.
         xAxisDrive = (xAxisDrive != 0.0) ? xAxisDrive : xAxisSlowDrive;
     }
     
-    // Filter motor speeds
+    // Filter motor speeds, then keep them from jumping up too fast
     double leftSpeed = RobotUtils::Limit((LeftDriveEquation(xAxisDrive, yAxisDrive)), DRIVE_MOTOR_UPPER_LIMIT, DRIVE_MOTOR_LOWER_LIMIT);
     double rightSpeed = RobotUtils::Limit(RightDriveEquation(xAxisDrive, yAxisDrive), DRIVE_MOTOR_UPPER_LIMIT, DRIVE_MOTOR_LOWER_LIMIT);
+    leftSpeed = m_LeftDriveSlewLimiter.Apply(leftSpeed);
+    rightSpeed = m_RightDriveSlewLimiter.Apply(rightSpeed);
     
     // Set motor speed
     m_pLeftDriveMotors->Set(leftSpeed);
     m_pRightDriveMotors->Set(rightSpeed);
 
-    // Retrieve motor temperatures
-    double leftTemp = ConvertCelsiusToFahrenheit(m_pLeftDriveMotors->GetMotorObject()->GetTemperature());
-    double rightTemp = ConvertCelsiusToFahrenheit(m_pRightDriveMotors->GetMotorObject()->GetTemperature());
-
-    if (RobotUtils::DEBUG_PRINTS)
-    {
-        SmartDashboard::PutNumber("Left drive speed", leftSpeed);
-        SmartDashboard::PutNumber("Right drive speed", rightSpeed);
-        SmartDashboard::PutNumber("Left temperature (F)", leftTemp);
-        SmartDashboard::PutNumber("Right temperature (F)", rightTemp);
-    }
+    RobotTelemetry::Set(RobotTelemetry::LEFT_DRIVE_SPEED, leftSpeed);
+    RobotTelemetry::Set(RobotTelemetry::RIGHT_DRIVE_SPEED, rightSpeed);
 }
 
 
@@ -1000,22 +1338,22 @@ bool YtaRobot::DirectionalInch()
     double leftSpeed = 0.0;
     double rightSpeed = 0.0;
 
-    if (m_pDriveJoystick->GetRawButton(DRIVE_CONTROLS_INCH_FORWARD_BUTTON))
+    if (m_DriveInputs.GetButton(DRIVE_CONTROLS_INCH_FORWARD_BUTTON))
     {
         leftSpeed = INCHING_DRIVE_SPEED * LEFT_DRIVE_FORWARD_SCALAR;
         rightSpeed = INCHING_DRIVE_SPEED * RIGHT_DRIVE_FORWARD_SCALAR;
     }
-    else if (m_pDriveJoystick->GetRawButton(DRIVE_CONTROLS_INCH_BACKWARD_BUTTON))
+    else if (m_DriveInputs.GetButton(DRIVE_CONTROLS_INCH_BACKWARD_BUTTON))
     {
         leftSpeed = INCHING_DRIVE_SPEED * LEFT_DRIVE_REVERSE_SCALAR;
         rightSpeed = INCHING_DRIVE_SPEED * RIGHT_DRIVE_REVERSE_SCALAR;
     }
-    else if (m_pDriveJoystick->GetRawButton(DRIVE_CONTROLS_INCH_LEFT_BUTTON))
+    else if (m_DriveInputs.GetButton(DRIVE_CONTROLS_INCH_LEFT_BUTTON))
     {
         leftSpeed = INCHING_DRIVE_SPEED * LEFT_DRIVE_REVERSE_SCALAR;
         rightSpeed = INCHING_DRIVE_SPEED * RIGHT_DRIVE_FORWARD_SCALAR;
     }
-    else if (m_pDriveJoystick->GetRawButton(DRIVE_CONTROLS_INCH_RIGHT_BUTTON))
+    else if (m_DriveInputs.GetButton(DRIVE_CONTROLS_INCH_RIGHT_BUTTON))
     {
         leftSpeed = INCHING_DRIVE_SPEED * LEFT_DRIVE_FORWARD_SCALAR;
         rightSpeed = INCHING_DRIVE_SPEED * RIGHT_DRIVE_REVERSE_SCALAR;
@@ -1083,7 +1421,7 @@ void YtaRobot::DirectionalAlign()
     static bool bStateChangeAllowed = false;
     
     // Get the current POV value
-    int povValue = m_pDriveJoystick->GetPOV();
+    int povValue = m_DriveInputs.GetPOV();
     
     // Check if it changed since last function call
     if (povValue != lastPovValue)
@@ -1159,54 +1497,8 @@ void YtaRobot::DirectionalAlign()
                 // This gives a value of 0, 90, 180 or 270
                 destinationAngle = ANGLE_90_DEGREES * degreeMultiplier;
                 
-                // Read the starting angle
-                RobotI2c::ManualTrigger();
-                int startingAngle = static_cast<int>(GetGyroValue(BNO055));
-                
-                // Do some angle math to figure out which direction is faster to turn.
-                // Examples:
-                // Starting: 45, 180    Destination: 0, 90, 180, 270
-                // 45 - 0 = 45          180 - 0 = 180
-                // 45 - 90 = -45        180 - 90 = 90
-                // 45 - 180 = -135      180 - 180 = 0
-                // 45 - 270 = -225      180 - 270 = -90
-                int angleDistance = startingAngle - destinationAngle;
-                int absValueAngleDistance = std::abs(angleDistance);
-                
-                // Variables to indicate which way to turn
-                bool bTurnLeft = false;
-                bool bTurnRight = false;
-                
-                // Figure out which way to turn
-                if (angleDistance > 0)
-                {
-                    // Target is to the left of where we are
-                    bTurnLeft = true;
-                }
-                else
-                {
-                    // Target is to the right of where we are
-                    bTurnRight = true;
-                }
-
-                // If the target distance is more than halfway around, it's actually faster to turn the other way 
-                if (absValueAngleDistance > ANGLE_180_DEGREES)
-                {
-                    bTurnLeft = !bTurnLeft;
-                    bTurnRight = !bTurnRight;
-                }
-                
-                // The destination angle and direction is now known, time to do the move
-                if (bTurnLeft)
-                {
-                    m_pLeftDriveMotors->Set(DIRECTIONAL_ALIGN_DRIVE_SPEED * LEFT_DRIVE_REVERSE_SCALAR);
-                    m_pRightDriveMotors->Set(DIRECTIONAL_ALIGN_DRIVE_SPEED * RIGHT_DRIVE_FORWARD_SCALAR);
-                }
-                if (bTurnRight)
-                {
-                    m_pLeftDriveMotors->Set(DIRECTIONAL_ALIGN_DRIVE_SPEED * LEFT_DRIVE_FORWARD_SCALAR);
-                    m_pRightDriveMotors->Set(DIRECTIONAL_ALIGN_DRIVE_SPEED * RIGHT_DRIVE_REVERSE_SCALAR);
-                }
+                // The controller works out which way is shorter to turn
+                m_HeadingController.Start(destinationAngle, DIRECTIONAL_ALIGN_DRIVE_SPEED);
                 
                 // Start the safety timer
                 m_pDirectionalAlignTimer->Start();
@@ -1222,16 +1514,12 @@ void YtaRobot::DirectionalAlign()
         }
         case DIRECTIONAL_ALIGN:
         {   
-            // Force update gyro value
-            RobotI2c::ManualTrigger();
-            
             // Three conditions for stopping the align:
-            // 1. Destination angle is reached
+            // 1. Robot has settled on the destination angle
             // 2. Safety timer expires
             // 3. User cancels the operation
-            // @todo: Is it a problem that (destinationAngle - 1) can be negative when angle == zero?
-            int currentAngle = static_cast<int>(GetGyroValue(BNO055));
-            if (((currentAngle >= (destinationAngle - 1)) && (currentAngle <= (destinationAngle + 1))) ||
+            const double turnSpeed = m_HeadingController.Update(GetGyroValue(BNO055));
+            if ((m_HeadingController.IsSettled()) ||
                 (m_pDirectionalAlignTimer->Get() > DIRECTIONAL_ALIGN_MAX_TIME_S) ||
                 (bStateChangeAllowed))
             {
@@ -1252,6 +1540,10 @@ void YtaRobot::DirectionalAlign()
                 // Align done, back to manual control
                 m_RobotDriveState = MANUAL_CONTROL;
             }
+            else
+            {
+                TurnInPlace(turnSpeed);
+            }
             
             break;
         }
@@ -1284,6 +1576,9 @@ void YtaRobot::DisabledInit()
     m_pRedLedRelay->Set(LEDS_OFF);
     m_pGreenLedRelay->Set(LEDS_OFF);
     m_pBlueLedRelay->Set(LEDS_OFF);
+    
+    // Show where the time went during the last enabled run
+    RobotTiming::DisplayHistograms();
 }
 
 
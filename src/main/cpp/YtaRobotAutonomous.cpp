@@ -37,16 +37,24 @@ void YtaRobot::AutonomousInit()
     // Put everything in a stable state
     InitialStateSetup();
     
+    // Autonomous starts the field pose over from where the robot was placed
+    const DriveOdometry::Pose startPose = {0.0, 0.0, 0.0};
+    m_Odometry.Reset(startPose, 0.0, 0.0, -GetGyroValue(BNO055) * DEGREES_TO_RADIANS, RobotController::GetFPGATime());
+    
     // Indicate the autonomous routine has not executed yet
     YtaRobotAutonomous::bAutonomousExecutionComplete = false;
     
+    // No routine is loaded until the first periodic call
+    m_pAutonomousSteps = nullptr;
+    m_AutonomousStepIndex = 0U;
+    m_bAutonomousStepStarted = false;
+    
     m_pAutonomousTimer->Stop();
     m_pAutonomousTimer->Reset();
-    m_pSafetyTimer->Stop();
-    m_pSafetyTimer->Reset();
     
-    // Autonomous needs full camera processing
+    // Autonomous needs full camera processing, and frame rate matters more than accuracy while aligning
     RobotCamera::SetFullProcessing(true);
+    RobotCamera::SetProcessingScale(RobotCamera::HALF_SCALE);
     RobotCamera::SetLimelightMode(RobotCamera::VISION_PROCESSOR);
     
     // Indicate to the I2C thread to get data more often
@@ -60,10 +68,9 @@ void YtaRobot::AutonomousInit()
 ///
 /// The autonomous control method.  This method is called
 /// periodically while the robot is in autonomous control.
-/// Even though this method wil be called periodically, it
-/// deliberately checks the driver station state controls.
-/// This is to give finer control over the autonomous state
-/// machine flow.
+/// The first call selects a routine, which loads a table of
+/// steps.  Every call after that advances the current step by
+/// one tick, so nothing here blocks the robot loop.
 ///
 ////////////////////////////////////////////////////////////////
 void YtaRobot::AutonomousPeriodic()
@@ -76,64 +83,242 @@ void YtaRobot::AutonomousPeriodic()
         return;
     }
     
-    // @todo: Figure out how to kick the watchdog from here so it doesn't overrun.
-    // @note: Since autonomous is configured as a one shot state machine, there will definitely be watchdog overrun.
+    if (m_pAutonomousSteps == nullptr)
+    {
+        // Get the selected autonomous routine from the smart dashboard
+        std::string selectedAutoRoutineString = m_AutonomousChooser.GetSelected();
+        
+        // Auto routine 1
+        if (selectedAutoRoutineString == AUTO_ROUTINE_1_STRING)
+        {
+            RobotUtils::DisplayMessage("Auto routine 1.");
+            AutonomousRoutine1();
+        }
+        
+        // Auto routine 2
+        else if (selectedAutoRoutineString == AUTO_ROUTINE_2_STRING)
+        {
+            RobotUtils::DisplayMessage("Auto routine 2.");
+            AutonomousRoutine2();
+        }
+        
+        // Auto routine 3
+        else if (selectedAutoRoutineString == AUTO_ROUTINE_3_STRING)
+        {
+            RobotUtils::DisplayMessage("Auto routine 3.");
+            AutonomousRoutine3();
+        }
+
+        /* !!! ONLY ENABLE TEST AUTONOMOUS CODE WHEN TESTING
+               SELECT A FUNCTIONING ROUTINE FOR ACTUAL MATCHES !!! */
+        else if (selectedAutoRoutineString == AUTO_TEST_ROUTINE_STRING)
+        {
+            RobotUtils::DisplayMessage("Auto test code.");
+            AutonomousTestCode();
+        }
+
+        else
+        {
+            // No option was selected; ensure known behavior to avoid issues
+            RobotUtils::DisplayMessage("No auto selection made, going idle.");
+        }
+        
+        // The test code and no selection don't load any steps
+        if (m_pAutonomousSteps == nullptr)
+        {
+            YtaRobotAutonomous::bAutonomousExecutionComplete = true;
+            return;
+        }
+    }
     
-    // Change values in the header to control having an
-    // autonomous routine and which is selected
+    if (RunAutonomousRoutine())
+    {
+        RobotUtils::DisplayMessage("Autonomous routine complete.");
+        YtaRobotAutonomous::bAutonomousExecutionComplete = true;
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::StartAutonomousRoutine
+///
+/// Loads a table of steps to be run by the autonomous engine.
+/// The table must end with an AUTO_STEP_END step.
+///
+////////////////////////////////////////////////////////////////
+void YtaRobot::StartAutonomousRoutine(const AutonomousStep * pSteps)
+{
+    ASSERT(pSteps != nullptr);
     
-    // Get the selected autonomous routine from the smart dashboard
-    std::string selectedAutoRoutineString = m_AutonomousChooser.GetSelected();
+    m_pAutonomousSteps = pSteps;
+    m_AutonomousStepIndex = 0U;
+    m_bAutonomousStepStarted = false;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::RunAutonomousRoutine
+///
+/// Advances the autonomous routine by one tick.  Each step is
+/// timed with the autonomous timer and abandoned if it runs
+/// past its timeout.  The drive motors are turned off between
+/// steps.  Returns true when the routine has finished.
+///
+////////////////////////////////////////////////////////////////
+bool YtaRobot::RunAutonomousRoutine()
+{
+    const AutonomousStep & rStep = m_pAutonomousSteps[m_AutonomousStepIndex];
     
-    // Auto routine 1
-    //if ( YtaRobotAutonomous::ROUTINE_1 )
-    if (selectedAutoRoutineString == AUTO_ROUTINE_1_STRING)
+    if (rStep.m_Type == AUTO_STEP_END)
     {
-        RobotUtils::DisplayMessage("Auto routine 1.");
-        AutonomousRoutine1();
+        m_pLeftDriveMotors->Set(OFF);
+        m_pRightDriveMotors->Set(OFF);
+        m_pAutonomousTimer->Stop();
+        return true;
     }
     
-    // Auto routine 2
-    //else if ( YtaRobotAutonomous::ROUTINE_2 )
-    else if (selectedAutoRoutineString == AUTO_ROUTINE_2_STRING)
+    if (rStep.m_Type == AUTO_STEP_REPEAT)
     {
-        RobotUtils::DisplayMessage("Auto routine 2.");
-        AutonomousRoutine2();
+        // Jump back to an earlier step, which starts fresh on the next tick
+        m_AutonomousStepIndex = static_cast<unsigned>(rStep.m_Value);
+        m_bAutonomousStepStarted = false;
+        return false;
     }
     
-    // Auto routine 3
-    //else if ( YtaRobotAutonomous::ROUTINE_3 )
-    else if (selectedAutoRoutineString == AUTO_ROUTINE_3_STRING)
+    const bool bFirstTick = !m_bAutonomousStepStarted;
+    if (bFirstTick)
     {
-        RobotUtils::DisplayMessage("Auto routine 3.");
-        AutonomousRoutine3();
+        m_pAutonomousTimer->Stop();
+        m_pAutonomousTimer->Reset();
+        m_pAutonomousTimer->Start();
+        m_bAutonomousStepStarted = true;
+        
+        RobotTelemetry::Set(RobotTelemetry::AUTO_STEP, m_AutonomousStepIndex);
     }
-
-    /* !!! ONLY ENABLE TEST AUTONOMOUS CODE WHEN TESTING
-           SELECT A FUNCTIONING ROUTINE FOR ACTUAL MATCHES !!! */
-    //else if ( YtaRobotAutonomous::TEST_ENABLED )
-    else if (selectedAutoRoutineString == AUTO_TEST_ROUTINE_STRING)
+    
+    bool bStepDone = ExecuteAutonomousStep(rStep, bFirstTick);
+    
+    if (!bStepDone && (m_pAutonomousTimer->Get() > rStep.m_TimeoutS))
     {
-        RobotUtils::DisplayMessage("Auto test code.");
-        AutonomousTestCode();
+        RobotUtils::DisplayFormattedMessage("Autonomous step %u timed out.\n", m_AutonomousStepIndex);
+        bStepDone = true;
     }
-
-    else
+    
+    if (bStepDone)
     {
-        // No option was selected; ensure known behavior to avoid issues
-        RobotUtils::DisplayMessage("No auto selection made, going idle.");
+        m_pLeftDriveMotors->Set(OFF);
+        m_pRightDriveMotors->Set(OFF);
+        m_AutonomousStepIndex++;
+        m_bAutonomousStepStarted = false;
     }
     
-    // One shot through autonomous is over, indicate as such.
-    YtaRobotAutonomous::bAutonomousExecutionComplete = true;
+    return false;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::ExecuteAutonomousStep
+///
+/// Runs one tick of an autonomous step.  Returns true when the
+/// step has met its goal.
+///
+////////////////////////////////////////////////////////////////
+bool YtaRobot::ExecuteAutonomousStep(const AutonomousStep & rStep, bool bFirstTick)
+{
+    bool bStepDone = false;
     
-    /*
-    // Idle until auto is terminated
-    RobotUtils::DisplayMessage("Auto idle loop.");
-    while ( m_pDriverStation->IsAutonomous() && m_pDriverStation->IsEnabled() )
+    switch (rStep.m_Type)
     {
+        case AUTO_STEP_DELAY:
+        {
+            bStepDone = (m_pAutonomousTimer->Get() >= rStep.m_Value);
+            break;
+        }
+        case AUTO_STEP_DRIVE:
+        {
+            if (bFirstTick)
+            {
+                AutonomousDriveSequence(rStep.m_Direction, rStep.m_Speed);
+            }
+            bStepDone = (m_pAutonomousTimer->Get() >= rStep.m_Value);
+            break;
+        }
+        case AUTO_STEP_ENCODER_DRIVE:
+        {
+            bStepDone = AutonomousEncoderDrive(rStep.m_Speed, rStep.m_Value, rStep.m_Direction, bFirstTick);
+            break;
+        }
+        case AUTO_STEP_GYRO_TURN:
+        {
+            if (rStep.m_Direction == ROBOT_LEFT)
+            {
+                bStepDone = AutonomousGyroLeftTurn(rStep.m_Value, rStep.m_Speed, bFirstTick);
+            }
+            else if (rStep.m_Direction == ROBOT_RIGHT)
+            {
+                bStepDone = AutonomousGyroRightTurn(rStep.m_Value, rStep.m_Speed, bFirstTick);
+            }
+            else
+            {
+                ASSERT(false);
+                bStepDone = true;
+            }
+            break;
+        }
+        case AUTO_STEP_BACK_DRIVE:
+        {
+            if (bFirstTick)
+            {
+                AutonomousBackDrive(rStep.m_Direction);
+            }
+            bStepDone = (m_pAutonomousTimer->Get() >= YtaRobotAutonomous::COUNTERACT_COAST_TIME_S);
+            break;
+        }
+        case AUTO_STEP_BACK_DRIVE_TURN:
+        {
+            if (bFirstTick)
+            {
+                AutonomousBackDriveTurn(rStep.m_Direction);
+            }
+            bStepDone = (m_pAutonomousTimer->Get() >= YtaRobotAutonomous::COUNTERACT_COAST_TIME_S);
+            break;
+        }
+        case AUTO_STEP_SONAR_DRIVE:
+        {
+            bStepDone = AutonomousSonarDrive(rStep.m_Direction,
+                                             static_cast<SonarDriveState>(rStep.m_Option),
+                                             static_cast<uint32_t>(rStep.m_Value),
+                                             YtaRobotAutonomous::SONAR_SIDE_DRIVE_DIST_INCHES);
+            break;
+        }
+        case AUTO_STEP_CAMERA_ALIGN:
+        {
+            RobotCamera::AutonomousCamera::SeekDirection seekDirection = RobotCamera::AutonomousCamera::SEEK_LEFT;
+            if (rStep.m_Direction == ROBOT_RIGHT)
+            {
+                seekDirection = RobotCamera::AutonomousCamera::SEEK_RIGHT;
+            }
+            bStepDone = RobotCamera::AutonomousCamera::AlignToTarget(seekDirection, (rStep.m_Option != 0U));
+            break;
+        }
+        case AUTO_STEP_TRAJECTORY:
+        {
+            bStepDone = AutonomousTrajectoryDrive(rStep.m_Option, bFirstTick);
+            break;
+        }
+        default:
+        {
+            // END and REPEAT are handled by the engine
+            ASSERT(false);
+            bStepDone = true;
+            break;
+        }
     }
-    */
+    
+    return bStepDone;
 }
 
 
@@ -141,9 +326,9 @@ void YtaRobot::AutonomousPeriodic()
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::AutonomousCommon
 ///
-/// Common autonomous behavior.  It moves away from the alliance
-/// wall and to the fuel loading station.  The variance is
-/// whether it shoots at the start or at the end.
+/// Common autonomous behavior.  It follows a path off the line
+/// that curves toward the trench on the robot's side of the
+/// field.
 ///
 ////////////////////////////////////////////////////////////////
 void YtaRobot::AutonomousCommon()
@@ -172,6 +357,14 @@ void YtaRobot::AutonomousCommon()
 ////////////////////////////////////////////////////////////////
 void YtaRobot::AutonomousCommonRed()
 {
+    static const AutonomousStep ROUTINE_STEPS[] =
+    {
+        // Type                 Direction       Speed   Value   Option                  Timeout
+        {AUTO_STEP_TRAJECTORY,  ROBOT_FORWARD,  0.0,    0.0,    TRAJECTORY_COMMON_RED,  YtaRobotAutonomous::TRAJECTORY_MAX_DELAY_S},
+        {AUTO_STEP_END,         ROBOT_FORWARD,  0.0,    0.0,    0U,                     YtaRobotAutonomous::NO_STEP_TIMEOUT_S}
+    };
+    
+    StartAutonomousRoutine(ROUTINE_STEPS);
 }
 
 
@@ -198,4 +391,12 @@ void YtaRobot::AutonomousCommonRed()
 ////////////////////////////////////////////////////////////////
 void YtaRobot::AutonomousCommonBlue()
 {
+    static const AutonomousStep ROUTINE_STEPS[] =
+    {
+        // Type                 Direction       Speed   Value   Option                  Timeout
+        {AUTO_STEP_TRAJECTORY,  ROBOT_FORWARD,  0.0,    0.0,    TRAJECTORY_COMMON_BLUE, YtaRobotAutonomous::TRAJECTORY_MAX_DELAY_S},
+        {AUTO_STEP_END,         ROBOT_FORWARD,  0.0,    0.0,    0U,                     YtaRobotAutonomous::NO_STEP_TIMEOUT_S}
+    };
+    
+    StartAutonomousRoutine(ROUTINE_STEPS);
 }
@@ -25,14 +25,12 @@
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::AutonomousRoutine1
 ///
-/// Autonomous routine 1.
+/// Autonomous routine 1.  Seeks left for the target with the
+/// camera for the rest of autonomous.
 ///
 ////////////////////////////////////////////////////////////////
 void YtaRobot::AutonomousRoutine1()
 {
-    //AutonomousDriveSequence(ROBOT_REVERSE, 0.25, 1.0);
-    //RobotCamera::AutonomousCamera::AlignToTarget(RobotCamera::AutonomousCamera::SEEK_LEFT);
-
     static SendableChooser<std::string> autoSeekEnableChooser;
     const std::string AUTO_CAMERA_SEEK_ON = "Auto camera seek on";
     const std::string AUTO_CAMERA_SEEK_OFF = "Auto camera seek off";
@@ -41,17 +39,32 @@ void YtaRobot::AutonomousRoutine1()
     SmartDashboard::PutData("Auto camera seek", &autoSeekEnableChooser);
     std::string autoCameraSeekEnabled = autoSeekEnableChooser.GetSelected();
 
-    bool bMotorSeek = false;
+    // The align step restarts each time it finds the target or times out
+    static const AutonomousStep MOTOR_SEEK_STEPS[] =
+    {
+        // Type                 Direction       Speed   Value   Option  Timeout
+        {AUTO_STEP_CAMERA_ALIGN, ROBOT_LEFT,    0.0,    0.0,    1U,     YtaRobotAutonomous::CAMERA_ALIGN_MAX_DELAY_S},
+        {AUTO_STEP_REPEAT,      ROBOT_FORWARD,  0.0,    0.0,    0U,     YtaRobotAutonomous::NO_STEP_TIMEOUT_S},
+        {AUTO_STEP_END,         ROBOT_FORWARD,  0.0,    0.0,    0U,     YtaRobotAutonomous::NO_STEP_TIMEOUT_S}
+    };
+    
+    static const AutonomousStep NO_MOTOR_SEEK_STEPS[] =
+    {
+        // Type                 Direction       Speed   Value   Option  Timeout
+        {AUTO_STEP_CAMERA_ALIGN, ROBOT_LEFT,    0.0,    0.0,    0U,     YtaRobotAutonomous::CAMERA_ALIGN_MAX_DELAY_S},
+        {AUTO_STEP_REPEAT,      ROBOT_FORWARD,  0.0,    0.0,    0U,     YtaRobotAutonomous::NO_STEP_TIMEOUT_S},
+        {AUTO_STEP_END,         ROBOT_FORWARD,  0.0,    0.0,    0U,     YtaRobotAutonomous::NO_STEP_TIMEOUT_S}
+    };
+
     if (autoCameraSeekEnabled == AUTO_CAMERA_SEEK_ON)
     {
-        bMotorSeek = true;
+        StartAutonomousRoutine(MOTOR_SEEK_STEPS);
     }
-
-    while ( m_pDriverStation->IsAutonomous() && m_pDriverStation->IsEnabled() )
+    else
     {
-        RobotCamera::AutonomousCamera::AlignToTarget(RobotCamera::AutonomousCamera::SEEK_LEFT, bMotorSeek);
+        StartAutonomousRoutine(NO_MOTOR_SEEK_STEPS);
     }
     
-    // Returning from here will enter the idle state until autonomous is over
-    RobotUtils::DisplayMessage("Auto routine 1 done.");
+    // The steps will be run by AutonomousPeriodic() until autonomous is over
+    RobotUtils::DisplayMessage("Auto routine 1 loaded.");
 }
@@ -24,11 +24,15 @@
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::AutonomousRoutine2
 ///
-/// Autonomous routine 2.
+/// Autonomous routine 2.  Runs the common path for whichever
+/// alliance the robot is on.
 ///
 ////////////////////////////////////////////////////////////////
 void YtaRobot::AutonomousRoutine2()
 {
-    // Returning from here will enter the idle state until autonomous is over
-    RobotUtils::DisplayMessage("Auto routine 2 done.");
+    // Loads the steps for the alliance (nothing if the color is unknown)
+    AutonomousCommon();
+    
+    // The steps will be run by AutonomousPeriodic(), then idle until autonomous is over
+    RobotUtils::DisplayMessage("Auto routine 2 loaded.");
 }
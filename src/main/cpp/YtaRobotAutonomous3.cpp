@@ -29,6 +29,14 @@
 ////////////////////////////////////////////////////////////////
 void YtaRobot::AutonomousRoutine3()
 {
-    // Returning from here will enter the idle state until autonomous is over
-    RobotUtils::DisplayMessage("Auto routine 3 done.");
+    static const AutonomousStep ROUTINE_STEPS[] =
+    {
+        // Type                 Direction       Speed   Value   Option  Timeout
+        {AUTO_STEP_END,         ROBOT_FORWARD,  0.0,    0.0,    0U,     YtaRobotAutonomous::NO_STEP_TIMEOUT_S}
+    };
+    
+    StartAutonomousRoutine(ROUTINE_STEPS);
+    
+    // The steps will be run by AutonomousPeriodic(), then idle until autonomous is over
+    RobotUtils::DisplayMessage("Auto routine 3 loaded.");
 }
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   Bno055.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for talking to a BNO055 directly from the roboRIO.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BNO055_HPP
+#define BNO055_HPP
+
+// SYSTEM INCLUDES
+#include <cstdint>                                          // for sized integer types
+
+// C INCLUDES
+#include "frc/I2C.h"                                        // for interacting with an I2C port
+
+// C++ INCLUDES
+#include "../../Rioduino/RoborioRioduinoSharedData.hpp"     // for GyroI2cData
+
+using namespace frc;
+using namespace RoborioRioduinoSharedData;
+
+
+////////////////////////////////////////////////////////////////
+/// @class Bno055
+///
+/// Driver for a BNO055 9-axis sensor on one of the roboRIO I2C
+/// ports.  The sensor runs its own fusion (NDOF mode), so all
+/// this does is read back the fused Euler angles with a single
+/// burst read.  The angles are handed back in the same form the
+/// RIOduino used to send them, with the heading relative to a
+/// center point that can be reset.
+///
+////////////////////////////////////////////////////////////////
+class Bno055
+{
+public:
+
+    // Constructor
+    Bno055(I2C::Port port, int address);
+
+    // Find the sensor and put it in fusion mode, returns false if it isn't responding
+    bool Initialize();
+
+    // Read the latest fused angles, returns false if the read failed
+    bool ReadAngles(GyroI2cData & rAngles);
+
+    // Make the heading at the next read the new zero
+    inline void RequestNewCenter()
+    {
+        m_bReadNewCenter = true;
+    }
+
+    // Whether the sensor has been found and configured
+    inline bool IsInitialized() const
+    {
+        return m_bInitialized;
+    }
+
+    // The default address (ADR pin low)
+    static const int        DEFAULT_ADDRESS             = 0x28;
+
+private:
+
+    // Registers (page zero)
+    enum Register : uint8_t
+    {
+        CHIP_ID_REGISTER        = 0x00,
+        PAGE_ID_REGISTER        = 0x07,
+        EULER_HEADING_LSB       = 0x1A,
+        UNIT_SELECT_REGISTER    = 0x3B,
+        OPERATION_MODE_REGISTER = 0x3D,
+        POWER_MODE_REGISTER     = 0x3E,
+        SYSTEM_TRIGGER_REGISTER = 0x3F
+    };
+
+    // Write one register, returns false if the transfer failed
+    bool WriteRegister(Register reg, uint8_t value);
+
+    // Switch operating modes, waiting as long as the sensor needs
+    bool SetOperationMode(uint8_t mode);
+
+    // Heading, roll, pitch as two byte little endian values
+    static const unsigned   EULER_DATA_BYTES            = 6U;
+
+    static const uint8_t    CHIP_ID_VALUE               = 0xA0;
+    static const uint8_t    CONFIG_MODE                 = 0x00;
+    static const uint8_t    NDOF_MODE                   = 0x0C;
+    static const uint8_t    NORMAL_POWER_MODE           = 0x00;
+    static const uint8_t    EXTERNAL_CRYSTAL            = 0x80;
+    // Degrees, dps, m/s^2, Celsius, Windows orientation
+    static const uint8_t    DEFAULT_UNITS               = 0x00;
+
+    // Times from the data sheet
+    static const unsigned   BOOT_TIME_MS                = 650U;
+    static const unsigned   TO_CONFIG_MODE_TIME_MS      = 19U;
+    static const unsigned   FROM_CONFIG_MODE_TIME_MS    = 7U;
+
+    // The Euler angles are 1/16 of a degree, like the I2C data
+    static const int16_t    FULL_CIRCLE                 = 360 * GyroI2cData::ANGLE_UNITS_PER_DEGREE;
+    static const int16_t    HALF_CIRCLE                 = 180 * GyroI2cData::ANGLE_UNITS_PER_DEGREE;
+
+    I2C                     m_I2c;
+    int16_t                 m_CenterHeading;
+    bool                    m_bReadNewCenter;
+    bool                    m_bInitialized;
+
+    Bno055(const Bno055 &) = delete;
+    Bno055 & operator=(const Bno055 &) = delete;
+};
+
+#endif // BNO055_HPP
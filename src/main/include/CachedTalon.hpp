@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   CachedTalon.hpp
+/// @author David Stalter
+///
+/// @details
+/// Classes that skip motor output calls that repeat the last one.  This
+/// only saves Phoenix API calls.  Phoenix sends a Talon's control frame
+/// on its own period whether or not Set() was called, so the CAN bus
+/// load is set by the control and status frame periods instead (see
+/// YtaTalon::ConfigureFollower).
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CACHEDTALON_HPP
+#define CACHEDTALON_HPP
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+#include "ctre/Phoenix.h"               // for CTRE library interfaces
+
+// C++ INCLUDES
+// (none)
+
+
+namespace YtaTalon
+{
+    ////////////////////////////////////////////////////////////////
+    /// @class YtaTalon::WriteCache
+    ///
+    /// Remembers the last control mode and value sent to a Talon so
+    /// a call that repeats the same output can be skipped.  A
+    /// repeat still goes out every so often, which corrects the
+    /// output if something changed it without the cache knowing.
+    ///
+    ////////////////////////////////////////////////////////////////
+    class WriteCache
+    {
+    public:
+
+        // Constructor
+        WriteCache() :
+            m_ControlMode(ControlMode::Disabled),
+            m_Value(0.0),
+            m_SkippedWrites(REFRESH_INTERVAL_WRITES)
+        {
+        }
+
+        // Returns true if this output needs to be sent to the Talon
+        inline bool IsWriteNeeded(ControlMode controlMode, double value)
+        {
+            if ((controlMode == m_ControlMode) && (value == m_Value) && (m_SkippedWrites < REFRESH_INTERVAL_WRITES))
+            {
+                m_SkippedWrites++;
+                return false;
+            }
+
+            m_ControlMode = controlMode;
+            m_Value = value;
+            m_SkippedWrites = 0U;
+            return true;
+        }
+
+        // The last output sent
+        inline double GetValue() const
+        {
+            return m_Value;
+        }
+
+        // Forget the last output, so the next one always goes out
+        inline void Invalidate()
+        {
+            m_SkippedWrites = REFRESH_INTERVAL_WRITES;
+        }
+
+    private:
+
+        // Unchanged writes skipped before one is sent anyway (about 200ms of 20ms loops)
+        static const unsigned REFRESH_INTERVAL_WRITES = 10U;
+
+        ControlMode     m_ControlMode;
+        double          m_Value;
+        unsigned        m_SkippedWrites;
+    };
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @class CachedTalon
+///
+/// A Talon with a SetIfChanged() that drops calls repeating the
+/// last output.  The Talon's own Set() is left alone and always
+/// goes through.  Call InvalidateCache() after using it so the
+/// next SetIfChanged() isn't skipped against a stale output.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType>
+class CachedTalon : public TalonType
+{
+public:
+
+    // Constructor
+    explicit CachedTalon(int canId) :
+        TalonType(canId),
+        m_WriteCache()
+    {
+    }
+
+    // Set the output, skipped if it matches the last one sent
+    inline void SetIfChanged(ControlMode controlMode, double value)
+    {
+        if (m_WriteCache.IsWriteNeeded(controlMode, value))
+        {
+            TalonType::Set(controlMode, value);
+        }
+    }
+
+    // Forget the last output, needed after calling Set() directly
+    inline void InvalidateCache()
+    {
+        m_WriteCache.Invalidate();
+    }
+
+private:
+
+    YtaTalon::WriteCache m_WriteCache;
+
+    CachedTalon(const CachedTalon &) = delete;
+    CachedTalon & operator=(const CachedTalon &) = delete;
+};
+
+#endif // CACHEDTALON_HPP
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   ColorWheel.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for classifying control panel colors and controlling
+/// the color wheel spinner.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLORWHEEL_HPP
+#define COLORWHEEL_HPP
+
+// SYSTEM INCLUDES
+#include <cstdint>                              // for uint8_t
+#include <string>                               // for std::string
+
+// C INCLUDES
+#include "frc/util/Color.h"                     // for frc::Color
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class ColorWheel
+///
+/// Class for the control panel spinner.  Colors from the sensor
+/// are classified with a table built once at construction that
+/// holds the nearest target color for every (red, green) bin,
+/// so a read is a couple of multiplies and one lookup.  Rotation
+/// control counts the color changes as the panel turns, and
+/// position control turns until the sensor sees the color that
+/// puts the requested color under the field sensor.  A color has
+/// to be seen for a few reads in a row before it counts, and it
+/// has to be next to the last color on the panel, so a misread
+/// at a segment edge doesn't add a transition.  It is updated
+/// once per robot loop and returns the spinner motor output.
+///
+////////////////////////////////////////////////////////////////
+class ColorWheel
+{
+public:
+
+    // Colors on the control panel, in the same order as the target colors
+    enum WheelColor : uint8_t
+    {
+        BLUE,
+        GREEN,
+        RED,
+        YELLOW,
+        NUM_TARGET_COLORS,
+        UNKNOWN = NUM_TARGET_COLORS
+    };
+
+    // What the spinner is doing
+    enum Mode
+    {
+        IDLE,
+        ROTATION_CONTROL,
+        POSITION_CONTROL
+    };
+
+    // Constructor
+    ColorWheel();
+
+    // Find the target color closest to a color sensor reading
+    WheelColor Classify(const frc::Color & rColor) const;
+
+    // The color requested by the field, UNKNOWN until game data arrives
+    static WheelColor ParseGameData(const std::string & rGameData);
+
+    // Spin the panel the required number of rotations
+    void StartRotationControl();
+
+    // Turn the panel until the requested color is under the field sensor
+    void StartPositionControl(WheelColor fieldTargetColor);
+
+    // Stop whatever control is running
+    void Stop();
+
+    // Run one loop with the latest classified color, returns the motor output
+    double Update(WheelColor detectedColor);
+
+    inline Mode GetMode() const
+    {
+        return m_Mode;
+    }
+
+    // Color changes counted since rotation control started
+    inline unsigned GetTransitionCount() const
+    {
+        return m_TransitionCount;
+    }
+
+    // The last color that was seen long enough to count
+    inline WheelColor GetStableColor() const
+    {
+        return m_StableColor;
+    }
+
+    // Calibrated sensor readings for each panel color
+    static constexpr frc::Color     TARGET_COLORS[NUM_TARGET_COLORS] =
+    {
+        frc::Color(0.143, 0.427, 0.429),        // BLUE
+        frc::Color(0.197, 0.561, 0.240),        // GREEN
+        frc::Color(0.561, 0.232, 0.114),        // RED
+        frc::Color(0.361, 0.524, 0.113)         // YELLOW
+    };
+
+    // Game specific message characters
+    static const char               GAME_DATA_BLUE                  = 'B';
+    static const char               GAME_DATA_GREEN                 = 'G';
+    static const char               GAME_DATA_RED                   = 'R';
+    static const char               GAME_DATA_YELLOW                = 'Y';
+
+private:
+
+    // Whether two colors are next to each other on the panel
+    static bool IsAdjacent(WheelColor first, WheelColor second);
+
+    // Take a new reading and count a transition if a new color settled
+    void TrackColor(WheelColor detectedColor);
+
+    // Bins per channel in the classification table
+    static const unsigned           TABLE_BINS                      = 32U;
+
+    uint8_t         m_ClassificationTable[TABLE_BINS][TABLE_BINS];
+    Mode            m_Mode;
+    WheelColor      m_StableColor;
+    WheelColor      m_CandidateColor;
+    WheelColor      m_SensorTargetColor;
+    unsigned        m_CandidateReadCount;
+    unsigned        m_TransitionCount;
+    unsigned        m_LoopCount;
+
+    // Readings farther than this from every target are left unknown
+    static constexpr double         MAX_MATCH_DISTANCE              = 0.08;
+
+    // Reads in a row a color must be seen for before it counts
+    static const unsigned           STABLE_COLOR_READS              = 2U;
+
+    // The panel has eight segments, 3.5 rotations is in the middle of the allowed 3 to 5
+    static const unsigned           TRANSITIONS_PER_ROTATION        = 8U;
+    static const unsigned           ROTATION_CONTROL_TRANSITIONS    = (TRANSITIONS_PER_ROTATION * 7U) / 2U;
+
+    // A stuck or blocked sensor gives up after this long (loops)
+    static const unsigned           MAX_CONTROL_LOOPS               = 500U;
+
+    static constexpr double         ROTATION_CONTROL_SPEED          = 0.60;
+    static constexpr double         POSITION_CONTROL_SPEED          = 0.25;
+
+    ColorWheel(const ColorWheel &) = delete;
+    ColorWheel & operator=(const ColorWheel &) = delete;
+};
+
+#endif // COLORWHEEL_HPP
@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   ControllerSnapshot.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for capturing all of a controller's inputs once per
+/// robot loop.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CONTROLLERSNAPSHOT_HPP
+#define CONTROLLERSNAPSHOT_HPP
+
+// SYSTEM INCLUDES
+#include <cstdint>                      // for uint32_t
+
+// C INCLUDES
+#include "frc/GenericHID.h"             // for GenericHID
+
+// C++ INCLUDES
+#include "RobotLogRecords.hpp"          // for RobotLogRecords::ControllerData
+
+using namespace frc;
+
+
+////////////////////////////////////////////////////////////////
+/// @class ControllerSnapshot
+///
+/// Holds every button, axis and the POV of one controller as
+/// read at the top of the loop.  All the sequences look at the
+/// same inputs instead of each asking the driver station again,
+/// so a loop can't see a button as both pressed and released.
+/// Buttons are kept as a bitmask, which lets the press and
+/// release edges for all of them be found at once.  Button
+/// numbers are one based, like GenericHID::GetRawButton().
+///
+////////////////////////////////////////////////////////////////
+class ControllerSnapshot
+{
+public:
+
+    // Constructor
+    ControllerSnapshot();
+
+    // Read the latest inputs, call once per loop
+    void Update(GenericHID * pJoystick);
+
+    // Copy the inputs into a match log record
+    void FillLogData(RobotLogRecords::ControllerData & rData) const;
+
+    // Whether a button is held
+    inline bool GetButton(int button) const
+    {
+        return ((m_Buttons & GetButtonMask(button)) != 0U);
+    }
+
+    // Whether a button was pressed since the last update
+    inline bool IsPressed(int button) const
+    {
+        return ((m_PressedButtons & GetButtonMask(button)) != 0U);
+    }
+
+    // Whether a button was released since the last update
+    inline bool IsReleased(int button) const
+    {
+        return ((m_ReleasedButtons & GetButtonMask(button)) != 0U);
+    }
+
+    // A raw axis value, zero for axes the controller doesn't have
+    inline double GetAxis(int axis) const
+    {
+        return ((axis >= 0) && (axis < static_cast<int>(MAX_AXES))) ? m_Axes[axis] : 0.0;
+    }
+
+    // The POV angle, -1 when it isn't pressed
+    inline int GetPOV() const
+    {
+        return m_Pov;
+    }
+
+    // The controller's own x/y mapping (which can combine axes)
+    inline double GetX() const
+    {
+        return m_X;
+    }
+
+    inline double GetY() const
+    {
+        return m_Y;
+    }
+
+private:
+
+    // The bit for a button, button zero (no button) and out of range buttons have none
+    static inline uint32_t GetButtonMask(int button)
+    {
+        return ((button > 0) && (button <= static_cast<int>(MAX_BUTTONS))) ? (1U << (button - 1)) : 0U;
+    }
+
+    // The driver station supports this many of each
+    static const unsigned   MAX_BUTTONS = 32U;
+    static const unsigned   MAX_AXES = 12U;
+
+    uint32_t                m_Buttons;
+    uint32_t                m_PressedButtons;
+    uint32_t                m_ReleasedButtons;
+    double                  m_Axes[MAX_AXES];
+    int                     m_Pov;
+    double                  m_X;
+    double                  m_Y;
+
+    ControllerSnapshot(const ControllerSnapshot &) = delete;
+    ControllerSnapshot & operator=(const ControllerSnapshot &) = delete;
+};
+
+#endif // CONTROLLERSNAPSHOT_HPP
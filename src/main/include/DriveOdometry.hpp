@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   DriveOdometry.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for tracking where the robot is on the field.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DRIVEODOMETRY_HPP
+#define DRIVEODOMETRY_HPP
+
+// SYSTEM INCLUDES
+#include <cstdint>                      // for uint64_t
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class DriveOdometry
+///
+/// Dead reckoning for the differential drive.  Each loop the
+/// distance each side travelled comes from the encoders and the
+/// heading comes from the gyro, and the pose is moved along the
+/// arc between them.  The last second or so of poses is kept
+/// with timestamps so a vision measurement can be compared with
+/// where the robot was when the frame was captured rather than
+/// where it is now.  Any correction found that way is applied
+/// to the current pose and the history together.
+///
+/// Poses are in inches with x forward and y to the left of the
+/// starting pose, and the heading is in radians counter
+/// clockwise.  The gyro reads clockwise, so callers negate it.
+///
+////////////////////////////////////////////////////////////////
+class DriveOdometry
+{
+public:
+
+    // Where the robot is
+    struct Pose
+    {
+        double      m_X;
+        double      m_Y;
+        double      m_Heading;
+    };
+
+    // Constructor
+    DriveOdometry();
+
+    // Start over from a known pose
+    void Reset(const Pose & rPose, double leftInches, double rightInches, double gyroHeading, uint64_t timestampUs);
+
+    // The encoders were zeroed, keep tracking from the new values
+    void ResetEncoders(double leftInches, double rightInches);
+
+    // Move the pose by what the encoders and gyro saw since the last update
+    void Update(double leftInches, double rightInches, double gyroHeading, uint64_t timestampUs);
+
+    // Correct the pose with a bearing (and optionally range) to a known target
+    bool AddVisionMeasurement(double bearing, double rangeInches, double targetX, double targetY, uint64_t captureTimestampUs);
+
+    // The current pose
+    inline const Pose & GetPose() const
+    {
+        return m_Pose;
+    }
+
+    // Where the robot was at some recent time, returns false if it's outside the history
+    bool GetPoseAt(uint64_t timestampUs, Pose & rPose) const;
+
+    // Wrap an angle to (-pi, pi]
+    static double WrapAngle(double angle);
+
+private:
+
+    // One pose in the history
+    struct HistoryEntry
+    {
+        uint64_t    m_TimestampUs;
+        Pose        m_Pose;
+    };
+
+    // Add the current pose to the history
+    void RecordHistory(uint64_t timestampUs);
+
+    // About 1.25 seconds of 20ms loops, longer than any vision latency
+    static const unsigned   HISTORY_SIZE                    = 64U;
+    // How much of the difference a vision measurement corrects each time
+    static constexpr double VISION_CORRECTION_GAIN          = 0.2;
+    // Measurements that disagree by more than this are assumed to be wrong
+    static constexpr double MAX_VISION_CORRECTION_INCHES    = 36.0;
+    // Faster than the robot can go in one loop, so anything more is an encoder reset
+    static constexpr double MAX_ENCODER_CHANGE_INCHES       = 12.0;
+
+    Pose                    m_Pose;
+    double                  m_LastLeftInches;
+    double                  m_LastRightInches;
+    double                  m_LastGyroHeading;
+    double                  m_HeadingOffset;                // Pose heading minus gyro heading
+    HistoryEntry            m_History[HISTORY_SIZE];
+    unsigned                m_HistoryCount;
+    unsigned                m_NextHistoryEntry;
+
+    DriveOdometry(const DriveOdometry &) = delete;
+    DriveOdometry & operator=(const DriveOdometry &) = delete;
+};
+
+#endif // DRIVEODOMETRY_HPP
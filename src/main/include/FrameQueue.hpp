@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   FrameQueue.hpp
+/// @author David Stalter
+///
+/// @details
+/// A template class for handing camera frames, and information about them, from
+/// one vision stage thread to the next.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FRAMEQUEUE_HPP
+#define FRAMEQUEUE_HPP
+
+// SYSTEM INCLUDES
+#include <atomic>                               // for std::atomic
+#include <chrono>                               // for std::chrono
+#include <condition_variable>                   // for std::condition_variable
+#include <mutex>                                // for std::mutex
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "opencv2/core/core.hpp"                // for cv::Mat
+
+
+////////////////////////////////////////////////////////////////
+/// @class FrameQueue
+///
+/// A bounded queue between one producer and one consumer.  Each
+/// frame travels with an InfoType describing it.  The slots own
+/// their cv::Mat buffers and frames are swapped in and out
+/// rather than copied, so buffers circulate between the stages
+/// without allocating once their sizes settle.  When the
+/// queue is full the oldest frame is dropped, which keeps the
+/// latency bounded when the consumer falls behind.
+///
+////////////////////////////////////////////////////////////////
+template <typename InfoType, unsigned CAPACITY>
+class FrameQueue
+{
+public:
+
+    static_assert(CAPACITY > 0U, "Frame queue must have at least one slot.");
+
+    // Constructor
+    FrameQueue() :
+        m_Mutex(),
+        m_Condition(),
+        m_Slots(),
+        m_HeadIndex(0U),
+        m_Count(0U),
+        m_NumDropped(0U)
+    {
+    }
+
+    // Hand a frame to the consumer, the caller gets back a stale buffer to fill next
+    inline void Push(cv::Mat & rFrame, const InfoType & rInfo);
+
+    // Take the oldest frame, returns false if none arrives before the timeout
+    template <typename Rep, typename Period>
+    inline bool Pop(cv::Mat & rFrame, InfoType & rInfo, const std::chrono::duration<Rep, Period> & rTimeout);
+
+    // How many frames have been dropped because the consumer fell behind
+    inline unsigned GetNumDropped() const
+    {
+        return m_NumDropped;
+    }
+
+private:
+
+    struct Slot
+    {
+        cv::Mat     m_Frame;
+        InfoType    m_Info;
+    };
+
+    std::mutex                  m_Mutex;
+    std::condition_variable     m_Condition;
+    Slot                        m_Slots[CAPACITY];
+    unsigned                    m_HeadIndex;
+    unsigned                    m_Count;
+    std::atomic<unsigned>       m_NumDropped;
+
+    FrameQueue(const FrameQueue &) = delete;
+    FrameQueue & operator=(const FrameQueue &) = delete;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method FrameQueue<InfoType, CAPACITY>::Push
+///
+/// Swaps a frame into the next free slot, dropping the oldest
+/// frame first if the queue is full.  The caller's mat is left
+/// holding whatever buffer was in the slot.
+///
+////////////////////////////////////////////////////////////////
+template <typename InfoType, unsigned CAPACITY>
+inline void FrameQueue<InfoType, CAPACITY>::Push(cv::Mat & rFrame, const InfoType & rInfo)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Count == CAPACITY)
+        {
+            m_HeadIndex = (m_HeadIndex + 1U) % CAPACITY;
+            m_Count--;
+            m_NumDropped++;
+        }
+
+        Slot & rSlot = m_Slots[(m_HeadIndex + m_Count) % CAPACITY];
+        cv::swap(rSlot.m_Frame, rFrame);
+        rSlot.m_Info = rInfo;
+        m_Count++;
+    }
+
+    m_Condition.notify_one();
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method FrameQueue<InfoType, CAPACITY>::Pop
+///
+/// Waits for a frame and swaps it out of its slot.  The buffer
+/// the caller passes in goes back into the slot for reuse.
+///
+////////////////////////////////////////////////////////////////
+template <typename InfoType, unsigned CAPACITY>
+template <typename Rep, typename Period>
+inline bool FrameQueue<InfoType, CAPACITY>::Pop(cv::Mat & rFrame, InfoType & rInfo, const std::chrono::duration<Rep, Period> & rTimeout)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    if (!m_Condition.wait_for(lock, rTimeout, [this]() { return (m_Count > 0U); }))
+    {
+        return false;
+    }
+
+    Slot & rSlot = m_Slots[m_HeadIndex];
+    cv::swap(rSlot.m_Frame, rFrame);
+    rInfo = rSlot.m_Info;
+    m_HeadIndex = (m_HeadIndex + 1U) % CAPACITY;
+    m_Count--;
+
+    return true;
+}
+
+#endif // FRAMEQUEUE_HPP
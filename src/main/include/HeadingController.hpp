@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   HeadingController.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for a closed loop controller that turns the robot to a
+/// gyro heading.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HEADINGCONTROLLER_HPP
+#define HEADINGCONTROLLER_HPP
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class HeadingController
+///
+/// A PID controller for turning the robot to a heading.  The
+/// error is always the shortest way around the circle, so turns
+/// across the 0/360 boundary work and the robot never goes the
+/// long way.  The output is limited in size and in how fast it
+/// can change, which keeps the drive from jerking at the start
+/// of a turn.  It is updated once per robot loop.  A positive
+/// output increases the gyro angle (a right turn).
+///
+////////////////////////////////////////////////////////////////
+class HeadingController
+{
+public:
+
+    // Tuning for a controller, the gains are in output per degree
+    struct Gains
+    {
+        double      m_Kp;
+        double      m_Ki;
+        double      m_Kd;
+        double      m_IntegralLimit;            // Largest output the integral term can contribute
+        double      m_MaxOutputChange;          // Largest change in output from one loop to the next
+        double      m_ToleranceDegrees;         // How close counts as on target
+        double      m_MaxSettledRateDegrees;    // How little it can be moving per loop and count as stopped
+        unsigned    m_SettleLoops;              // Loops it must stay on target before it is settled
+    };
+
+    // Constructor
+    explicit HeadingController(const Gains & rGains);
+
+    // Begin a turn to a new heading
+    void Start(double targetAngle, double maxOutput);
+
+    // Run one loop of the controller, returns the turn output
+    double Update(double currentAngle);
+
+    // Whether the robot has stopped on the target heading
+    inline bool IsSettled() const
+    {
+        return (m_SettledLoopCount >= m_Gains.m_SettleLoops);
+    }
+
+    // The last error, in degrees
+    inline double GetError() const
+    {
+        return m_Error;
+    }
+
+    // The shortest signed turn from one angle to another (-180 -> 180)
+    static double GetShortestAngleError(double targetAngle, double currentAngle);
+
+private:
+
+    const Gains     m_Gains;
+    double          m_TargetAngle;
+    double          m_MaxOutput;
+    double          m_Error;
+    double          m_LastAngle;
+    double          m_IntegralSum;
+    double          m_Output;
+    unsigned        m_SettledLoopCount;
+    bool            m_bFirstUpdate;
+
+    HeadingController(const HeadingController &) = delete;
+    HeadingController & operator=(const HeadingController &) = delete;
+};
+
+#endif // HEADINGCONTROLLER_HPP
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   InputShaping.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains classes for shaping driver inputs before they reach the motors.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INPUTSHAPING_HPP
+#define INPUTSHAPING_HPP
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @struct InputShapingConfig
+///
+/// How one axis is shaped.  Inputs inside the deadband are
+/// zero, and the rest of the travel is stretched back out to
+/// the full range so output starts smoothly at the edge.  Expo
+/// blends in a cubic curve (0 is linear, 1 is fully cubic) for
+/// finer control near center.  The result is then scaled.
+///
+////////////////////////////////////////////////////////////////
+struct InputShapingConfig
+{
+    double  m_Deadband;
+    double  m_Expo;
+    double  m_Scale;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @class InputShapingTable
+///
+/// An axis shaping curve baked into a lookup table.  Tables are
+/// built at compile time, and evaluating one is a single
+/// interpolation no matter what the curve is, so the cost per
+/// loop never changes with the configuration.  Only the positive
+/// half is stored, the curves are the same mirrored.
+///
+////////////////////////////////////////////////////////////////
+class InputShapingTable
+{
+public:
+
+    // Constructor, builds the table for a configuration
+    constexpr explicit InputShapingTable(const InputShapingConfig & rConfig) :
+        m_Table()
+    {
+        for (unsigned i = 0U; i < TABLE_SIZE; i++)
+        {
+            m_Table[i] = Shape(static_cast<double>(i) / (TABLE_SIZE - 1U), rConfig);
+        }
+    }
+
+    // Get the shaped value for an input from -1 to +1
+    constexpr double Evaluate(double input) const
+    {
+        const bool bNegative = (input < 0.0);
+        double magnitude = bNegative ? -input : input;
+        if (magnitude > 1.0)
+        {
+            magnitude = 1.0;
+        }
+
+        const double position = magnitude * (TABLE_SIZE - 1U);
+        unsigned index = static_cast<unsigned>(position);
+        if (index >= (TABLE_SIZE - 1U))
+        {
+            index = TABLE_SIZE - 2U;
+        }
+        const double fraction = position - index;
+        const double output = m_Table[index] + ((m_Table[index + 1U] - m_Table[index]) * fraction);
+
+        return bNegative ? -output : output;
+    }
+
+private:
+
+    // The math for one point of the curve, only ever run to build a table
+    static constexpr double Shape(double magnitude, const InputShapingConfig & rConfig)
+    {
+        if (magnitude <= rConfig.m_Deadband)
+        {
+            return 0.0;
+        }
+
+        const double stretched = (magnitude - rConfig.m_Deadband) / (1.0 - rConfig.m_Deadband);
+        const double curved = ((1.0 - rConfig.m_Expo) * stretched) + (rConfig.m_Expo * stretched * stretched * stretched);
+        return curved * rConfig.m_Scale;
+    }
+
+    // Points from 0 to 1, enough that interpolating hides the steps
+    static const unsigned TABLE_SIZE = 65U;
+
+    double m_Table[TABLE_SIZE];
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @class SlewRateLimiter
+///
+/// Limits how fast an output can build up from one loop to the
+/// next.  Asking the motors for full power all at once pulls
+/// enough current to brown out the robot.  Backing off toward
+/// zero is not limited, so the robot still stops right away,
+/// and a reversal drops to zero first and then builds up.
+///
+////////////////////////////////////////////////////////////////
+class SlewRateLimiter
+{
+public:
+
+    // Constructor
+    explicit SlewRateLimiter(double maxIncreasePerLoop) :
+        m_MaxIncreasePerLoop(maxIncreasePerLoop),
+        m_Value(0.0)
+    {
+    }
+
+    // Move toward a new output, returns what the output should be this loop
+    inline double Apply(double target)
+    {
+        if ((target * m_Value) < 0.0)
+        {
+            // Reversing, stop first
+            m_Value = 0.0;
+        }
+
+        if ((target > 0.0) && (target > m_Value))
+        {
+            m_Value = (target < (m_Value + m_MaxIncreasePerLoop)) ? target : (m_Value + m_MaxIncreasePerLoop);
+        }
+        else if ((target < 0.0) && (target < m_Value))
+        {
+            m_Value = (target > (m_Value - m_MaxIncreasePerLoop)) ? target : (m_Value - m_MaxIncreasePerLoop);
+        }
+        else
+        {
+            m_Value = target;
+        }
+
+        return m_Value;
+    }
+
+    // Forget the last output, used when something else drove the motors
+    inline void Reset(double value = 0.0)
+    {
+        m_Value = value;
+    }
+
+private:
+
+    const double    m_MaxIncreasePerLoop;
+    double          m_Value;
+};
+
+#endif // INPUTSHAPING_HPP
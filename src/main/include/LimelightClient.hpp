@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   LimelightClient.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for receiving limelight results from network tables.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIMELIGHTCLIENT_HPP
+#define LIMELIGHTCLIENT_HPP
+
+// SYSTEM INCLUDES
+#include <atomic>                               // for std::atomic
+#include <cstdint>                              // for sized integer types
+#include <memory>                               // for std::shared_ptr
+
+// C INCLUDES
+#include "networktables/NetworkTable.h"         // for nt::NetworkTable
+#include "networktables/NetworkTableEntry.h"    // for nt::NetworkTableEntry
+
+// C++ INCLUDES
+#include "SeqLockSnapshot.hpp"                  // for SeqLockSnapshot
+
+
+////////////////////////////////////////////////////////////////
+/// @class LimelightClient
+///
+/// Class that keeps the latest result from the limelight.  The
+/// network table entries are looked up once, and once per robot
+/// loop Update() checks when each result entry last changed.
+/// Network tables only sends a value that changed, so no single
+/// entry is seen every frame, but a frame changes at least one
+/// of them.  Any change copies the whole result into a
+/// snapshot, once per loop however many entries changed.
+/// Readers never touch network tables, and the sequence number
+/// in the snapshot tells a new frame from one that has already
+/// been used, so controllers can run once per frame.
+///
+////////////////////////////////////////////////////////////////
+class LimelightClient
+{
+public:
+
+    // One frame from the limelight
+    struct Frame
+    {
+        double      m_TargetX;                  // Horizontal angle to the target in degrees, positive is to the right
+        double      m_TargetY;                  // Vertical angle to the target in degrees, positive is up
+        double      m_TargetArea;               // Percent of the image the target covers
+        double      m_LatencyMs;                // Pipeline latency plus image capture
+        uint64_t    m_CaptureTimestampUs;       // FPGA time the frame was captured
+        bool        m_bTargetValid;             // Whether a target is in view
+    };
+
+    // A frame along with when it arrived and its sequence number
+    typedef SeqLockSnapshot<Frame>::Sample FrameSample;
+
+    // Look up the entries (call once the limelight table exists)
+    static void Initialize(std::shared_ptr<nt::NetworkTable> pLimelightTable);
+
+    // Take in a new frame if one came in (call from the robot loop, once per loop)
+    static void Update();
+
+    // Get the latest frame, returns false if none has come in yet
+    inline static bool GetLatestFrame(FrameSample & rSample)
+    {
+        return m_FrameSnapshot.Read(rSample);
+    }
+
+    // Get the latest frame only if it's newer than the last one used, and not too old
+    static bool GetNewFrame(uint32_t & rLastSequenceNumber, FrameSample & rSample);
+
+    // Change the limelight camera mode
+    static void SetCameraMode(int mode);
+
+    // Frames older than this are from a limelight that stopped sending
+    static const uint64_t       MAX_FRAME_AGE_US                = 250000U;
+
+private:
+
+    // Constructor
+    LimelightClient();
+
+    // Destructor, copy constructor, assignment operator
+    ~LimelightClient();
+
+    LimelightClient(const LimelightClient &) = delete;
+    LimelightClient & operator=(const LimelightClient &) = delete;
+
+    // MEMBER VARIABLES
+    static nt::NetworkTableEntry    m_TargetXEntry;
+    static nt::NetworkTableEntry    m_TargetYEntry;
+    static nt::NetworkTableEntry    m_TargetAreaEntry;
+    static nt::NetworkTableEntry    m_TargetValidEntry;
+    static nt::NetworkTableEntry    m_LatencyEntry;
+    static nt::NetworkTableEntry    m_CameraModeEntry;
+    static uint64_t                 m_LastChange;
+    static SeqLockSnapshot<Frame>   m_FrameSnapshot;
+    static std::atomic<bool>        m_bInitialized;
+
+    // Added to the pipeline latency, from the limelight docs
+    static constexpr double         CAPTURE_LATENCY_MS              = 11.0;
+};
+
+#endif // LIMELIGHTCLIENT_HPP
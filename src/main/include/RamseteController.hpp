@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RamseteController.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for a Ramsete trajectory following controller.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RAMSETECONTROLLER_HPP
+#define RAMSETECONTROLLER_HPP
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "DriveOdometry.hpp"            // for DriveOdometry::Pose
+#include "TrajectoryRecords.hpp"        // for TrajectoryRecords::Point
+
+
+////////////////////////////////////////////////////////////////
+/// @class RamseteController
+///
+/// Nonlinear feedback for following a trajectory with a
+/// differential drive.  The trajectory gives a velocity and
+/// turn rate to feed forward, and the error between where the
+/// robot is and where the trajectory says it should be (in the
+/// robot's frame) adjusts both.  Unlike steering at a point
+/// ahead, it also corrects being off to the side of the path.
+///
+////////////////////////////////////////////////////////////////
+class RamseteController
+{
+public:
+
+    // Gains
+    struct Gains
+    {
+        double  m_B;        // Like a proportional gain, per in^2
+        double  m_Zeta;     // Like a damping ratio
+    };
+
+    // Constructor
+    explicit RamseteController(const Gains & rGains) :
+        m_Gains(rGains)
+    {
+    }
+
+    // Work out the robot velocity (in/s) and turn rate (rad/s, counter clockwise) to follow a point
+    void Calculate(const DriveOdometry::Pose & rPose, const TrajectoryRecords::Point & rDesired, double & rVelocity, double & rTurnRate) const;
+
+private:
+
+    Gains                   m_Gains;
+
+    RamseteController(const RamseteController &) = delete;
+    RamseteController & operator=(const RamseteController &) = delete;
+};
+
+#endif // RAMSETECONTROLLER_HPP
@@ -12,7 +12,11 @@
 #define ROBOTCAMERA_HPP
 
 // SYSTEM INCLUDES
+#include <atomic>                               // for std::atomic
+#include <chrono>                               // for std::chrono
+#include <condition_variable>                   // for std::condition_variable
 #include <iostream>                             // for cout
+#include <mutex>                                // for std::mutex
 
 // C INCLUDES
 #include "frc/smartdashboard/SmartDashboard.h"  // for smart dashboard support
@@ -20,7 +24,9 @@
 #include "cameraserver/CameraServer.h"          // for camera support
 
 // C++ INCLUDES
+#include "FrameQueue.hpp"                      // for FrameQueue
 #include "RobotUtils.hpp"                       // for DisplayMessage()
+#include "SeqLockSnapshot.hpp"                  // for SeqLockSnapshot
 #include "opencv2/imgproc/imgproc.hpp"          // for vision structures and routines
 #include "opencv2/core/core.hpp"
 #include "opencv2/core/types.hpp"
@@ -37,6 +43,7 @@ using namespace frc;
 class RobotCamera
 {
 public:
+    friend class RobotBenchmarks;
     
     enum CameraType
     {
@@ -52,6 +59,44 @@ public:
         VISION_PROCESSOR    = 0,
         DRIVER_CAMERA       = 1
     };
+
+    enum ProcessingScale
+    {
+        // The value is what the capture resolution is divided by
+        FULL_SCALE          = 1,
+        HALF_SCALE          = 2,
+        QUARTER_SCALE       = 4
+    };
+    
+    // A structure to hold measurements of a contour
+    struct VisionTargetReport
+    {
+        double m_BoundingRectX;             // Bounding rectangle top left corner X
+        double m_BoundingRectY;             // Bounding rectangle top left corner Y
+        double m_BoundingRectWidth;         // Bounding rectangle width
+        double m_BoundingRectHeight;        // Bounding rectangle height
+        double m_BoundingRectArea;          // Bounding rectangle area
+        double m_BoundingRectAspectRatio;   // Bounding rectangle aspect ratio
+        
+        double m_Area;                      // Contour area
+        double m_Perimeter;                 // Contour perimeter
+        double m_ConvexHullArea;            // Contour convex hull area
+        double m_Solidity;                  // Contour solidity
+        double m_Vertices;                  // Contour vertices count
+        int    m_ContourIndex;              // Index of the contour in m_Contours
+
+        double m_PercentAreaToImageArea;    // Percentage of the area the contour occupies
+        double m_TrapezoidPercent;          // Likelihood that this is a true rectangle
+        double m_CameraDistanceX;           // Distance to the target from the camera, measured by width
+        double m_CameraDistanceY;           // Distance to the target from the camera, measured by height
+        double m_GroundDistance;            // Actual ground distance to the target
+        bool   m_bTargetInRange;            // Remember the last result from full vision processing
+        bool   m_bIsValid;                  // Indicates if the current report is valid
+        uint64_t m_CaptureTimestampUs;      // FPGA time the frame was captured, for latency compensation
+    };
+    
+    // A vision target report along with when it was published
+    typedef SeqLockSnapshot<VisionTargetReport>::Sample VisionTargetSample;
     
     // A structure for autonomous camera seeking operations
     struct AutonomousCamera
@@ -67,19 +112,27 @@ public:
 
     private:
 
-        static Timer m_AutoCameraTimer;
         static double m_IntegralSum;
+        static uint32_t m_LastFrameSequence;        // The last frame used, for LimelightClient::GetNewFrame()
 
         static constexpr double MAX_SEEK_MOTOR_SPEED = 0.25;
-        static constexpr double MAX_CAMERA_SEARCH_TIME_S = 5.0;
         static constexpr double KI = 0.0001;
         static constexpr double KP = 0.001; // 0.05 oscillates old robot
         static constexpr double INTEGRAL_SUM_LIMIT_VALUE = 10000.0;
     };
     
+    // Get the most recent vision target report (safe to call from any thread)
+    inline static bool GetVisionTargetReport(VisionTargetSample & rSample)
+    {
+        return m_VisionTargetSnapshot.Read(rSample);
+    }
+    
     // Set whether or not full vision processing can occur
     inline static void SetFullProcessing(bool bState);
     
+    // Set the resolution full vision processing runs at
+    inline static void SetProcessingScale(ProcessingScale scale);
+    
     // Pick a camera to use
     inline static void SetCamera(CameraType camera);
     
@@ -103,23 +156,42 @@ private:
     // Create the camera objects for any configured cameras
     static bool CreateConfiguredCameras();
 
+    // Switch to the camera the robot code asked for (vision thread only)
+    static void UpdateCurrentCamera();
+
     // Update values on the SmartDashboard
     static void UpdateSmartDashboard();
 
-    // Process a mat through the vision pipeline
-    static void ProcessImage();
+    // The pipelined vision stages after capture
+    static void ThresholdStageThread();
+    static void ContourStageThread();
+
+    struct FrameInfo;
+
+    // The two halves of the vision pipeline, one per stage
+    static void ThresholdImage(const cv::Mat & rSourceMat, FrameInfo & rFrameInfo);
+    static void AnalyzeContours(const cv::Mat & rBinaryMat, const FrameInfo & rFrameInfo);
     
     // Specific operations the vision pipeline will perform
-    static void FilterImageHsv();
-    static void ErodeImage();
-    static void FindContours();
-    static void FilterContours();
+    static void FilterImageHsv(const cv::Mat & rSourceMat, const cv::Rect & rSearchRegion);
+    static void ErodeImage(const cv::Rect & rSearchRegion);
+    static void FindContours(const cv::Mat & rBinaryMat, const cv::Rect & rSearchRegion);
+    static void FilterContours(const int scaleDivisor);
+
+    // Pick the part of the processed frame to search for the target
+    static cv::Rect GetSearchRegion(const cv::Size & processingSize, const int scaleDivisor);
+
+    // Track the target found in this frame for the next one
+    static void UpdateSearchRegion(const cv::Size & frameSize, const uint64_t captureTimestampUs);
 
     // Process the filtered contours to find the reflective tape
     static void FindReflectiveTapeTarget();
 
     // Compute some useful information about the reflective tape
-    static void CalculateReflectiveTapeValues();
+    static void CalculateReflectiveTapeValues(const cv::Size & frameSize);
+
+    // Send a mat to the dashboard if it's the one selected
+    inline static void PutDashboardFrame(cv::Mat & rMat);
 
     // Constructor
     RobotCamera();
@@ -132,31 +204,6 @@ private:
     
     // MEMBER VARIABLES
     
-    // A structure to hold measurements of a contour
-    struct VisionTargetReport
-    {
-        double m_BoundingRectX;             // Bounding rectangle top left corner X
-        double m_BoundingRectY;             // Bounding rectangle top left corner Y
-        double m_BoundingRectWidth;         // Bounding rectangle width
-        double m_BoundingRectHeight;        // Bounding rectangle height
-        double m_BoundingRectArea;          // Bounding rectangle area
-        double m_BoundingRectAspectRatio;   // Bounding rectangle aspect ratio
-        
-        double m_Area;                      // Contour area
-        double m_Perimeter;                 // Contour perimeter
-        double m_ConvexHullArea;            // Contour convex hull area
-        double m_Solidity;                  // Contour solidity
-        double m_Vertices;                  // Contour vertices count
-
-        double m_PercentAreaToImageArea;    // Percentage of the area the contour occupies
-        double m_TrapezoidPercent;          // Likelihood that this is a true rectangle
-        double m_CameraDistanceX;           // Distance to the target from the camera, measured by width
-        double m_CameraDistanceY;           // Distance to the target from the camera, measured by height
-        double m_GroundDistance;            // Actual ground distance to the target
-        bool   m_bTargetInRange;            // Remember the last result from full vision processing
-        bool   m_bIsValid;                  // Indicates if the current report is valid
-    };
-
     // A structure to hold information about a USB camera.
     // If Axis camera support is ever needed, this
     // will probably have to derive from a base class.
@@ -210,38 +257,89 @@ private:
         }
     };
     
+    // Information that travels through the pipeline with each frame
+    struct FrameInfo
+    {
+        uint64_t    m_CaptureTimestampUs;                   // FPGA time the frame was captured
+        cv::Rect    m_SearchRegion;                         // Part of the processed frame that was searched for the target
+        int         m_ScaleDivisor;                         // How much the frame was scaled down for processing
+    };
+    
+    // Where to look for the target in the next frame in capture coordinates, zero width means the whole frame
+    struct SearchRegion
+    {
+        int     m_X;
+        int     m_Y;
+        int     m_Width;
+        int     m_Height;
+    };
+    
     // Camera related variables
-    static std::shared_ptr<NetworkTable>        m_pLimelightNetworkTable;           // Network table for the limelight camera
     static UsbCameraStorage                     m_UsbCameras;                       // Memory for storing the USB camera objects
     static UsbCameraInfo *                      m_pCurrentUsbCamera;                // Pointer to the currently selected USB camera object   
     static cs::CvSource                         m_CameraOutput;                     // Output source for processed images
     static int                                  m_NumUsbCamerasPresent;             // How many cameras are present on the robot
+    static std::atomic<int>                     m_RequestedUsbCamera;               // Camera the robot code asked for, applied by the vision thread
+    static std::atomic<int>                     m_RequestedLimelightMode;           // Limelight mode the robot code asked for, applied by the limelight thread
+    static int                                  m_AppliedLimelightMode;             // Limelight mode last sent to the limelight (limelight thread only)
     
     // Mats
     static cv::Mat                              m_SourceMat;                        // The originating source mat from the current camera
-    static cv::Mat                              m_ResizeOutputMat;                  // Resized source mat
+    static cv::Mat                              m_ResizeOutputMat;                  // Source mat scaled down for processing
+    static cv::Mat                              m_HsvConvertedMat;                  // Source mat converted to HSV
     static cv::Mat                              m_HsvThresholdOutputMat;            // HSV filtered mat
     static cv::Mat                              m_ErodeOutputMat;                   // Erode output mat
     static cv::Mat                              m_ContoursMat;                      // Contours output mat
     static cv::Mat                              m_FilteredContoursMat;              // Filtered contours output mat
     static cv::Mat                              m_VisionTargetMat;                  // The best candidate vision target mat
-    static cv::Mat *                            m_pDashboardMat;                    // Pointer to which mat should currently be sent to the dashboard
+    static cv::Mat                              m_ThresholdInputMat;                // Frame being thresholded (pipelined threshold stage)
+    static cv::Mat                              m_ContourInputMat;                  // Frame being analyzed (pipelined contour stage)
+    static std::atomic<cv::Mat *>               m_pDashboardMat;                    // Pointer to which mat should currently be sent to the dashboard
+    
+    // Queues between the pipelined stages, two deep so the latency stays bounded
+    static const unsigned                       FRAME_QUEUE_DEPTH                   = 2U;
+    static FrameQueue<FrameInfo, FRAME_QUEUE_DEPTH> m_CaptureQueue;                 // Capture stage to threshold stage
+    static FrameQueue<FrameInfo, FRAME_QUEUE_DEPTH> m_ThresholdQueue;               // Threshold stage to contour stage
+    
+    // Target tracking, the contour stage decides the region and the threshold stage uses it
+    static SeqLockSnapshot<SearchRegion>        m_SearchRegionSnapshot;             // Region to search in the next frame
+    static SearchRegion                         m_TrackedSearchRegion;              // Last region published (contour stage only)
+    static unsigned                             m_TrackingMissCount;                // Frames in a row the tracked target wasn't found (contour stage only)
     
     // Image artifacts represented by std::vector
+    // These are reused every frame so steady state processing doesn't allocate
     static std::vector<std::vector<cv::Point>>  m_Contours;                         // Contours in the image
-    static std::vector<std::vector<cv::Point>>  m_FilteredContours;                 // Filtered contours in the image
+    static std::vector<cv::Vec4i>               m_ContourHierarchy;                 // Contour topology from findContours
+    static std::vector<cv::Point>               m_ConvexHull;                       // Convex hull of the contour being filtered
+    static const cv::Mat                        ERODE_KERNEL;                       // Structuring element for erosion (empty means 3x3)
     
     // Misc
-    static std::vector<VisionTargetReport>      m_ContourTargetReports;             // Stores information about the contours currently visible
+    static std::vector<VisionTargetReport>      m_ContourTargetReports;             // Stores information about the contours that passed filtering
     static VisionTargetReport                   m_VisionTargetReport;               // Information about the vision target
-    static bool                                 m_bDoFullProcessing;                // Indicates whether or not full image processing should occur
+    static SeqLockSnapshot<VisionTargetReport>  m_VisionTargetSnapshot;             // Latest vision target report for other threads
+    static std::atomic<bool>                    m_bDoFullProcessing;                // Indicates whether or not full image processing should occur
+    static std::atomic<int>                     m_ProcessingScaleDivisor;           // What the capture resolution is divided by for processing
     static int                                  m_HeartBeat;                        // Keep alive with the C++ dashboard
     
+    // Thread lifecycle
+    static std::mutex                           m_CameraThreadMutex;                // Guards the camera thread wake conditions
+    static std::condition_variable              m_CameraThreadCondition;            // The idle camera threads park on this
+    
     // CONSTANTS
     
     static const bool                           FRONT_USB_CAMERA_SUPPORTED          = true;
     static const bool                           BACK_USB_CAMERA_SUPPORTED           = false;
+    static const bool                           PIPELINED_PROCESSING                = true;
+    static const bool                           TARGET_TRACKING_ENABLED             = true;
+    static const unsigned                       TRACKING_MAX_MISSES                 = 5U;
+    static const int                            TRACKING_MIN_PADDING_PIXELS         = 16;
+    static constexpr double                     TRACKING_PADDING_RATIO              = 0.5;
     static const char *                         CAMERA_OUTPUT_NAME;
+    static const int                            LIMELIGHT_MODE_NOT_SET              = -1;
+    static const unsigned                       LIMELIGHT_TABLE_RETRY_START_MS      = 10U;
+    static const unsigned                       LIMELIGHT_TABLE_RETRY_MAX_MS        = 1000U;
+    static constexpr double                     GRAB_FRAME_TIMEOUT_S                = 0.5;
+    static const unsigned                       EXPECTED_MAX_CONTOURS               = 64U;
     
     static constexpr double                     TARGET_WIDTH_INCHES                 =  2.0;
     static constexpr double                     TARGET_HEIGHT_INCHES                = 16.0;
@@ -268,7 +366,30 @@ private:
 ////////////////////////////////////////////////////////////////
 inline void RobotCamera::SetLimelightMode(LimelightMode mode)
 {
-    m_pLimelightNetworkTable->PutNumber("camMode", static_cast<int>(mode));
+    // The limelight thread owns the network table and sends the mode
+    {
+        std::lock_guard<std::mutex> lock(m_CameraThreadMutex);
+        m_RequestedLimelightMode = static_cast<int>(mode);
+    }
+    m_CameraThreadCondition.notify_all();
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::PutDashboardFrame
+///
+/// Sends a mat to the dashboard if it is the one currently
+/// selected.  Each stage calls this with the mats it owns, so a
+/// mat is only ever sent by the thread that writes it.
+///
+////////////////////////////////////////////////////////////////
+inline void RobotCamera::PutDashboardFrame(cv::Mat & rMat)
+{
+    if (m_pDashboardMat == &rMat)
+    {
+        m_CameraOutput.PutFrame(rMat);
+    }
 }
 
 
@@ -282,9 +403,17 @@ inline void RobotCamera::SetLimelightMode(LimelightMode mode)
 ////////////////////////////////////////////////////////////////
 inline void RobotCamera::SetFullProcessing(bool bState)
 {
-    m_bDoFullProcessing = bState;
+    {
+        std::lock_guard<std::mutex> lock(m_CameraThreadMutex);
+        m_bDoFullProcessing = bState;
+    }
     
-    if (!m_bDoFullProcessing)
+    if (bState)
+    {
+        // The vision thread parks while processing is off
+        m_CameraThreadCondition.notify_all();
+    }
+    else
     {
         // If processing was previously enabled,
         // need to switch back to the default mat.
@@ -295,10 +424,26 @@ inline void RobotCamera::SetFullProcessing(bool bState)
 
 
 
+////////////////////////////////////////////////////////////////
+/// @method RobotCamera::SetProcessingScale
+///
+/// This method sets the resolution full vision processing runs
+/// at.  Smaller scales trade accuracy for frame rate.  The
+/// reports are always in capture resolution coordinates.
+///
+////////////////////////////////////////////////////////////////
+inline void RobotCamera::SetProcessingScale(ProcessingScale scale)
+{
+    m_ProcessingScaleDivisor = static_cast<int>(scale);
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 /// @method RobotCamera::SetCamera
 ///
-/// This method sets which camera is active.
+/// This method sets which camera is active.  The switch itself
+/// happens on the vision thread, which owns the current camera.
 ///
 ////////////////////////////////////////////////////////////////
 inline void RobotCamera::SetCamera(CameraType camera)
@@ -306,7 +451,11 @@ inline void RobotCamera::SetCamera(CameraType camera)
     // Make sure the camera is present before trying to switch
     if (m_UsbCameras.m_CamerasInfo[camera].m_bIsPresent)
     {
-        m_pCurrentUsbCamera = &m_UsbCameras.m_CamerasInfo[camera];
+        {
+            std::lock_guard<std::mutex> lock(m_CameraThreadMutex);
+            m_RequestedUsbCamera = static_cast<int>(camera);
+        }
+        m_CameraThreadCondition.notify_all();
     }
     else
     {
@@ -324,7 +473,7 @@ inline void RobotCamera::SetCamera(CameraType camera)
 ////////////////////////////////////////////////////////////////
 inline void RobotCamera::ToggleCamera()
 {
-    CameraType nextCam = (m_pCurrentUsbCamera->CAM_TYPE == FRONT_USB) ? BACK_USB : FRONT_USB;
+    CameraType nextCam = (m_RequestedUsbCamera == FRONT_USB) ? BACK_USB : FRONT_USB;
     SetCamera(nextCam);
 }
 
@@ -12,7 +12,9 @@
 #define ROBOTI2C_HPP
 
 // SYSTEM INCLUDES
-// <none>
+#include <atomic>                                           // for std::atomic
+#include <condition_variable>                               // for std::condition_variable
+#include <mutex>                                            // for std::mutex
 
 // C INCLUDES
 #include "frc/DigitalInput.h"                               // for DigitalInput type
@@ -20,7 +22,10 @@
 #include "frc/I2C.h"                                        // for interacting with an I2C port
 
 // C++ INCLUDES
+#include "Bno055.hpp"                                       // for reading the BNO055 directly
 #include "RobotUtils.hpp"                                   // for DisplayMessage()
+#include "SeqLockSnapshot.hpp"                              // for sharing data with the robot loop
+#include "SonarFilter.hpp"                                  // for filtering sonar readings
 #include "../../Rioduino/RoborioRioduinoSharedData.hpp"     // for shared data structures
 
 /// CAUTION: Forcibly remove build objects if changes       ///
@@ -41,6 +46,7 @@ using namespace RoborioRioduinoSharedData;
 class RobotI2c
 {
 public:
+    friend class LogReplay;
     
     // The vision thread
     static void I2cThread();
@@ -52,11 +58,29 @@ public:
     // Set the rate for how fast the thread should run
     inline static void SetThreadUpdateRate(unsigned updateRateMs);
     
-    // Retrieve the I2C sonar data
-    inline static SonarI2cData * GetSonarData();
+    // Start or stop the thread talking to the RIOduino (it sleeps while stopped)
+    static void SetThreadEnabled(bool bEnabled);
+    
+    // Set how long to wait for the RIOduino to signal data is ready
+    inline static void SetHandshakeTimeout(unsigned timeoutMs);
+    
+    // The latest filtered sonar data along with when it was received
+    typedef SeqLockSnapshot<SonarI2cData>::Sample SonarSample;
+    
+    // Retrieve the latest filtered sonar data (never blocks)
+    inline static bool GetSonarSample(SonarSample & rSample);
+    
+    // Retrieve the filtered I2C sonar data
+    inline static bool GetSonarData(SonarI2cData & rSonarData);
+    
+    // The latest gyro data along with when it was received
+    typedef SeqLockSnapshot<GyroI2cData>::Sample GyroSample;
+    
+    // Retrieve the latest gyro data (never blocks)
+    inline static bool GetGyroSample(GyroSample & rSample);
     
     // Retrieve the I2C gyro data
-    inline static GyroI2cData * GetGyroData();
+    inline static bool GetGyroData(GyroI2cData & rGyroData);
 
 private:
     
@@ -78,8 +102,23 @@ private:
     // Unpack the received I2C data
     static void UnpackI2cData();
     
+    // Check the received frame's metadata, length and CRC
+    static bool IsI2cFrameValid();
+    
+    // Unpack one payload from a frame
+    static void UnpackI2cPayload(I2cDataSelection selection, const uint8_t * pPayload, uint8_t size, uint64_t & rTimestampUs);
+    
     // Update the I2c data structures
     inline static void UpdateI2cData();
+    
+    // Wait for the RIOduino to signal new data, returns false on a timeout
+    static bool WaitForRioduinoHandshake();
+    
+    // Sleep until the thread is enabled
+    static void WaitForThreadEnabled();
+    
+    // Read the roboRIO's own BNO055 at a fixed rate, and the RIOduino for the sonar (never returns)
+    static void RunBno055();
 
     // Constructor
     RobotI2c();
@@ -98,19 +137,40 @@ private:
     
     // I2C transactions
     static I2cCommand       m_I2cRioduinoCommand;
-    static I2cData          m_I2cRioduinoData;
+    static I2cDataFrame     m_I2cRioduinoData;              // Receive buffer, only touched by the I2C thread
+    static SeqLockSnapshot<GyroI2cData> m_GyroSnapshot;     // Last valid gyro data, published for the robot loop
+    static SonarFilter      m_SonarFilter;                  // Only touched by the I2C thread
+    static SeqLockSnapshot<SonarI2cData> m_SonarSnapshot;   // Last filtered sonar data, published for the robot loop
     static I2C              m_I2cRioduino;
+    static Bno055           m_Bno055;
     static bool             m_bI2cDataValid;
     static bool             m_bI2cCommandReady;
     
     // Thread configuration
     static ThreadPhase      m_ThreadPhase;
     static unsigned int     m_ThreadUpdateRateMs;
+    static unsigned int     m_HandshakeTimeoutMs;
+    static std::atomic<bool>        m_bThreadEnabled;
+    static std::mutex               m_ThreadEnableMutex;
+    static std::condition_variable  m_ThreadEnableCondition;
     //std::lock_guard<wpi::mutex> lock(digitalI2CMXPMutex);
     
     // Counters
     static unsigned int     m_NumValidTransactions;
     static unsigned int     m_NumInvalidTransactions;
+    static unsigned int     m_NumRepeatedFrames;            // Same sequence as the last frame, no new data
+    static unsigned int     m_NumMissedFrames;              // Gaps in the frame sequence
+    static uint8_t          m_LastFrameSequence;
+    static unsigned int     m_LastSampleAgeMs;              // How old the RIOduino said the last frame was
+    static bool             m_bFrameSequenceValid;
+    
+    // Handshake statistics (time from trigger to the RIOduino's data ready edge)
+    static double           m_HandshakeStartTimestampS;
+    static unsigned int     m_NumHandshakes;
+    static unsigned int     m_NumHandshakeTimeouts;
+    static unsigned int     m_LastHandshakeLatencyUs;
+    static unsigned int     m_MaxHandshakeLatencyUs;
+    static uint64_t         m_TotalHandshakeLatencyUs;
     
     static const int        ROBORIO_SIGNAL_DIO_PIN  = 8;
     static const int        RIODUINO_SIGNAL_DIO_PIN = 9;
@@ -118,6 +178,22 @@ private:
     static const bool       DEBUG_I2C_TRANSACTIONS  = false;
     static const unsigned   DEFAULT_UPDATE_RATE_MS  = 60U;
     static const unsigned   INITIALIZING_DELAY_MS   = 20U;
+    static const unsigned   DEFAULT_HANDSHAKE_TIMEOUT_MS = 20U;
+    
+    // Where the gyro comes from.  With the BNO055 wired to the
+    // roboRIO, the thread runs at the BNO055 rate and reads the
+    // RIOduino in between for the sonar (its gyro frames are
+    // ignored once the BNO055 is running, so there is only one
+    // source).  Otherwise the RIOduino provides both.  The
+    // BNO055 is on the MXP port with the RIOduino, the onboard
+    // port doesn't handle the BNO055 stretching the clock.
+    static const bool       USE_ROBORIO_BNO055      = true;
+    static const unsigned   BNO055_UPDATE_RATE_MS   = 10U;
+    static const unsigned   BNO055_RETRY_DELAY_MS   = 1000U;
+    static const unsigned   BNO055_MAX_INITIALIZE_ATTEMPTS = 5U;
+    
+    // A handshake would hold up the BNO055 reads, only a streaming RIOduino can share the thread
+    static_assert(!USE_ROBORIO_BNO055 || I2C_STREAMING_MODE, "The roboRIO BNO055 needs the RIOduino in streaming mode.");
 };
 
 
@@ -136,6 +212,20 @@ inline void RobotI2c::SetThreadUpdateRate(unsigned updateRateMs)
 
 
 
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::SetHandshakeTimeout
+///
+/// Sets how long the I2C thread will wait for the RIOduino to
+/// indicate data is ready before giving up on a transaction.
+///
+////////////////////////////////////////////////////////////////
+inline void RobotI2c::SetHandshakeTimeout(unsigned timeoutMs)
+{
+    m_HandshakeTimeoutMs = timeoutMs;
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 /// @method RobotI2c::SendI2cCommand
 ///
@@ -168,53 +258,73 @@ inline void RobotI2c::UpdateI2cData()
 
 
 ////////////////////////////////////////////////////////////////
-/// @method RobotI2c::GetSonarData
+/// @method RobotI2c::GetSonarSample
 ///
-/// Returns the I2C sonar data from the RIOduino or a nullptr if
-/// the data isn't valid.
+/// Copies out the most recent filtered sonar data along with
+/// when its packet was received.  Returns false if no sonar
+/// data has arrived yet.
 ///
 ////////////////////////////////////////////////////////////////
-inline SonarI2cData * RobotI2c::GetSonarData()
+inline bool RobotI2c::GetSonarSample(SonarSample & rSample)
 {
-    SonarI2cData * pSonarData = nullptr;
+    return m_SonarSnapshot.Read(rSample);
+}
 
-    if (m_I2cRioduinoData.m_DataSelection == I2cDataSelection::SONAR_DATA)
-    {
-        pSonarData = &m_I2cRioduinoData.m_DataBuffer.m_SonarData;
-    }
-    else
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::GetSonarData
+///
+/// Copies out the filtered sonar data from the RIOduino.
+/// Returns false if no sonar data has arrived yet.
+///
+////////////////////////////////////////////////////////////////
+inline bool RobotI2c::GetSonarData(SonarI2cData & rSonarData)
+{
+    SonarSample sample;
+    if (!m_SonarSnapshot.Read(sample))
     {
-        // Since this is an interface method, getting here means the I2C thread is in the middle
-        // of an update, so there's no valid data to return (between memset and transaction calls).
+        return false;
     }
     
-    return pSonarData;
+    rSonarData = sample.m_Data;
+    return true;
 }
 
 
 
 ////////////////////////////////////////////////////////////////
-/// @method RobotI2c::GetGyroData
+/// @method RobotI2c::GetGyroSample
 ///
-/// Returns the I2C gyro data from the RIOduino or a nullptr if
-/// the data isn't valid.
+/// Copies out the most recent gyro data along with when its
+/// frame was received.  Returns false if no gyro data has
+/// arrived yet.
 ///
 ////////////////////////////////////////////////////////////////
-inline GyroI2cData * RobotI2c::GetGyroData()
+inline bool RobotI2c::GetGyroSample(GyroSample & rSample)
 {
-    GyroI2cData * pGyroData = nullptr;
+    return m_GyroSnapshot.Read(rSample);
+}
 
-    if (m_I2cRioduinoData.m_DataSelection == I2cDataSelection::GYRO_DATA)
-    {
-        pGyroData = &m_I2cRioduinoData.m_DataBuffer.m_GyroData;
-    }
-    else
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotI2c::GetGyroData
+///
+/// Copies out the I2C gyro data from the RIOduino.  Returns
+/// false if no gyro data has arrived yet.
+///
+////////////////////////////////////////////////////////////////
+inline bool RobotI2c::GetGyroData(GyroI2cData & rGyroData)
+{
+    GyroSample sample;
+    if (!m_GyroSnapshot.Read(sample))
     {
-        // Since this is an interface method, getting here means the I2C thread is in the middle
-        // of an update, so there's no valid data to return (between memset and transaction calls).
+        return false;
     }
     
-    return pGyroData;
+    rGyroData = sample.m_Data;
+    return true;
 }
 
 #endif // ROBOTI2C_HPP
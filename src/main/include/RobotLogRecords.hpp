@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotLogRecords.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains the layout of the binary match log.  Shared between the robot code
+/// and the offline log decoder, so it can only use standard headers.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROBOTLOGRECORDS_HPP
+#define ROBOTLOGRECORDS_HPP
+
+// SYSTEM INCLUDES
+#include <cstdint>                      // for sized integer types
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @namespace RobotLogRecords
+///
+/// A log file is a file header followed by fixed size records.
+/// Every record is the same size, so the decoder can always
+/// find the next one even if it doesn't understand a type.
+/// Both the roboRIO and a PC are little endian with IEEE
+/// floats, so the structures are written to the file as is.
+///
+////////////////////////////////////////////////////////////////
+namespace RobotLogRecords
+{
+    // Bump when the layout or meaning of a record changes
+    static const uint16_t   LOG_VERSION             = 3U;
+    static const char       LOG_MAGIC[4]            = {'Y', 'T', 'A', 'L'};
+    static const unsigned   RECORD_SIZE_BYTES       = 128U;
+    static const unsigned   RECORD_PAYLOAD_BYTES    = 112U;
+    static const unsigned   LOGGED_AXES             = 6U;
+    static const unsigned   TEXT_RECORD_BYTES       = RECORD_PAYLOAD_BYTES - sizeof(uint32_t);
+
+    enum RecordType : uint8_t
+    {
+        RECORD_UNUSED,
+        RECORD_LOOP,
+        RECORD_TEXT
+    };
+
+    // Header flags
+    static const uint8_t    TEXT_CONTINUES_FLAG     = 0x01U;
+
+    // The robot mode of records that don't belong to one, like text
+    static const uint8_t    NO_ROBOT_MODE           = 0xFFU;
+
+    struct FileHeader
+    {
+        char        m_Magic[4];
+        uint16_t    m_Version;
+        uint16_t    m_RecordSize;
+    };
+
+    struct RecordHeader
+    {
+        uint64_t    m_TimestampUs;      // Since the logger started
+        uint32_t    m_Sequence;         // Counts every record offered, gaps mean records were dropped
+        uint8_t     m_Type;
+        uint8_t     m_RobotMode;
+        uint8_t     m_Length;           // Bytes of text in a text record
+        uint8_t     m_Flags;
+    };
+
+    struct ControllerData
+    {
+        uint32_t    m_Buttons;          // Bit n is button n+1
+        int16_t     m_Pov;
+        int16_t     m_Reserved;
+        float       m_X;
+        float       m_Y;
+        float       m_Axes[LOGGED_AXES];
+    };
+
+    struct LoopData
+    {
+        ControllerData  m_DriveController;
+        ControllerData  m_ControlController;
+        uint32_t        m_LoopTimeUs;
+        float           m_LeftDriveOutput;      // What the code commanded, not what the Talon measured
+        float           m_RightDriveOutput;     // Same
+        int32_t         m_LeftEncoder;
+        int32_t         m_RightEncoder;
+        float           m_GyroAngle;
+        float           m_ShooterRpm;
+    };
+
+    // Long messages are split over several records.  Records from
+    // different threads can end up between them, so every chunk
+    // carries the id of its message.
+    struct TextData
+    {
+        uint32_t        m_MessageId;
+        char            m_Text[TEXT_RECORD_BYTES];
+    };
+
+    struct Record
+    {
+        RecordHeader    m_Header;
+        union
+        {
+            LoopData    m_Loop;
+            TextData    m_Text;
+        };
+    };
+
+    static_assert(sizeof(FileHeader) == 8U, "Log file header layout changed.");
+    static_assert(sizeof(RecordHeader) == (RECORD_SIZE_BYTES - RECORD_PAYLOAD_BYTES), "Log record header layout changed.");
+    static_assert(sizeof(LoopData) <= RECORD_PAYLOAD_BYTES, "Loop data does not fit in a log record.");
+    static_assert(sizeof(TextData) == RECORD_PAYLOAD_BYTES, "Text data does not fill a log record.");
+    static_assert(sizeof(Record) == RECORD_SIZE_BYTES, "Log record layout changed.");
+}
+
+#endif // ROBOTLOGRECORDS_HPP
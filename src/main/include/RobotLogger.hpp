@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotLogger.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for the binary match data logger.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROBOTLOGGER_HPP
+#define ROBOTLOGGER_HPP
+
+// SYSTEM INCLUDES
+#include <atomic>                               // for std::atomic
+#include <chrono>                               // for std::chrono
+#include <cstdint>                              // for sized integer types
+#include <cstdio>                               // for std::FILE
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "RobotLogRecords.hpp"                  // for the log record layout
+
+
+////////////////////////////////////////////////////////////////
+/// @class RobotLogger
+///
+/// Class that logs match data without slowing down the code
+/// doing the logging.  Records go into a lock free ring in
+/// memory, which any thread can add to.  A low priority thread
+/// wakes up a few times a second and empties the ring in large
+/// sequential writes to a file on the roboRIO.  If the ring
+/// fills up, new records are dropped rather than making anyone
+/// wait.  Text messages are printed to the console by whoever
+/// displays them, the log only keeps a copy, so nothing printed
+/// is held up or lost in the ring if the robot code crashes.
+/// Each run logs to the next unused numbered file.  The logs
+/// are kept from filling the roboRIO's flash: a file stops
+/// growing at MAX_LOG_FILE_BYTES, and no new file is started
+/// once the logs together take MAX_LOG_DIRECTORY_BYTES (or all
+/// MAX_LOG_FILES names are taken).  Old logs are never
+/// overwritten, they have to be deleted from the roboRIO.  Logs
+/// are turned into CSV off the robot by the LogDecoder tool.
+///
+////////////////////////////////////////////////////////////////
+class RobotLogger
+{
+public:
+
+    // Open a new log file and start the drain thread (call once from RobotInit)
+    static void Initialize();
+
+    // Log one loop's worth of robot data
+    static void LogLoop(uint8_t robotMode, const RobotLogRecords::LoopData & rLoopData);
+
+    // Log a copy of a text message (the caller prints it)
+    static void LogText(const char * pText);
+
+    // How many records have been dropped because the ring was full
+    inline static uint32_t GetNumDropped()
+    {
+        return m_NumDropped;
+    }
+
+private:
+
+    typedef RobotLogRecords::Record Record;
+
+    // One ring entry.  The sequence says whether the slot is free or holds a record.
+    struct Slot
+    {
+        std::atomic<uint32_t>   m_Sequence;
+        Record                  m_Record;
+    };
+
+    // Fill in the common header fields
+    static void FillHeader(Record & rRecord, RobotLogRecords::RecordType type, uint8_t robotMode);
+
+    // Add a record to the ring, returns false if it was full
+    static bool Push(const Record & rRecord);
+
+    // Take the oldest record out of the ring, returns false if it was empty (drain thread only)
+    static bool Pop(Record & rRecord);
+
+    // Find an unused log file name and open it, if the logs have room for it
+    static std::FILE * OpenLogFile();
+
+    // Empties the ring to the log file
+    static void DrainThread();
+
+    // Constructor
+    RobotLogger();
+
+    // Destructor, copy constructor, assignment operator
+    ~RobotLogger();
+
+    RobotLogger(const RobotLogger &) = delete;
+    RobotLogger & operator=(const RobotLogger &) = delete;
+
+    // Must be a power of two (about 80 seconds of loop records)
+    static const uint32_t                           RING_CAPACITY           = 4096U;
+    static const uint32_t                           RING_INDEX_MASK         = RING_CAPACITY - 1U;
+    // Records written to the file at once
+    static const unsigned                           DRAIN_BATCH_RECORDS     = 512U;
+    static const unsigned                           MAX_LOG_FILES           = 1000U;    // robot_000 to robot_999
+    // About 80 minutes of loop records per file, and room for a few of those
+    static const uint64_t                           MAX_LOG_FILE_BYTES      = 32U * 1024U * 1024U;
+    static const uint64_t                           MAX_LOG_DIRECTORY_BYTES = 128U * 1024U * 1024U;
+    static constexpr std::chrono::milliseconds      DRAIN_PERIOD            = std::chrono::milliseconds(250);
+    static constexpr const char *                   LOG_DIRECTORY           = "/home/lvuser/logs";
+
+    static_assert((RING_CAPACITY & RING_INDEX_MASK) == 0U, "Log ring capacity must be a power of two.");
+
+    // MEMBER VARIABLES
+    static Slot                                     m_Ring[RING_CAPACITY];
+    static std::atomic<uint32_t>                    m_EnqueuePosition;
+    static uint32_t                                 m_DequeuePosition;
+    static std::atomic<uint32_t>                    m_NextSequence;
+    static std::atomic<uint32_t>                    m_NextMessageId;
+    static std::atomic<uint32_t>                    m_NumDropped;
+    static std::atomic<bool>                        m_bRunning;
+    static std::chrono::steady_clock::time_point    m_StartTime;
+    static std::FILE *                              m_pLogFile;
+    static uint64_t                                 m_LogFileBytesLeft;     // Drain thread only once it's started
+    static Record                                   m_DrainBuffer[DRAIN_BATCH_RECORDS];
+};
+
+#endif // ROBOTLOGGER_HPP
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotTelemetry.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for publishing robot telemetry to the smart dashboard
+/// in batches.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROBOTTELEMETRY_HPP
+#define ROBOTTELEMETRY_HPP
+
+// SYSTEM INCLUDES
+#include <atomic>                               // for std::atomic
+
+// C INCLUDES
+#include "networktables/NetworkTableEntry.h"    // for nt::NetworkTableEntry
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class RobotTelemetry
+///
+/// Class that collects telemetry values and sends them to the
+/// smart dashboard together.  The network table entries are
+/// looked up once at startup, so setting a value is just a
+/// store into a flat array and is safe from any thread.  The
+/// robot thread flushes the array every few loops, only sending
+/// values that changed and that are enabled by the current
+/// verbosity.
+///
+////////////////////////////////////////////////////////////////
+class RobotTelemetry
+{
+public:
+
+    // How much telemetry gets sent, each level includes the ones before it
+    enum Verbosity
+    {
+        VERBOSITY_OFF,
+        VERBOSITY_MATCH,
+        VERBOSITY_DEBUG
+    };
+
+    // The values that can be published (must match the order of VALUE_INFO)
+    enum TelemetryValue
+    {
+        ROBOT_HEARTBEAT,
+        GYRO_ANGLE,
+        AUTO_STEP,
+        X_AXIS_INPUT,
+        Y_AXIS_INPUT,
+        LEFT_DRIVE_SPEED,
+        RIGHT_DRIVE_SPEED,
+        LEFT_DRIVE_TEMPERATURE,
+        RIGHT_DRIVE_TEMPERATURE,
+        RAW_LEFT_TRIGGER,
+        RAW_RIGHT_TRIGGER,
+        NORMALIZED_LEFT_TRIGGER,
+        NORMALIZED_RIGHT_TRIGGER,
+        LEFT_ENCODER,
+        RIGHT_ENCODER,
+        ENCODER_DIFFERENCE,
+        ENCODER_DRIVE_SETPOINT,
+        ODOMETRY_X,
+        ODOMETRY_Y,
+        ODOMETRY_HEADING,
+        COLOR_SENSOR_RED,
+        COLOR_SENSOR_GREEN,
+        COLOR_SENSOR_BLUE,
+        COLOR_SENSOR_IR_DISTANCE,
+        COLOR_SENSOR_PROXIMITY,
+        COLOR_SENSOR_COLOR,
+        LIMELIGHT_STEERING_ADJUST,
+        LIMELIGHT_TARGET_X,
+        LIMELIGHT_INTEGRAL_SUM,
+        LIMELIGHT_TARGET_VALID,
+        CAMERA_HEARTBEAT,
+        BOUNDING_RECT_X,
+        BOUNDING_RECT_Y,
+        BOUNDING_RECT_WIDTH,
+        BOUNDING_RECT_HEIGHT,
+        BOUNDING_RECT_AREA,
+        BOUNDING_RECT_ASPECT_RATIO,
+        CONTOUR_AREA,
+        CONTOUR_PERIMETER,
+        CONTOUR_CONVEX_HULL_AREA,
+        CONTOUR_SOLIDITY,
+        CONTOUR_VERTICES,
+        TARGET_AREA_PERCENT,
+        TARGET_TRAPEZOID_PERCENT,
+        CAMERA_DISTANCE_X,
+        CAMERA_DISTANCE_Y,
+        GROUND_DISTANCE,
+        TARGET_IN_RANGE,
+        TARGET_REPORT_VALID,
+        VISION_LATENCY_MS,
+        VISION_FRAMES_DROPPED,
+        VISION_TRACKING_TARGET,
+        SHOOTER_RPM,
+        SHOOTER_TARGET_RPM,
+        SHOOTER_AT_SPEED,
+        TURRET_ANGLE,
+        TURRET_TARGET_ANGLE,
+        TURRET_TRACKING,
+        COLOR_WHEEL_TARGET_COLOR,
+        COLOR_WHEEL_TRANSITIONS,
+        COLOR_WHEEL_ACTIVE,
+        NUM_TELEMETRY_VALUES
+    };
+
+    // Look up the network table entries (call once from RobotInit)
+    static void Initialize();
+
+    // Record a new value to be sent on the next flush
+    inline static void Set(TelemetryValue value, double data)
+    {
+        m_Values[value].store(data, std::memory_order_relaxed);
+    }
+
+    // Send changed values to the smart dashboard (throttled, call once per loop)
+    static void Flush();
+
+    // Change how much telemetry gets sent, newly enabled values go out on the next flush
+    inline static void SetVerbosity(Verbosity verbosity)
+    {
+        m_Verbosity = verbosity;
+        m_bResendRequested = true;
+    }
+
+    // Tells whether telemetry at a verbosity level is currently being sent
+    inline static bool IsEnabled(Verbosity verbosity)
+    {
+        return (verbosity <= m_Verbosity);
+    }
+
+    // Change how many loops go by between flushes
+    inline static void SetFlushInterval(unsigned loops)
+    {
+        m_FlushIntervalLoops = (loops > 0U) ? loops : 1U;
+    }
+
+private:
+
+    // How a value is shown on the dashboard
+    enum ValueType
+    {
+        NUMBER,
+        BOOLEAN
+    };
+
+    struct ValueInfo
+    {
+        const char *    m_pName;
+        Verbosity       m_Verbosity;
+        ValueType       m_Type;
+    };
+
+    // Forces every enabled value to be sent on the next flush
+    static void InvalidateFlushedValues();
+
+    // Constructor
+    RobotTelemetry();
+
+    // Destructor, copy constructor, assignment operator
+    ~RobotTelemetry();
+
+    RobotTelemetry(const RobotTelemetry &) = delete;
+    RobotTelemetry & operator=(const RobotTelemetry &) = delete;
+
+    // MEMBER VARIABLES
+    static nt::NetworkTableEntry    m_Entries[NUM_TELEMETRY_VALUES];
+    static std::atomic<double>      m_Values[NUM_TELEMETRY_VALUES];
+    static double                   m_FlushedValues[NUM_TELEMETRY_VALUES];
+    static std::atomic<Verbosity>   m_Verbosity;
+    static std::atomic<bool>        m_bResendRequested;
+    static unsigned                 m_FlushIntervalLoops;
+    static unsigned                 m_FlushLoopCount;
+    static bool                     m_bInitialized;
+    static const ValueInfo          VALUE_INFO[NUM_TELEMETRY_VALUES];
+
+    // Loops between flushes unless changed at runtime
+    static const unsigned           DEFAULT_FLUSH_INTERVAL_LOOPS = 5U;
+};
+
+#endif // ROBOTTELEMETRY_HPP
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotThreads.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for configuring how the robot's threads are
+/// scheduled.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROBOTTHREADS_HPP
+#define ROBOTTHREADS_HPP
+
+// SYSTEM INCLUDES
+// (none)
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class RobotThreads
+///
+/// Class that sets up the scheduling of each of the robot's
+/// threads.  Every thread calls ConfigureCurrentThread() with
+/// its id as soon as it starts, which names it (so it can be
+/// told apart in top and in crash dumps), gives it a priority
+/// and optionally pins it to a core.  The control loop and the
+/// I2C thread run real time (SCHED_FIFO) so nothing else on the
+/// roboRIO can delay them.  Vision is pinned to the second core
+/// so image processing never competes with the control loop on
+/// the first.  If a setting can't be applied (like on the
+/// desktop, without permission for real time priorities), the
+/// thread keeps running with the defaults.
+///
+////////////////////////////////////////////////////////////////
+class RobotThreads
+{
+public:
+
+    enum ThreadId
+    {
+        ROBOT_LOOP,
+        I2C_THREAD,
+        CAMERA_THREAD,
+        VISION_THRESHOLD_STAGE,
+        VISION_CONTOUR_STAGE,
+        LOGGER_DRAIN,
+        NUM_THREADS
+    };
+
+    // Apply the name, priority and core affinity for a thread (call from that thread)
+    static void ConfigureCurrentThread(ThreadId thread);
+
+private:
+
+    struct ThreadConfig
+    {
+        const char *    m_pName;                // At most 15 characters, or nullptr to keep the current name
+        bool            m_bRealTime;            // SCHED_FIFO if true, otherwise a normal thread
+        int             m_Priority;             // Real time priority (1-99), or the nice value for normal threads
+        int             m_Core;                 // Core to pin to, or ANY_CORE
+    };
+
+    // Constructor
+    RobotThreads();
+
+    // Destructor, copy constructor, assignment operator
+    ~RobotThreads();
+
+    RobotThreads(const RobotThreads &) = delete;
+    RobotThreads & operator=(const RobotThreads &) = delete;
+
+    // MEMBER VARIABLES
+    static const int            ANY_CORE                    = -1;
+    static const int            VISION_CORE                 = 1;
+
+    // Indexed by ThreadId
+    static const ThreadConfig   THREAD_CONFIGS[NUM_THREADS];
+};
+
+#endif // ROBOTTHREADS_HPP
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotTiming.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for measuring how long the robot periodic functions
+/// and sequences take to execute.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROBOTTIMING_HPP
+#define ROBOTTIMING_HPP
+
+// SYSTEM INCLUDES
+#include <chrono>                               // for steady_clock
+#include <cstdint>                              // for uint32_t
+#include <string>                               // for std::string
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "RobotUtils.hpp"                       // for DisplayMessage()
+
+
+////////////////////////////////////////////////////////////////
+/// @class RobotTiming
+///
+/// Class that records execution times of the robot code.  Each
+/// timed section keeps a fixed size window of its most recent
+/// samples plus a histogram, so recording a sample never
+/// allocates.  Statistics are only computed when a summary is
+/// published, which keeps the cost out of the hot path.
+///
+////////////////////////////////////////////////////////////////
+class RobotTiming
+{
+public:
+
+    // The sections of code that can be timed
+    enum TimedSection
+    {
+        TELEOP_LOOP,
+        DRIVE_CONTROL_SEQUENCE,
+        INTAKE_SEQUENCE,
+        TURRET_SEQUENCE,
+        SHOOTER_SEQUENCE,
+        COLOR_SEQUENCE,
+        PNEUMATIC_SEQUENCE,
+        HANG_SEQUENCE,
+        NUM_TIMED_SECTIONS
+    };
+
+    ////////////////////////////////////////////////////////////////
+    /// @class RobotTiming::ScopedTimer
+    ///
+    /// Records the time from construction to destruction as a
+    /// sample for a timed section.
+    ///
+    ////////////////////////////////////////////////////////////////
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(TimedSection section) :
+            m_Section(section),
+            m_StartTime(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - m_StartTime;
+            RecordSample(m_Section, static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer & operator=(const ScopedTimer &) = delete;
+
+    private:
+        TimedSection                            m_Section;
+        std::chrono::steady_clock::time_point   m_StartTime;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    /// @class RobotTiming::ThreadCpuMonitor
+    ///
+    /// Measures how much CPU time the thread that owns it uses and
+    /// publishes it to the smart dashboard about once a second.
+    /// Must be constructed and updated from the monitored thread.
+    ///
+    ////////////////////////////////////////////////////////////////
+    class ThreadCpuMonitor
+    {
+    public:
+        explicit ThreadCpuMonitor(const char * pThreadName);
+
+        // Publishes the CPU usage if a report period has gone by
+        void Update();
+
+        ThreadCpuMonitor(const ThreadCpuMonitor &) = delete;
+        ThreadCpuMonitor & operator=(const ThreadCpuMonitor &) = delete;
+
+        // How often the usage is published
+        static constexpr std::chrono::milliseconds REPORT_PERIOD = std::chrono::milliseconds(1000);
+
+    private:
+        // CPU time used by the calling thread
+        static uint64_t GetThreadCpuTimeNs();
+
+        std::string                             m_DashboardKey;
+        uint64_t                                m_LastCpuTimeNs;
+        std::chrono::steady_clock::time_point   m_LastReportTime;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    /// @class RobotTiming::JitterMonitor
+    ///
+    /// Measures how far the period of a loop strays from what it
+    /// should be, and publishes the worst and average error to the
+    /// smart dashboard about once a second.  Tick() is called at
+    /// the same point of each pass through the loop.
+    ///
+    ////////////////////////////////////////////////////////////////
+    class JitterMonitor
+    {
+    public:
+        JitterMonitor(const char * pLoopName, std::chrono::microseconds expectedPeriod);
+
+        // Records one pass of the loop, publishes if a report period has gone by
+        void Tick();
+
+        // Forget the last tick, for when the loop was paused on purpose
+        inline void Restart()
+        {
+            m_bStarted = false;
+        }
+
+        JitterMonitor(const JitterMonitor &) = delete;
+        JitterMonitor & operator=(const JitterMonitor &) = delete;
+
+    private:
+        std::string                             m_MaxDashboardKey;
+        std::string                             m_MeanDashboardKey;
+        std::chrono::microseconds               m_ExpectedPeriod;
+        std::chrono::steady_clock::time_point   m_LastTickTime;
+        std::chrono::steady_clock::time_point   m_LastReportTime;
+        std::chrono::microseconds               m_MaxJitter;
+        std::chrono::microseconds               m_TotalJitter;
+        unsigned                                m_NumPeriods;
+        bool                                    m_bStarted;
+    };
+
+    // Record one execution time sample for a section
+    inline static void RecordSample(TimedSection section, uint32_t durationUs);
+
+    // The most recent sample recorded for a section
+    inline static uint32_t GetLastSampleUs(TimedSection section)
+    {
+        return m_SectionStatistics[section].m_LastSampleUs;
+    }
+
+    // Publish statistics to the smart dashboard (throttled, call once per loop)
+    static void PublishSummary();
+
+    // Print the histograms of all sections to the console
+    static void DisplayHistograms();
+
+    // Clear all samples and histograms
+    static void ResetStatistics();
+
+private:
+
+    // Number of samples kept for the min/mean/max/p99 window (five seconds of 20ms loops)
+    static const unsigned   SAMPLE_WINDOW_SIZE          = 250U;
+    static const uint32_t   HISTOGRAM_BUCKET_WIDTH_US   = 500U;
+    // One bucket per half millisecond of the loop period plus an overflow bucket
+    static const uint32_t   LOOP_BUDGET_US              = 20000U;
+    static const unsigned   NUM_HISTOGRAM_BUCKETS       = (LOOP_BUDGET_US / HISTOGRAM_BUCKET_WIDTH_US) + 1U;
+    // Loops between publishing one section to the smart dashboard
+    static const unsigned   PUBLISH_INTERVAL_LOOPS      = 5U;
+    static const unsigned   HISTOGRAM_BAR_MAX_WIDTH     = 40U;
+
+    struct SectionStatistics
+    {
+        uint32_t    m_Samples[SAMPLE_WINDOW_SIZE];
+        unsigned    m_NextSampleIndex;
+        unsigned    m_NumWindowSamples;
+        unsigned    m_TotalSamples;
+        unsigned    m_Histogram[NUM_HISTOGRAM_BUCKETS];
+        unsigned    m_NumOverruns;
+        uint32_t    m_LastSampleUs;
+    };
+
+    // The smart dashboard keys of every section, built once so publishing doesn't allocate
+    struct DashboardKeys
+    {
+        DashboardKeys();
+
+        std::string m_MinKeys[NUM_TIMED_SECTIONS];
+        std::string m_MeanKeys[NUM_TIMED_SECTIONS];
+        std::string m_MaxKeys[NUM_TIMED_SECTIONS];
+        std::string m_P99Keys[NUM_TIMED_SECTIONS];
+    };
+
+    // Finds which sequence used the most time in the last loop
+    static TimedSection FindSlowestSequence();
+
+    // Constructor
+    RobotTiming();
+
+    // Destructor, copy constructor, assignment operator
+    ~RobotTiming();
+
+    RobotTiming(const RobotTiming &) = delete;
+    RobotTiming & operator=(const RobotTiming &) = delete;
+
+    // MEMBER VARIABLES
+    static SectionStatistics    m_SectionStatistics[NUM_TIMED_SECTIONS];
+    static uint32_t             m_ScratchSamples[SAMPLE_WINDOW_SIZE];
+    static unsigned             m_PublishLoopCount;
+    static unsigned             m_NextPublishSection;
+    static TimedSection         m_LastOverrunSection;
+    static const char * const   SECTION_NAMES[NUM_TIMED_SECTIONS];
+    static const DashboardKeys  DASHBOARD_KEYS;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotTiming::RecordSample
+///
+/// Records one sample for a section.  This is called every loop
+/// so it only does constant time work.
+///
+////////////////////////////////////////////////////////////////
+inline void RobotTiming::RecordSample(TimedSection section, uint32_t durationUs)
+{
+    SectionStatistics & rStatistics = m_SectionStatistics[section];
+
+    rStatistics.m_Samples[rStatistics.m_NextSampleIndex] = durationUs;
+    rStatistics.m_NextSampleIndex = (rStatistics.m_NextSampleIndex + 1U) % SAMPLE_WINDOW_SIZE;
+    if (rStatistics.m_NumWindowSamples < SAMPLE_WINDOW_SIZE)
+    {
+        rStatistics.m_NumWindowSamples++;
+    }
+    rStatistics.m_TotalSamples++;
+    rStatistics.m_LastSampleUs = durationUs;
+
+    unsigned bucket = durationUs / HISTOGRAM_BUCKET_WIDTH_US;
+    if (bucket >= NUM_HISTOGRAM_BUCKETS)
+    {
+        bucket = NUM_HISTOGRAM_BUCKETS - 1U;
+    }
+    rStatistics.m_Histogram[bucket]++;
+
+    if (durationUs > LOOP_BUDGET_US)
+    {
+        rStatistics.m_NumOverruns++;
+
+        // The whole loop ran long, remember who was responsible
+        if (section == TELEOP_LOOP)
+        {
+            m_LastOverrunSection = FindSlowestSequence();
+        }
+    }
+}
+
+#endif // ROBOTTIMING_HPP
@@ -13,14 +13,14 @@
 
 // SYSTEM INCLUDES
 #include <cstdarg>                              // for va_*
-#include <cstdio>                               // for printf
+#include <cstdio>                               // for snprintf
 #include <iostream>                             // for cout
 
 // C INCLUDES
 // (none)
 
 // C++ INCLUDES
-// (none)
+#include "RobotLogger.hpp"                      // for routing messages through the logger
 
 // MACROS
 #define ASSERT(condition)                                   \
@@ -56,11 +56,16 @@ namespace RobotUtils
 {
     static const bool DEBUG_PRINTS = true;
     
+    // Longer messages are cut off
+    static const unsigned MAX_MESSAGE_LENGTH = 256U;
+    
     ////////////////////////////////////////////////////////////////
     /// @method RobotUtils::DisplayMessage
     ///
     /// Displays a message to the RioLog as long as debug prints are
-    /// enabled.
+    /// enabled.  It is printed right away, so it is in order with
+    /// everything else on the console and isn't lost if the code
+    /// crashes, and a copy goes in the match log.
     ///
     ////////////////////////////////////////////////////////////////
     inline void DisplayMessage(const char * pMessage)
@@ -68,6 +73,10 @@ namespace RobotUtils
         if (DEBUG_PRINTS)
         {
             std::cout << pMessage << std::endl;
+            
+            char message[MAX_MESSAGE_LENGTH];
+            static_cast<void>(std::snprintf(message, sizeof(message), "%s\n", pMessage));
+            RobotLogger::LogText(message);
         }
     }
     
@@ -75,23 +84,27 @@ namespace RobotUtils
     /// @method RobotUtils::DisplayMessage
     ///
     /// Displays a message to the RioLog as long as debug prints are
-    /// enabled.
+    /// enabled.  Like DisplayMessage(), it is printed right away
+    /// and a copy goes in the match log.
     ///
     ////////////////////////////////////////////////////////////////
     inline void DisplayFormattedMessage(const char * pMessage, ...)
     {
         if (DEBUG_PRINTS)
         {
+            char message[MAX_MESSAGE_LENGTH];
             va_list argPtr;
             va_start(argPtr, pMessage);
             
             // It's ok to pass the pointer here instead of a formatted
             // string since the callers of this function are well defined.
             DISABLE_WARNING("-Wformat-nonliteral")
-            vprintf(pMessage, argPtr);
+            static_cast<void>(std::vsnprintf(message, sizeof(message), pMessage, argPtr));
             ENABLE_WARNING("-Wformat-nonliteral")
             
             va_end(argPtr);
+            std::cout << message << std::flush;
+            RobotLogger::LogText(message);
         }
     }
 
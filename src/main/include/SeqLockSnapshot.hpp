@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   SeqLockSnapshot.hpp
+/// @author David Stalter
+///
+/// @details
+/// A template class for publishing data from one thread to any number of
+/// readers without locks.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SEQLOCKSNAPSHOT_HPP
+#define SEQLOCKSNAPSHOT_HPP
+
+// SYSTEM INCLUDES
+#include <atomic>                               // for std::atomic
+#include <cstdint>                              // for uint32_t, uint64_t
+#include <cstring>                              // for memcpy
+#include <type_traits>                          // for std::is_trivially_copyable
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class SeqLockSnapshot
+///
+/// Holds the most recent sample of some data along with the
+/// time it was taken and a sequence number.  There must only
+/// be one writer.  The writer never waits, and a reader that
+/// overlaps a write sees a changed sequence and copies again.
+/// The data is kept as atomic words so a reader that overlaps
+/// a write is not a data race, it just throws the copy away.
+///
+////////////////////////////////////////////////////////////////
+template <typename DataType>
+class SeqLockSnapshot
+{
+public:
+
+    static_assert(std::is_trivially_copyable<DataType>::value, "Snapshot data must be trivially copyable.");
+
+    // What readers get back from the snapshot
+    struct Sample
+    {
+        DataType    m_Data;
+        uint64_t    m_TimestampUs;      // Monotonic time (FPGA time) the sample was taken
+        uint32_t    m_SequenceNumber;   // Increments once per publish, starting at 1
+    };
+
+    // Constructor
+    SeqLockSnapshot() :
+        m_Sequence(0U),
+        m_Words()
+    {
+        for (unsigned i = 0U; i < NUM_WORDS; i++)
+        {
+            m_Words[i].store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    // Publish a new sample (only call from the one writer thread)
+    inline void Publish(const DataType & rData, uint64_t timestampUs);
+
+    // Copy out the latest sample, returns false if there isn't one or a consistent copy couldn't be made
+    inline bool Read(Sample & rSample) const;
+
+    // Get the sequence number of the latest sample without copying it
+    inline uint32_t GetSequenceNumber() const
+    {
+        return m_Sequence.load(std::memory_order_acquire) / 2U;
+    }
+
+private:
+
+    // The sample is stored as an array of 32-bit words
+    static const unsigned NUM_WORDS = (sizeof(Sample) + sizeof(uint32_t) - 1U) / sizeof(uint32_t);
+
+    // How many times a reader will try before giving up (the writer runs far slower than a copy)
+    static const unsigned MAX_READ_ATTEMPTS = 8U;
+
+    // Odd while a write is in progress
+    std::atomic<uint32_t>   m_Sequence;
+    std::atomic<uint32_t>   m_Words[NUM_WORDS];
+
+    SeqLockSnapshot(const SeqLockSnapshot &) = delete;
+    SeqLockSnapshot & operator=(const SeqLockSnapshot &) = delete;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SeqLockSnapshot<DataType>::Publish
+///
+/// Stores a new sample.  The sequence is odd while the words
+/// are being written so readers know to retry.
+///
+////////////////////////////////////////////////////////////////
+template <typename DataType>
+inline void SeqLockSnapshot<DataType>::Publish(const DataType & rData, uint64_t timestampUs)
+{
+    const uint32_t sequence = m_Sequence.load(std::memory_order_relaxed);
+
+    Sample sample;
+    std::memcpy(&sample.m_Data, &rData, sizeof(DataType));
+    sample.m_TimestampUs = timestampUs;
+    sample.m_SequenceNumber = (sequence / 2U) + 1U;
+
+    uint32_t words[NUM_WORDS] = {};
+    std::memcpy(&words[0], &sample, sizeof(Sample));
+
+    m_Sequence.store(sequence + 1U, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (unsigned i = 0U; i < NUM_WORDS; i++)
+    {
+        m_Words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    m_Sequence.store(sequence + 2U, std::memory_order_release);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SeqLockSnapshot<DataType>::Read
+///
+/// Copies out the latest sample.  If a write happens during the
+/// copy it is retried, up to a limit so the caller never spins.
+///
+////////////////////////////////////////////////////////////////
+template <typename DataType>
+inline bool SeqLockSnapshot<DataType>::Read(Sample & rSample) const
+{
+    for (unsigned attempt = 0U; attempt < MAX_READ_ATTEMPTS; attempt++)
+    {
+        const uint32_t startSequence = m_Sequence.load(std::memory_order_acquire);
+
+        // Nothing published yet
+        if (startSequence == 0U)
+        {
+            return false;
+        }
+
+        // Write in progress
+        if ((startSequence & 1U) != 0U)
+        {
+            continue;
+        }
+
+        uint32_t words[NUM_WORDS];
+        for (unsigned i = 0U; i < NUM_WORDS; i++)
+        {
+            words[i] = m_Words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_Sequence.load(std::memory_order_relaxed) == startSequence)
+        {
+            std::memcpy(&rSample, &words[0], sizeof(Sample));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif // SEQLOCKSNAPSHOT_HPP
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   SonarFilter.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for filtering the sonar readings from the RIOduino.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SONARFILTER_HPP
+#define SONARFILTER_HPP
+
+// SYSTEM INCLUDES
+#include <cstdint>                                          // for uint8_t
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "../../Rioduino/RoborioRioduinoSharedData.hpp"     // for SonarI2cData
+
+using namespace RoborioRioduinoSharedData;
+
+
+////////////////////////////////////////////////////////////////
+/// @class SonarFilter
+///
+/// Smooths the eight sonar readings that come over I2C.  Each
+/// sensor keeps a small circular window of its last readings
+/// and reports the median, so a single bad echo can't change
+/// the result.  A reading far from the current median is thrown
+/// away as an outlier, unless enough of them arrive in a row
+/// that the robot really must have moved (or something moved in
+/// front of the sensor).  Runs once per new I2C packet.
+///
+////////////////////////////////////////////////////////////////
+class SonarFilter
+{
+public:
+
+    // Constructor
+    SonarFilter();
+
+    // Forget all previous readings
+    void Reset();
+
+    // Add a new set of readings and get back the filtered distances
+    SonarI2cData Filter(const SonarI2cData & rRawData);
+
+    // How many readings have been thrown out as outliers
+    inline unsigned GetNumRejected() const
+    {
+        return m_NumRejected;
+    }
+
+private:
+
+    // The window of readings for one sensor
+    struct SensorWindow
+    {
+        uint8_t     m_Samples[5];
+        unsigned    m_NumSamples;
+        unsigned    m_NextSample;
+        unsigned    m_NumRejectedInRow;
+        uint8_t     m_Median;
+    };
+
+    // Add one reading to a sensor's window and update its median
+    void AddSample(SensorWindow & rWindow, uint8_t sample);
+
+    // Work out the median of the readings in a window
+    static uint8_t GetMedian(const SensorWindow & rWindow);
+
+    // The sonar data is eight single byte distances
+    static const unsigned   NUM_SENSORS                 = sizeof(SonarI2cData);
+    static const unsigned   WINDOW_SIZE                 = sizeof(SensorWindow::m_Samples);
+    // A reading further than this from the median is an outlier
+    static const unsigned   OUTLIER_DISTANCE_INCHES     = 12U;
+    // After this many outliers in a row, believe them
+    static const unsigned   MAX_REJECTED_IN_ROW         = 2U;
+
+    static_assert(NUM_SENSORS == 8U, "Sonar data is not eight single byte readings.");
+
+    SensorWindow            m_Windows[NUM_SENSORS];
+    unsigned                m_NumRejected;
+
+    SonarFilter(const SonarFilter &) = delete;
+    SonarFilter & operator=(const SonarFilter &) = delete;
+};
+
+#endif // SONARFILTER_HPP
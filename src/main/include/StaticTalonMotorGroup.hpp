@@ -0,0 +1,418 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   StaticTalonMotorGroup.hpp
+/// @author David Stalter
+///
+/// @details
+/// A class designed to work with a group of CAN Talon speed controllers working
+/// in tandem, where the layout of the group is fixed at compile time.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef STATICTALONMOTORGROUP_HPP
+#define STATICTALONMOTORGROUP_HPP
+
+// SYSTEM INCLUDES
+#include <utility>                      // for std::integer_sequence
+
+// C INCLUDES
+#include "ctre/Phoenix.h"               // for CTRE library interfaces
+
+// C++ INCLUDES
+#include "TalonMotorGroup.hpp"          // for YtaTalon::MotorGroupControlMode
+
+
+////////////////////////////////////////////////////////////////
+/// @class StaticTalonMotorGroup
+///
+/// Class that provides methods for interacting with a group of
+/// Talon speed controllers whose count and control modes are
+/// known at compile time.  The first control mode is the master
+/// and the motors take consecutive CAN IDs from there.  The
+/// Talon objects live inline in the group, and Set() resolves
+/// each motor's control mode at compile time, so followers cost
+/// nothing and the rest are straight-line writes.  Groups whose
+/// layout changes at runtime should use TalonMotorGroup.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+class StaticTalonMotorGroup
+{
+public:
+
+    typedef YtaTalon::MotorGroupControlMode MotorGroupControlMode;
+
+    // Number of motors in the group
+    static const int NUM_MOTORS = sizeof...(CONTROL_MODES);
+
+    // The control mode of each motor, in CAN ID order
+    static constexpr MotorGroupControlMode CONTROL_MODE_LAYOUT[NUM_MOTORS] = { CONTROL_MODES... };
+
+    // Constructor
+    explicit StaticTalonMotorGroup(int masterCanId, FeedbackDevice sensor = FeedbackDevice::None) :
+        StaticTalonMotorGroup(masterCanId, sensor, std::make_integer_sequence<int, NUM_MOTORS>())
+    {
+    }
+
+    // Retrieve a specific motor object
+    TalonType * GetMotorObject(int canId = GROUP_MASTER_CAN_ID);
+
+    // Function to set the speed of each motor in the group
+    inline void Set(double value, double offset = 0.0)
+    {
+        SetMotors(ControlMode::PercentOutput, value, offset, std::make_integer_sequence<int, NUM_MOTORS>());
+    }
+
+    // Function to set the closed loop velocity (sensor units per 100ms) of each motor in the group
+    inline void SetVelocity(double velocity, double offset = 0.0)
+    {
+        SetMotors(ControlMode::Velocity, velocity, offset, std::make_integer_sequence<int, NUM_MOTORS>());
+    }
+
+    // The output last sent to the master Talon (what it was told, not what it measured)
+    inline double GetLastOutput() const
+    {
+        return m_WriteCaches[0].GetValue();
+    }
+
+    // Configure the non-follower motors for closed loop velocity control
+    void ConfigureVelocityControl(const YtaTalon::PidConfig & rPidConfig, int slotIndex = 0);
+
+    // Compensate every motor's output against a fixed voltage
+    void ConfigureVoltageCompensation(double saturationVolts);
+
+    // Return the velocity (sensor units per 100ms) of the sensor connected to the master Talon
+    int GetVelocity();
+
+    // Change Talon mode between brake/coast
+    void SetCoastMode();
+    void SetBrakeMode();
+
+    // Return the value of the sensor connected to the Talon
+    int GetEncoderValue();
+    void TareEncoder();
+
+private:
+
+    static const int GROUP_MASTER_CAN_ID = 0xFF;
+
+    // Checks the layout has exactly one master, first, and no modes that need runtime setup
+    static constexpr bool IsValidLayout()
+    {
+        if (CONTROL_MODE_LAYOUT[0] != YtaTalon::MASTER)
+        {
+            return false;
+        }
+
+        for (int i = 1; i < NUM_MOTORS; i++)
+        {
+            if ((CONTROL_MODE_LAYOUT[i] == YtaTalon::MASTER) || (CONTROL_MODE_LAYOUT[i] == YtaTalon::CUSTOM))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Constructor that expands the motor indices to build the Talons in place
+    template <int... MOTOR_INDICES>
+    StaticTalonMotorGroup(int masterCanId, FeedbackDevice sensor, std::integer_sequence<int, MOTOR_INDICES...>);
+
+    // Set every motor, one call per motor index
+    template <int... MOTOR_INDICES>
+    inline void SetMotors(ControlMode controlMode, double value, double offset, std::integer_sequence<int, MOTOR_INDICES...>)
+    {
+        (SetMotor<MOTOR_INDICES>(controlMode, value, offset), ...);
+    }
+
+    // Set one motor based on its compile time control mode
+    template <int MOTOR_INDEX>
+    inline void SetMotor(ControlMode controlMode, double value, double offset);
+
+    // Member variables
+    int m_MasterCanId;                                      // Keep track of the CAN ID of the master Talon in the group
+    FeedbackDevice m_Sensor;                                // Keep track of the sensor attached to the Talon (assumes one sensor per group)
+    TalonType m_Talons[NUM_MOTORS];                         // The motor objects
+    YtaTalon::WriteCache m_WriteCaches[NUM_MOTORS];         // The last output sent to each motor
+
+    // Prevent default construction/copy/assignment
+    StaticTalonMotorGroup() = delete;
+    StaticTalonMotorGroup( const StaticTalonMotorGroup& ) = delete;
+    StaticTalonMotorGroup & operator=( const StaticTalonMotorGroup& ) = delete;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::StaticTalonMotorGroup
+///
+/// Constructor.  Builds each Talon in place from consecutive
+/// CAN IDs starting at the master's, then configures the
+/// sensor and followers.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+template <int... MOTOR_INDICES>
+StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::StaticTalonMotorGroup(int masterCanId, FeedbackDevice sensor, std::integer_sequence<int, MOTOR_INDICES...>) :
+    m_MasterCanId(masterCanId),
+    m_Sensor(sensor),
+    m_Talons{ TalonType(masterCanId + MOTOR_INDICES)... },
+    m_WriteCaches()
+{
+    static_assert(NUM_MOTORS > 0, "A motor group needs at least one motor.");
+    static_assert(IsValidLayout(), "Motor group layout must start with MASTER and can't contain another MASTER or CUSTOM.");
+
+    // This assumes only the first controller in a group has a sensor
+    if (sensor != FeedbackDevice::None)
+    {
+        // Sensor initialization (feedbackDevice, pidIdx, timeoutMs)
+        m_Talons[0].ConfigSelectedFeedbackSensor(sensor, 0, 0);
+    }
+
+    for (int i = 0; i < NUM_MOTORS; i++)
+    {
+        // Followers only need Set() called once, here
+        if (CONTROL_MODE_LAYOUT[i] == YtaTalon::FOLLOW)
+        {
+            YtaTalon::ConfigureFollower(&m_Talons[i], masterCanId);
+        }
+
+        // Override to always coast
+        m_Talons[i].SetNeutralMode(NeutralMode::Coast);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::GetMotorObject
+///
+/// Retrieves a specific Talon motor object from the motor
+/// group.  By default it will return the master Talon.  If a
+/// CAN ID is specified, it will retrieve that object instead,
+/// or nullptr if the ID isn't part of this group.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+TalonType * StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::GetMotorObject(int canId)
+{
+    if (canId == GROUP_MASTER_CAN_ID)
+    {
+        return &m_Talons[0];
+    }
+
+    // CAN IDs are consecutive, so the ID gives the index directly
+    const int motorIndex = canId - m_MasterCanId;
+    if ((motorIndex < 0) || (motorIndex >= NUM_MOTORS))
+    {
+        return nullptr;
+    }
+
+    return &m_Talons[motorIndex];
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::SetCoastMode
+///
+/// Method to change a talon to coast mode.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+void StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::SetCoastMode()
+{
+    for (int i = 0; i < NUM_MOTORS; i++)
+    {
+        m_Talons[i].SetNeutralMode(NeutralMode::Coast);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::SetBrakeMode
+///
+/// Method to change a talon to brake mode.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+void StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::SetBrakeMode()
+{
+    for (int i = 0; i < NUM_MOTORS; i++)
+    {
+        m_Talons[i].SetNeutralMode(NeutralMode::Brake);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::TareEncoder
+///
+/// Method to tare the value on an encoder feedback device
+/// connected to a Talon controller.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+void StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::TareEncoder()
+{
+    if ((m_Sensor == FeedbackDevice::CTRE_MagEncoder_Relative) || (m_Sensor == FeedbackDevice::IntegratedSensor))
+    {
+        // sensorPos, pidIdx, timeoutMs
+        m_Talons[0].SetSelectedSensorPosition(0, 0, 0);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::GetEncoderValue
+///
+/// Method to get the value from an encoder feedback device
+/// connected to a Talon controller.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+int StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::GetEncoderValue()
+{
+    int sensorValue = 0;
+
+    if ((m_Sensor == FeedbackDevice::CTRE_MagEncoder_Relative) || (m_Sensor == FeedbackDevice::IntegratedSensor))
+    {
+        // pidIdx
+        sensorValue = m_Talons[0].GetSelectedSensorPosition(0);
+    }
+
+    return sensorValue;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::ConfigureVelocityControl
+///
+/// Method to set up closed loop velocity control.  Every motor
+/// that isn't a follower runs its own loop on its own sensor,
+/// so each one gets the sensor and gains.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+void StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::ConfigureVelocityControl(const YtaTalon::PidConfig & rPidConfig, int slotIndex)
+{
+    for (int i = 0; i < NUM_MOTORS; i++)
+    {
+        if (CONTROL_MODE_LAYOUT[i] == YtaTalon::FOLLOW)
+        {
+            continue;
+        }
+
+        if (m_Sensor != FeedbackDevice::None)
+        {
+            // feedbackDevice, pidIdx, timeoutMs
+            m_Talons[i].ConfigSelectedFeedbackSensor(m_Sensor, 0, 0);
+        }
+
+        YtaTalon::ConfigurePidSlot(&m_Talons[i], slotIndex, rPidConfig);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::ConfigureVoltageCompensation
+///
+/// Method to compensate the output of every motor in the group
+/// against a fixed voltage.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+void StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::ConfigureVoltageCompensation(double saturationVolts)
+{
+    for (int i = 0; i < NUM_MOTORS; i++)
+    {
+        YtaTalon::ConfigureVoltageCompensation(&m_Talons[i], saturationVolts);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::GetVelocity
+///
+/// Method to get the velocity from the sensor connected to the
+/// master Talon controller.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+int StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::GetVelocity()
+{
+    int sensorVelocity = 0;
+
+    if (m_Sensor != FeedbackDevice::None)
+    {
+        // pidIdx
+        sensorVelocity = m_Talons[0].GetSelectedSensorVelocity(0);
+    }
+
+    return sensorVelocity;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method StaticTalonMotorGroup::SetMotor
+///
+/// Sets one motor in the group.  The group control mode is a
+/// constant, so only the matching branch is compiled and
+/// followers don't generate any code at all.  The offset is
+/// only used by motors configured as *_OFFSET.  Writes that
+/// repeat a motor's last output are skipped.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType, YtaTalon::MotorGroupControlMode... CONTROL_MODES>
+template <int MOTOR_INDEX>
+inline void StaticTalonMotorGroup<TalonType, CONTROL_MODES...>::SetMotor([[maybe_unused]] ControlMode controlMode, [[maybe_unused]] double value, [[maybe_unused]] double offset)
+{
+    constexpr MotorGroupControlMode CONTROL_MODE = CONTROL_MODE_LAYOUT[MOTOR_INDEX];
+
+    if constexpr (CONTROL_MODE == YtaTalon::FOLLOW)
+    {
+        // Nothing to do, motor had Set() called during object construction
+    }
+    else
+    {
+        double valueToSet = value;
+
+        if constexpr ((CONTROL_MODE == YtaTalon::MASTER) || (CONTROL_MODE == YtaTalon::INDEPENDENT))
+        {
+            // The master always gets set directly, as do motors
+            // that are independently controlled (not follow or inverse).
+            valueToSet = value;
+        }
+        else if constexpr (CONTROL_MODE == YtaTalon::INVERSE)
+        {
+            // Motor is attached to drive in opposite direction of master
+            valueToSet = -value;
+        }
+        else if constexpr (CONTROL_MODE == YtaTalon::INDEPENDENT_OFFSET)
+        {
+            // The non-master motor has a different value in this case
+            valueToSet = value + offset;
+        }
+        else if constexpr (CONTROL_MODE == YtaTalon::INVERSE_OFFSET)
+        {
+            // The non-master motor has a different value in this case
+            valueToSet = -(value + offset);
+        }
+
+        // Skip the write if it's what was already sent
+        if (m_WriteCaches[MOTOR_INDEX].IsWriteNeeded(controlMode, valueToSet))
+        {
+            m_Talons[MOTOR_INDEX].Set(controlMode, valueToSet);
+        }
+    }
+}
+
+#endif // STATICTALONMOTORGROUP_HPP
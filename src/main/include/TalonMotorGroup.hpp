@@ -13,13 +13,13 @@
 #define TALONMOTORGROUP_HPP
 
 // SYSTEM INCLUDES
-// <none>
+#include <cstdint>                      // for uint8_t
 
 // C INCLUDES
 #include "ctre/Phoenix.h"               // for CTRE library interfaces
 
 // C++ INCLUDES
-// (none)
+#include "CachedTalon.hpp"              // for YtaTalon::WriteCache
 
 
 ////////////////////////////////////////////////////////////////
@@ -42,6 +42,70 @@ namespace YtaTalon
         INVERSE_OFFSET,         // Motor is set independently, but with the a different inverse value from master
         CUSTOM                  // Motor needs to be set later to an option above
     };
+    
+    // Nothing reads a follower's sensor, so its feedback frame can go out far less often (default is 20ms)
+    static const uint8_t FOLLOWER_FEEDBACK_STATUS_FRAME_PERIOD_MS = 255U;
+    
+    ////////////////////////////////////////////////////////////////
+    /// @method YtaTalon::ConfigureFollower
+    ///
+    /// Puts a Talon into follower mode and slows down the status
+    /// frames a follower doesn't need.
+    ///
+    ////////////////////////////////////////////////////////////////
+    template <class TalonType>
+    inline void ConfigureFollower(TalonType * pTalon, int masterCanId)
+    {
+        pTalon->Set(ControlMode::Follower, masterCanId);
+        pTalon->SetStatusFramePeriod(StatusFrame::Status_2_Feedback0_, FOLLOWER_FEEDBACK_STATUS_FRAME_PERIOD_MS);
+    }
+    
+    // Gains for one of the closed loop slots on a Talon
+    struct PidConfig
+    {
+        double m_Kp;
+        double m_Ki;
+        double m_Kd;
+        double m_Kf;
+        int m_IntegralZone;
+    };
+    
+    ////////////////////////////////////////////////////////////////
+    /// @method YtaTalon::ConfigurePidSlot
+    ///
+    /// Loads gains into a closed loop slot on a Talon and selects
+    /// that slot for the primary PID loop.
+    ///
+    ////////////////////////////////////////////////////////////////
+    template <class TalonType>
+    inline void ConfigurePidSlot(TalonType * pTalon, int slotIndex, const PidConfig & rPidConfig)
+    {
+        // slotIdx, value, timeoutMs
+        pTalon->Config_kP(slotIndex, rPidConfig.m_Kp, 0);
+        pTalon->Config_kI(slotIndex, rPidConfig.m_Ki, 0);
+        pTalon->Config_kD(slotIndex, rPidConfig.m_Kd, 0);
+        pTalon->Config_kF(slotIndex, rPidConfig.m_Kf, 0);
+        pTalon->Config_IntegralZone(slotIndex, rPidConfig.m_IntegralZone, 0);
+        
+        // slotIdx, pidIdx
+        pTalon->SelectProfileSlot(slotIndex, 0);
+    }
+    
+    ////////////////////////////////////////////////////////////////
+    /// @method YtaTalon::ConfigureVoltageCompensation
+    ///
+    /// Scales a Talon's output against a fixed voltage instead of
+    /// the battery, so the same command gives the same output as
+    /// the battery sags.
+    ///
+    ////////////////////////////////////////////////////////////////
+    template <class TalonType>
+    inline void ConfigureVoltageCompensation(TalonType * pTalon, double saturationVolts)
+    {
+        // voltage, timeoutMs
+        pTalon->ConfigVoltageCompSaturation(saturationVolts, 0);
+        pTalon->EnableVoltageCompensation(true);
+    }
 }
 
 
@@ -77,6 +141,18 @@ public:
     // Function to set the speed of each motor in the group
     void Set( double value, double offset = 0.0 );
     
+    // Function to set the closed loop velocity (sensor units per 100ms) of each motor in the group
+    void SetVelocity( double velocity, double offset = 0.0 );
+    
+    // Configure the non-follower motors for closed loop velocity control
+    void ConfigureVelocityControl(const YtaTalon::PidConfig & rPidConfig, int slotIndex = 0);
+    
+    // Compensate every motor's output against a fixed voltage
+    void ConfigureVoltageCompensation(double saturationVolts);
+    
+    // Return the velocity (sensor units per 100ms) of the sensor connected to the master Talon
+    int GetVelocity();
+    
     // Sets the control mode of a motor in a group (intended for use with the CUSTOM group control mode)
     bool SetMotorInGroupControlMode(int canId, MotorGroupControlMode controlMode);
     
@@ -96,17 +172,22 @@ private:
         TalonType * m_pTalon;
         MotorGroupControlMode m_ControlMode;
         int m_CanId;
+        YtaTalon::WriteCache m_WriteCache;
         
         MotorInfo(MotorGroupControlMode controlMode, int canId) :
             m_pTalon(new TalonType(canId)),
             m_ControlMode(controlMode),
-            m_CanId(canId)
+            m_CanId(canId),
+            m_WriteCache()
         {
         }
     };
 
     static const int MAX_NUMBER_OF_MOTORS = 4;
     static const int GROUP_MASTER_CAN_ID = 0xFF;
+    
+    // Sends an output to each motor based on its group control mode
+    void SetOutput( ControlMode controlMode, double value, double offset );
 
     // Member variables
     int m_NumMotors;                                        // Number of motors in the group
@@ -205,7 +286,7 @@ TalonMotorGroup<TalonType>::TalonMotorGroup( int numMotors, int masterCanId, Mot
             // the Set() method, so we only need to set the followers here.
             if (nonMasterControlMode == YtaTalon::FOLLOW)
             {
-                m_pMotorsInfo[i]->m_pTalon->Set(ControlMode::Follower, masterCanId);
+                YtaTalon::ConfigureFollower(m_pMotorsInfo[i]->m_pTalon, masterCanId);
             }
         }
         
@@ -239,7 +320,7 @@ bool TalonMotorGroup<TalonType>::AddMotorToGroup(MotorGroupControlMode controlMo
         // If this Talon will be a follower, be sure to call Set() to enable it
         if (controlMode == YtaTalon::FOLLOW)
         {
-            m_pMotorsInfo[m_NumMotors]->m_pTalon->Set(ControlMode::Follower, m_MasterCanId);
+            YtaTalon::ConfigureFollower(m_pMotorsInfo[m_NumMotors]->m_pTalon, m_MasterCanId);
         }
 
         // Increase the number of motors
@@ -273,11 +354,14 @@ bool TalonMotorGroup<TalonType>::SetMotorInGroupControlMode(int canId, MotorGrou
         {
             // ...set the control mode
             m_pMotorsInfo[i]->m_ControlMode = controlMode;
+            
+            // Whatever this motor was last sent no longer applies
+            m_pMotorsInfo[i]->m_WriteCache.Invalidate();
 
             // If this Talon will be a follower, be sure to call Set() to enable it
             if (controlMode == YtaTalon::FOLLOW)
             {
-                m_pMotorsInfo[i]->m_pTalon->Set(ControlMode::Follower, m_MasterCanId);
+                YtaTalon::ConfigureFollower(m_pMotorsInfo[i]->m_pTalon, m_MasterCanId);
             }
             
             // Indicate success
@@ -334,7 +418,7 @@ void TalonMotorGroup<TalonType>::SetBrakeMode()
 template <class TalonType>
 void TalonMotorGroup<TalonType>::TareEncoder()
 {
-    if (m_Sensor == FeedbackDevice::CTRE_MagEncoder_Relative)
+    if ((m_Sensor == FeedbackDevice::CTRE_MagEncoder_Relative) || (m_Sensor == FeedbackDevice::IntegratedSensor))
     {
         // sensorPos, pidIdx, timeoutMs
         m_pMotorsInfo[0]->m_pTalon->SetSelectedSensorPosition(0, 0, 0);
@@ -355,7 +439,7 @@ int TalonMotorGroup<TalonType>::GetEncoderValue()
 {
     int sensorValue = 0;
 
-    if (m_Sensor == FeedbackDevice::CTRE_MagEncoder_Relative)
+    if ((m_Sensor == FeedbackDevice::CTRE_MagEncoder_Relative) || (m_Sensor == FeedbackDevice::IntegratedSensor))
     {
         // pidIdx
         sensorValue = m_pMotorsInfo[0]->m_pTalon->GetSelectedSensorPosition(0);
@@ -366,6 +450,77 @@ int TalonMotorGroup<TalonType>::GetEncoderValue()
 
 
 
+////////////////////////////////////////////////////////////////
+/// @method TalonMotorGroup::ConfigureVelocityControl
+///
+/// Method to set up closed loop velocity control.  Every motor
+/// that isn't a follower runs its own loop on its own sensor,
+/// so each one gets the sensor and gains.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType>
+void TalonMotorGroup<TalonType>::ConfigureVelocityControl(const YtaTalon::PidConfig & rPidConfig, int slotIndex)
+{
+    for (int i = 0; i < m_NumMotors; i++)
+    {
+        if (m_pMotorsInfo[i]->m_ControlMode == YtaTalon::FOLLOW)
+        {
+            continue;
+        }
+        
+        if (m_Sensor != FeedbackDevice::None)
+        {
+            // feedbackDevice, pidIdx, timeoutMs
+            m_pMotorsInfo[i]->m_pTalon->ConfigSelectedFeedbackSensor(m_Sensor, 0, 0);
+        }
+        
+        YtaTalon::ConfigurePidSlot(m_pMotorsInfo[i]->m_pTalon, slotIndex, rPidConfig);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method TalonMotorGroup::ConfigureVoltageCompensation
+///
+/// Method to compensate the output of every motor in the group
+/// against a fixed voltage.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType>
+void TalonMotorGroup<TalonType>::ConfigureVoltageCompensation(double saturationVolts)
+{
+    for (int i = 0; i < m_NumMotors; i++)
+    {
+        YtaTalon::ConfigureVoltageCompensation(m_pMotorsInfo[i]->m_pTalon, saturationVolts);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method TalonMotorGroup::GetVelocity
+///
+/// Method to get the velocity from the sensor connected to the
+/// master Talon controller.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType>
+int TalonMotorGroup<TalonType>::GetVelocity()
+{
+    int sensorVelocity = 0;
+
+    if (m_Sensor != FeedbackDevice::None)
+    {
+        // pidIdx
+        sensorVelocity = m_pMotorsInfo[0]->m_pTalon->GetSelectedSensorVelocity(0);
+    }
+    
+    return sensorVelocity;
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 /// @method TalonMotorGroup::Set
 ///
@@ -376,6 +531,39 @@ int TalonMotorGroup<TalonType>::GetEncoderValue()
 ////////////////////////////////////////////////////////////////
 template <class TalonType>
 void TalonMotorGroup<TalonType>::Set( double value, double offset )
+{
+    SetOutput(ControlMode::PercentOutput, value, offset);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method TalonMotorGroup::SetVelocity
+///
+/// Method to set the closed loop velocity of each motor in the
+/// group.  ConfigureVelocityControl() must be called first.
+/// Inverse motors get the negated velocity, the same as Set().
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType>
+void TalonMotorGroup<TalonType>::SetVelocity( double velocity, double offset )
+{
+    SetOutput(ControlMode::Velocity, velocity, offset);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method TalonMotorGroup::SetOutput
+///
+/// Method to send an output to each motor in the group.  The
+/// offset parameter is only valid for motor groups configured
+/// as *_OFFSET.  Calls that repeat a motor's last output are
+/// skipped to save Phoenix API calls.
+///
+////////////////////////////////////////////////////////////////
+template <class TalonType>
+void TalonMotorGroup<TalonType>::SetOutput( ControlMode controlMode, double value, double offset )
 {
     for (int i = 0; i < m_NumMotors; i++)
     {
@@ -398,8 +586,8 @@ void TalonMotorGroup<TalonType>::Set( double value, double offset )
             case YtaTalon::MASTER:
             case YtaTalon::INDEPENDENT:
             {
-                // The master always gets set via percent voltage, as do
-                // motors that are independently controlled (not follow or inverse).
+                // The master always gets set directly, as do motors
+                // that are independently controlled (not follow or inverse).
                 valueToSet = value;
                 break;
             }
@@ -435,10 +623,10 @@ void TalonMotorGroup<TalonType>::Set( double value, double offset )
             }
         };
             
-        if (bCallSet)
+        // Set the value in the Talon, unless it's what was already sent
+        if (bCallSet && m_pMotorsInfo[i]->m_WriteCache.IsWriteNeeded(controlMode, valueToSet))
         {
-            // Set the value in the Talon
-            m_pMotorsInfo[i]->m_pTalon->Set(ControlMode::PercentOutput, valueToSet);
+            m_pMotorsInfo[i]->m_pTalon->Set(controlMode, valueToSet);
         }
     }
 }
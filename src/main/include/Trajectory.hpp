@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   Trajectory.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for a precomputed trajectory loaded from the deploy
+/// directory.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "TrajectoryRecords.hpp"        // for the trajectory file layout
+
+using namespace TrajectoryRecords;
+
+
+////////////////////////////////////////////////////////////////
+/// @class Trajectory
+///
+/// A path generated offline by the trajectory generator.  The
+/// file is read once when the robot starts, into a fixed table,
+/// so nothing reads files or allocates during a match.  Like
+/// TrapezoidalProfile, there is one point per robot loop and
+/// following it is just an index into the table.
+///
+////////////////////////////////////////////////////////////////
+class Trajectory
+{
+public:
+
+    // Constructor
+    Trajectory() :
+        m_Points(),
+        m_NumPoints(0U)
+    {
+    }
+
+    // Read a trajectory file, returns false if it's missing or doesn't match this code
+    bool Load(const char * pFileName, double periodS);
+
+    // Whether a trajectory has been loaded
+    inline bool IsLoaded() const
+    {
+        return (m_NumPoints > 0U);
+    }
+
+    // Number of points in the trajectory
+    inline unsigned GetNumPoints() const
+    {
+        return m_NumPoints;
+    }
+
+    // Get a point, indexes past the end hold at the final one
+    inline const Point & GetPoint(unsigned index) const
+    {
+        return m_Points[(index < m_NumPoints) ? index : (m_NumPoints - 1U)];
+    }
+
+    // Whether an index is at or past the end of the trajectory
+    inline bool IsFinished(unsigned index) const
+    {
+        return ((index + 1U) >= m_NumPoints);
+    }
+
+private:
+
+    // Twenty seconds of 20ms loops, longer than autonomous
+    static const unsigned   MAX_POINTS = 1024U;
+
+    Point                   m_Points[MAX_POINTS];
+    unsigned                m_NumPoints;
+
+    Trajectory(const Trajectory &) = delete;
+    Trajectory & operator=(const Trajectory &) = delete;
+};
+
+#endif // TRAJECTORY_HPP
@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   TrajectoryRecords.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains the layout of a precomputed trajectory file.  Shared between the
+/// robot code and the offline trajectory generator, so it can only use
+/// standard headers.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TRAJECTORYRECORDS_HPP
+#define TRAJECTORYRECORDS_HPP
+
+// SYSTEM INCLUDES
+#include <cstdint>                      // for sized integer types
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @namespace TrajectoryRecords
+///
+/// A trajectory file is a file header followed by one point per
+/// robot loop, evenly spaced in time.  Following a trajectory
+/// is just stepping through the points one per loop.  Both the
+/// roboRIO and a PC are little endian with IEEE floats, so the
+/// structures are written to the file as is.
+///
+/// Points are in inches with x forward and y to the left of the
+/// pose the robot starts autonomous in, and the heading is in
+/// radians counter clockwise (the same as DriveOdometry).
+///
+////////////////////////////////////////////////////////////////
+namespace TrajectoryRecords
+{
+    // Bump when the layout of a point changes
+    static const uint16_t   TRAJECTORY_VERSION      = 1U;
+    static const char       TRAJECTORY_MAGIC[4]     = {'Y', 'T', 'A', 'T'};
+
+    struct FileHeader
+    {
+        char        m_Magic[4];
+        uint16_t    m_Version;
+        uint16_t    m_PointSize;
+        uint32_t    m_NumPoints;
+        float       m_PeriodS;
+    };
+
+    struct Point
+    {
+        float       m_TimeS;
+        float       m_X;
+        float       m_Y;
+        float       m_Heading;
+        float       m_Velocity;         // in/s
+        float       m_Acceleration;     // in/s^2
+        float       m_Curvature;        // rad/in, positive turning left
+    };
+
+    static_assert(sizeof(FileHeader) == 16U, "Trajectory file header size changed");
+    static_assert(sizeof(Point) == 28U, "Trajectory point size changed");
+
+} // End namespace
+
+#endif // TRAJECTORYRECORDS_HPP
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   TrapezoidalProfile.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for a precomputed trapezoidal motion profile.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TRAPEZOIDALPROFILE_HPP
+#define TRAPEZOIDALPROFILE_HPP
+
+// SYSTEM INCLUDES
+// <none>
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class TrapezoidalProfile
+///
+/// An acceleration limited move from rest to rest.  The move is
+/// worked out once when it starts and stored as a table with one
+/// setpoint per robot loop, so following it is just an index
+/// into the table.  Moves too short to reach the cruise velocity
+/// become triangles.
+///
+////////////////////////////////////////////////////////////////
+class TrapezoidalProfile
+{
+public:
+
+    // Where the move should be at one loop
+    struct Setpoint
+    {
+        float   m_Position;
+        float   m_Velocity;
+        float   m_Acceleration;
+    };
+
+    // Constructor
+    TrapezoidalProfile() :
+        m_Setpoints(),
+        m_NumSetpoints(0U)
+    {
+    }
+
+    // Work out a new move, returns false if it does not fit in the table
+    bool Generate(double distance, double maxVelocity, double maxAcceleration, double periodS);
+
+    // Number of setpoints in the current move
+    inline unsigned GetNumSetpoints() const
+    {
+        return m_NumSetpoints;
+    }
+
+    // Get a setpoint, indexes past the end hold at the final one
+    inline const Setpoint & GetSetpoint(unsigned index) const
+    {
+        return m_Setpoints[(index < m_NumSetpoints) ? index : (m_NumSetpoints - 1U)];
+    }
+
+    // Whether an index is at or past the end of the move
+    inline bool IsFinished(unsigned index) const
+    {
+        return ((index + 1U) >= m_NumSetpoints);
+    }
+
+private:
+
+    // Ten seconds of 20ms loops, longer than any autonomous move
+    static const unsigned   MAX_SETPOINTS = 512U;
+
+    Setpoint                m_Setpoints[MAX_SETPOINTS];
+    unsigned                m_NumSetpoints;
+
+    TrapezoidalProfile(const TrapezoidalProfile &) = delete;
+    TrapezoidalProfile & operator=(const TrapezoidalProfile &) = delete;
+};
+
+#endif // TRAPEZOIDALPROFILE_HPP
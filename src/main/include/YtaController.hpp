@@ -20,7 +20,7 @@
 #include "frc/GenericHID.h"             // for base class declaration
 
 // C++ INCLUDES
-// (none)
+#include "InputShaping.hpp"             // for InputShapingConfig, InputShapingTable
 
 using namespace frc;
 
@@ -73,11 +73,26 @@ public:
         const unsigned RIGHT_STICK_CLICK;
     };
 
-    // Mappings for a controller (axes and buttons)
+    // Structure representing how the drive axes are shaped
+    struct AxisShaping
+    {
+        const InputShapingConfig X_AXIS;
+        const InputShapingConfig Y_AXIS;
+    };
+
+    // Mappings for a controller (axes, buttons and drive shaping)
     struct ControllerMappings
     {
         const AxisMappings AXIS_MAPPINGS;
         const ButtonMappings BUTTON_MAPPINGS;
+        const AxisShaping AXIS_SHAPING;
+    };
+
+    // Lookup tables built from a controller's drive shaping
+    struct ShapingTables
+    {
+        const InputShapingTable X_AXIS;
+        const InputShapingTable Y_AXIS;
     };
     
     // Constant expression function to retrieve the mapping for a controller at compile time
@@ -103,6 +118,29 @@ public:
         }
     }
     
+    // Constant expression function to retrieve the drive shaping tables for a controller at compile time
+    static constexpr const ShapingTables * GetShapingTables(CustomControllerType controllerType)
+    {
+        switch (controllerType)
+        {
+            case LOGITECH:
+            {
+                return &LOGITECH_SHAPING_TABLES;
+                break;
+            }
+            case PLAY_STATION:
+            {
+                return &PLAY_STATION_SHAPING_TABLES;
+                break;
+            }
+            default:
+            {
+                return nullptr;
+                break;
+            }
+        }
+    }
+    
     // Constructor/destructor
     explicit YtaController(CustomControllerType controllerType, int port, bool bIsDriveController);
     virtual ~YtaController() = default;
@@ -218,6 +256,12 @@ private:
             LogitechController::RawButtons::RB,
             LogitechController::RawButtons::LEFT_STICK_CLICK,
             LogitechController::RawButtons::RIGHT_STICK_CLICK
+        },
+        {
+            // x-axis controls are very sensitive on this controller, so scale them back.
+            // Expo stays at zero (linear) until the drivers have tried a curve.
+            {0.10, 0.00, 0.75},
+            {0.10, 0.00, 1.00}
         }
     };
 
@@ -244,9 +288,26 @@ private:
             PlayStationController::RawButtons::R1,
             PlayStationController::RawButtons::LEFT_STICK_CLICK,
             PlayStationController::RawButtons::RIGHT_STICK_CLICK,
+        },
+        {
+            {0.10, 0.00, 0.75},
+            {0.05, 0.00, 1.00}
         }
     };
 
+    // Constant expression drive shaping tables, built when the code compiles
+    static constexpr const ShapingTables LOGITECH_SHAPING_TABLES =
+    {
+        InputShapingTable(LOGITECH_CONTROLLER_MAPPINGS.AXIS_SHAPING.X_AXIS),
+        InputShapingTable(LOGITECH_CONTROLLER_MAPPINGS.AXIS_SHAPING.Y_AXIS)
+    };
+
+    static constexpr const ShapingTables PLAY_STATION_SHAPING_TABLES =
+    {
+        InputShapingTable(PLAY_STATION_CONTROLLER_MAPPINGS.AXIS_SHAPING.X_AXIS),
+        InputShapingTable(PLAY_STATION_CONTROLLER_MAPPINGS.AXIS_SHAPING.Y_AXIS)
+    };
+
     ////////////////////////////////////////////////////////////////
     /// @method YtaController::NormalizeTriggers
     ///
@@ -284,9 +345,6 @@ private:
     const bool IS_DRIVE_CONTROLLER;
     double m_ThrottleValue;
     
-    static constexpr double X_AXIS_DRIVE_SENSITIVITY_SCALING = 0.75;
-    static constexpr double Y_AXIS_DRIVE_SENSITIVITY_SCALING = 1.00;
-    
     // Prevent copying/assignment
     YtaController(const YtaController&) = delete;
     YtaController& operator=(const YtaController&) = delete;
@@ -37,13 +37,25 @@
 #include "frc/XboxController.h"                 // for creating Xbox controller objects
 #include "frc/smartdashboard/SendableChooser.h" // for using the smart dashboard sendable chooser functionality
 #include "frc/smartdashboard/SmartDashboard.h"  // for interacting with the smart dashboard
-#include "rev/ColorMatch.h"                     // for matching colors from the color sensor
 #include "rev/ColorSensorV3.h"                  // for interacting with the color sensor
 
 // C++ INCLUDES
 #include "RobotI2c.hpp"                         // for GetGyroData()
+#include "RobotLogger.hpp"                      // for logging match data
+#include "RobotTelemetry.hpp"                   // for publishing telemetry
+#include "RobotTiming.hpp"                      // for JitterMonitor
+#include "CachedTalon.hpp"                      // for Talons that skip redundant writes
+#include "ColorWheel.hpp"                       // for the control panel spinner
+#include "ControllerSnapshot.hpp"               // for reading controller inputs once per loop
+#include "DriveOdometry.hpp"                    // for tracking the robot's position
+#include "HeadingController.hpp"                // for turning to a gyro heading
+#include "InputShaping.hpp"                     // for drive input shaping and slew limiting
+#include "RamseteController.hpp"                // for following trajectories
 #include "RobotUtils.hpp"                       // for ASSERT, DEBUG_PRINTS
+#include "StaticTalonMotorGroup.hpp"            // for fixed layout Talon group motor control
 #include "TalonMotorGroup.hpp"                  // for Talon group motor control
+#include "Trajectory.hpp"                       // for precomputed autonomous paths
+#include "TrapezoidalProfile.hpp"               // for encoder drive motion profiles
 #include "YtaController.hpp"                    // for custom controller interaction
 
 using namespace frc;
@@ -60,6 +72,8 @@ class YtaRobot : public TimedRobot
 {
 public:
     friend class RobotCamera;
+    friend class RobotBenchmarks;
+    friend class LogReplay;
 
     // MEMBER FUNCTIONS
     
@@ -95,6 +109,8 @@ private:
     typedef DriverStation::Alliance Alliance;
     typedef GenericHID::JoystickHand JoystickHand;
     typedef YtaTalon::MotorGroupControlMode MotorGroupControlMode;
+    typedef StaticTalonMotorGroup<TalonFX, YtaTalon::MASTER, YtaTalon::FOLLOW> DriveMotorGroup;
+    typedef StaticTalonMotorGroup<TalonFX, YtaTalon::MASTER, YtaTalon::INVERSE> ShooterMotorGroup;
     typedef YtaController::CustomControllerType CustomControllerType;
     typedef YtaController::ControllerMappings ControllerMappings;
     
@@ -147,7 +163,44 @@ private:
         REVERSE_GUIDE   = 0x20
     };
     
+    // The kinds of steps an autonomous routine is built from
+    enum AutonomousStepType
+    {
+        AUTO_STEP_DELAY,
+        AUTO_STEP_DRIVE,
+        AUTO_STEP_ENCODER_DRIVE,
+        AUTO_STEP_GYRO_TURN,
+        AUTO_STEP_BACK_DRIVE,
+        AUTO_STEP_BACK_DRIVE_TURN,
+        AUTO_STEP_SONAR_DRIVE,
+        AUTO_STEP_CAMERA_ALIGN,
+        AUTO_STEP_TRAJECTORY,
+        AUTO_STEP_REPEAT,
+        AUTO_STEP_END
+    };
+    
+    // The precomputed paths in the deploy directory
+    enum TrajectoryId
+    {
+        TRAJECTORY_COMMON_RED,
+        TRAJECTORY_COMMON_BLUE,
+        NUM_TRAJECTORIES
+    };
+    
     // STRUCTS
+    
+    // One step of an autonomous routine.  Routines are tables of
+    // these that are advanced one step tick per robot loop.
+    struct AutonomousStep
+    {
+        AutonomousStepType  m_Type;
+        RobotDirection      m_Direction;
+        double              m_Speed;
+        double              m_Value;        // Time, distance, angle or step index, depending on the type
+        unsigned            m_Option;       // Sonar drive state, trajectory ID, or non-zero to enable motors on a camera align
+        double              m_TimeoutS;     // The step is abandoned if it runs longer than this
+    };
+    
     struct TriggerChangeValues
     {
     public:
@@ -158,11 +211,9 @@ private:
         };
         
         // Constructor
-        TriggerChangeValues(GenericHID * rpJoystick, int button) :
-            m_pJoystick(rpJoystick),
-            m_ButtonNumber(button),
-            m_bCurrentValue(false),
-            m_bOldValue(false)
+        TriggerChangeValues(const ControllerSnapshot * pInputs, int button) :
+            m_pInputs(pInputs),
+            m_ButtonNumber(button)
         {
         }
         
@@ -170,10 +221,8 @@ private:
         inline bool DetectChange(TriggerEdge edge = RISING_EDGE_TRIGGER);
         
     private:
-        GenericHID * m_pJoystick;
+        const ControllerSnapshot * m_pInputs;
         int m_ButtonNumber;
-        bool m_bCurrentValue;
-        bool m_bOldValue;
     };
     
     // This is a hacky way of retrieving a pointer to the robot object
@@ -190,6 +239,13 @@ private:
     // Increments a variable to indicate the robot code is successfully running
     inline void HeartBeat();
     
+    // Reads both controllers for this loop
+    inline void UpdateControllerInputs()
+    {
+        m_DriveInputs.Update(m_pDriveJoystick);
+        m_ControlInputs.Update(m_pControlJoystick);
+    }
+    
     // Checks for a robot state change and logs a message if so
     inline void CheckAndUpdateRobotMode(RobotMode robotMode);
 
@@ -199,19 +255,18 @@ private:
     // Get a reading from the gyro sensor
     inline double GetGyroValue(GyroType gyroType, AnalogGyro * pSensor = nullptr);
     
-    // Convert a distance in inches to encoder turns
-    int GetEncoderRotationsFromInches(int inches, double diameter, bool bUseQuadEncoding = true);
-
-    // Autonomous wait for something to complete delay routine
-    inline void AutonomousDelay(double time);
-
-    // Autonomous drive for a specified time
-    inline void AutonomousDriveSequence(RobotDirection direction, double speed, double time);
+    // Autonomous drive in a direction (the step timer decides for how long)
+    inline void AutonomousDriveSequence(RobotDirection direction, double speed);
     
     // Autonomous routines to back drive the motors to abruptly stop
     inline void AutonomousBackDrive(RobotDirection currentDirection);
     inline void AutonomousBackDriveTurn(RobotDirection currentDirection);
     
+    // Autonomous step engine
+    void StartAutonomousRoutine(const AutonomousStep * pSteps);
+    bool RunAutonomousRoutine();
+    bool ExecuteAutonomousStep(const AutonomousStep & rStep, bool bFirstTick);
+    
     // Autonomous routines
     // @todo: Make YtaRobotAutonomous a friend and move these out (requires accessor to *this)!
     void AutonomousRoutine1();
@@ -220,10 +275,33 @@ private:
     void AutonomousCommon();
     void AutonomousCommonRed();
     void AutonomousCommonBlue();
-    bool AutonomousGyroLeftTurn(double destAngle, double turnSpeed);
-    bool AutonomousGyroRightTurn(double destAngle, double turnSpeed);
-    void AutonomousEncoderDrive(double speed, double distance, RobotDirection direction);
+    
+    // Autonomous step functions, called once per loop until they return true
+    bool AutonomousGyroLeftTurn(double destAngle, double turnSpeed, bool bFirstTick);
+    bool AutonomousGyroRightTurn(double destAngle, double turnSpeed, bool bFirstTick);
+    bool AutonomousGyroTurn(double destAngle, double turnSpeed, bool bFirstTick);
+    bool AutonomousEncoderDrive(double speed, double distance, RobotDirection direction, bool bFirstTick);
     bool AutonomousSonarDrive(RobotDirection direction, SonarDriveState driveState, uint32_t destLateralDist, uint32_t destSideDist);
+    bool AutonomousTrajectoryDrive(unsigned trajectory, bool bFirstTick);
+    
+    // Reads the autonomous paths from the deploy directory
+    void LoadTrajectories();
+
+    // Logs this loop's inputs, outputs and sensors to the match log
+    void LogLoopData();
+    
+    // Gathers what LogLoopData() logs
+    void FillLoopData(RobotLogRecords::LoopData & rLoopData);
+    
+    // Moves the field pose by what the drive and gyro did this loop
+    void UpdateOdometry();
+    
+    // Zero the drive encoders without odometry seeing it as movement
+    inline void TareDriveEncoders();
+    
+    // How far each side of the drive has gone, positive is forward
+    inline double GetLeftDriveInches();
+    inline double GetRightDriveInches();
 
     // Routine to put things in a known state
     void InitialStateSetup();
@@ -268,6 +346,18 @@ private:
 
     // Main sequence for the turret
     void TurretSequence();
+    
+    // Re-zeroes the turret encoder when the center hall sensor is reached
+    void UpdateTurretReference();
+    
+    // Aims the turret at the limelight target with closed loop position control
+    void TurretTrackTarget();
+    
+    // The turret angle from its encoder, in degrees (90 right, 180 center, 270 left)
+    inline double GetTurretAngle()
+    {
+        return TURRET_CENTER_ANGLE_DEGREES + (m_pTurretMotor->GetSelectedSensorPosition(0) / TURRET_ENCODER_TICKS_PER_DEGREE);
+    }
 
     // Main sequence for interacting with the color sensor
     void ColorSequence();
@@ -275,6 +365,9 @@ private:
     // Main sequence for hanging
     void HangSequence();
     
+    // Low rate reads of slow changing motor status
+    void MotorStatusSequence();
+    
     // Test routines for trying out experimental code
     void AutonomousTestCode();
     void TeleopTestCode();
@@ -286,6 +379,16 @@ private:
     
     // Autonomous
     SendableChooser<std::string>    m_AutonomousChooser;                    // Selects from the dashboard which auto routine to run
+    const AutonomousStep *          m_pAutonomousSteps;                     // Step table of the running autonomous routine
+    unsigned                        m_AutonomousStepIndex;                  // Which step in the table is executing
+    bool                            m_bAutonomousStepStarted;               // Whether the current step has had its first tick
+    TrapezoidalProfile              m_EncoderDriveProfile;                  // Setpoints for the encoder drive in progress
+    unsigned                        m_EncoderDriveSetpointIndex;            // Next setpoint the encoder drive will follow
+    int                             m_EncoderDriveLeftStart;                // Left encoder when the encoder drive started
+    int                             m_EncoderDriveRightStart;               // Right encoder when the encoder drive started
+    Trajectory                      m_Trajectories[NUM_TRAJECTORIES];       // Paths read from the deploy directory at start up
+    RamseteController               m_RamseteController;                    // Keeps the robot on a trajectory
+    unsigned                        m_TrajectoryPointIndex;                 // Next point the trajectory drive will follow
     
     // User Controls
     DriverStation *                 m_pDriverStation;                       // Driver station object for getting selections
@@ -297,15 +400,33 @@ private:
     Joystick *                      m_pControlLogitechExtreme;              // Option 2: Logitech Extreme can use the Joystick class
     XboxController *                m_pDriveXboxGameSir;                    // Option 3: Xbox-based controller (also works for Logitech Gamepad)
     XboxController *                m_pControlXboxGameSir;                  // Option 3: Xbox-based controller (also works for Logitech Gamepad)
+    ControllerSnapshot              m_DriveInputs;                          // Drive controller inputs read at the start of the loop
+    ControllerSnapshot              m_ControlInputs;                        // Control controller inputs read at the start of the loop
     
     // Motors
-    TalonMotorGroup<TalonFX> *      m_pLeftDriveMotors;                     // Left drive motor control
-    TalonMotorGroup<TalonFX> *      m_pRightDriveMotors;                    // Right drive motor control
-    TalonMotorGroup<TalonFX> *      m_pShooterMotors;                       // Shooter motor control
-    TalonFX *                       m_pWinchMotor;                          // Winch motor control
-    TalonSRX *                      m_pIntakeMotor;                         // Intake motor control
-    TalonSRX *                      m_pTurretMotor;                         // Turrent motor control
-    TalonSRX *                      m_pColorWheelMotor;                     // Color wheel motor control
+    DriveMotorGroup *               m_pLeftDriveMotors;                     // Left drive motor control
+    DriveMotorGroup *               m_pRightDriveMotors;                    // Right drive motor control
+    ShooterMotorGroup *             m_pShooterMotors;                       // Shooter motor control
+    CachedTalon<TalonFX> *          m_pWinchMotor;                          // Winch motor control
+    CachedTalon<TalonSRX> *         m_pIntakeMotor;                         // Intake motor control
+    CachedTalon<TalonSRX> *         m_pTurretMotor;                         // Turrent motor control
+    CachedTalon<TalonSRX> *         m_pColorWheelMotor;                     // Color wheel motor control
+    SlewRateLimiter                 m_LeftDriveSlewLimiter;                 // Keeps left drive output from building up too fast
+    SlewRateLimiter                 m_RightDriveSlewLimiter;                // Keeps right drive output from building up too fast
+    unsigned                        m_MotorStatusLoopCount;                 // Loops since the motor status was last read
+    double                          m_ShooterTargetRpm;                     // Speed the shooter is being asked to hold (zero when off)
+    unsigned                        m_ShooterAtSpeedLoopCount;              // Consecutive loops the shooter has been within tolerance
+    bool                            m_bShooterAtSpeed;                      // Shooter is at its target speed and ready for a ball
+    double                          m_TurretTargetAngle;                    // Where the turret is being aimed while tracking
+    bool                            m_bTurretTracking;                      // Turret is aiming itself at the vision target
+    bool                            m_bTurretAtCenter;                      // Center hall sensor saw the magnet last loop
+    
+    // Closed loop turning
+    HeadingController               m_HeadingController;                    // Turns the robot to a heading for aligns and autonomous
+    
+    // Field position
+    DriveOdometry                   m_Odometry;                             // Where the robot is, from the drive encoders, gyro and vision
+    uint32_t                        m_OdometryFrameSequence;                // Last limelight frame odometry used
     
     // Spike Relays
     Relay *                         m_pLedsEnableRelay;                     // Controls whether the LEDs will light up at all
@@ -333,6 +454,9 @@ private:
     TriggerChangeValues *           m_pShooterSolenoidTrigger;
     TriggerChangeValues *           m_pHangerRaiseSolenoidTrigger;
     TriggerChangeValues *           m_pHangerExtendSolenoidTrigger;
+    TriggerChangeValues *           m_pTurretTrackingTrigger;
+    TriggerChangeValues *           m_pColorWheelRotationTrigger;
+    TriggerChangeValues *           m_pColorWheelPositionTrigger;
     
     // Servos
     // (none)
@@ -344,14 +468,13 @@ private:
     Timer *                         m_pAutonomousTimer;                     // Time things during autonomous
     Timer *                         m_pInchingDriveTimer;                   // Keep track of an inching drive operation
     Timer *                         m_pDirectionalAlignTimer;               // Keep track of a directional align operation
-    Timer *                         m_pSafetyTimer;                         // Fail safe in case critical operations don't complete
     
     // Accelerometer
     BuiltInAccelerometer *          m_pAccelerometer;                       // Built in roborio accelerometer
     
     // Gyro
     ADXRS450_Gyro *                 m_pAdxrs450Gyro;                        // SPI port FRC gyro
-    int                             m_Bno055Angle;                          // Angle from the BNO055 sensor on the RIOduino
+    double                          m_Bno055Angle;                          // Angle from the BNO055 sensor
 
     // Camera
     // Note: Only need to have a thread here and tie it to
@@ -375,11 +498,9 @@ private:
     // I2C configuration
     std::thread                     m_I2cThread;
     rev::ColorSensorV3 *            m_pColorSensor;
-    rev::ColorMatch *               m_pColorMatcher;
-    static constexpr frc::Color     BLUE_TARGET_COLOR                       = frc::Color(0.143, 0.427, 0.429);
-    static constexpr frc::Color     GREEN_TARGET_COLOR                      = frc::Color(0.197, 0.561, 0.240);
-    static constexpr frc::Color     RED_TARGET_COLOR                        = frc::Color(0.561, 0.232, 0.114);
-    static constexpr frc::Color     YELLOW_TARGET_COLOR                     = frc::Color(0.361, 0.524, 0.113);
+    ColorWheel                      m_ColorWheel;                           // Classifies panel colors and runs the spinner
+    ColorWheel::WheelColor          m_FieldTargetColor;                     // Position control color from the game data, cached once it arrives
+    unsigned                        m_GameDataLoopCount;                    // Loops since the game data was last checked
     
     // Misc
     RobotMode                       m_RobotMode;                            // Keep track of the current robot state
@@ -387,12 +508,7 @@ private:
     Alliance                        m_AllianceColor;                        // Color reported by driver station during a match
     bool                            m_bDriveSwap;                           // Allow the user to push a button to change forward/reverse
     uint32_t                        m_HeartBeat;                            // Incremental counter to indicate the robot code is executing
-    std::string                     m_GameData;                             // String representing 2020 game specific data
-
-    static const char               GAME_DATA_BLUE                          = 'B';
-    static const char               GAME_DATA_GREEN                         = 'G';
-    static const char               GAME_DATA_RED                           = 'R';
-    static const char               GAME_DATA_YELLOW                        = 'Y';
+    RobotTiming::JitterMonitor      m_LoopJitterMonitor;                    // How steadily TimedRobot runs the loop
     
     // CONSTS
     
@@ -427,6 +543,9 @@ private:
     
     // Control buttons
     static const int                TURRET_CONTROL_AXIS                     = CONTROL_CONTROLLER_MAPPINGS->AXIS_MAPPINGS.LEFT_X_AXIS;
+    static const int                TURRET_TRACKING_TOGGLE_BUTTON           = CONTROL_CONTROLLER_MAPPINGS->BUTTON_MAPPINGS.START;
+    static const int                COLOR_WHEEL_ROTATION_BUTTON             = CONTROL_CONTROLLER_MAPPINGS->BUTTON_MAPPINGS.SELECT;
+    static const int                COLOR_WHEEL_POSITION_BUTTON             = CONTROL_CONTROLLER_MAPPINGS->BUTTON_MAPPINGS.LEFT_STICK_CLICK;
     static const int                INTAKE_SOLENOID_CHANGE_STATE_BUTTON     = CONTROL_CONTROLLER_MAPPINGS->BUTTON_MAPPINGS.RIGHT_BUTTON;
     static const int                SHOOTER_SOLENOID_CHANGE_STATE_BUTTON    = CONTROL_CONTROLLER_MAPPINGS->BUTTON_MAPPINGS.UP_BUTTON;
     static const int                INTAKE_FORWARD_BUTTON                   = CONTROL_CONTROLLER_MAPPINGS->BUTTON_MAPPINGS.LEFT_BUMPER;
@@ -481,15 +600,11 @@ private:
     static const int                OFF                                     = 0;
     static const int                ON                                      = 1;
     static const int                SINGLE_MOTOR                            = 1;
-    static const int                NUMBER_OF_LEFT_DRIVE_MOTORS             = 2;
-    static const int                NUMBER_OF_RIGHT_DRIVE_MOTORS            = 2;
-    static const int                NUMBER_OF_SHOOTER_MOTORS                = 2;
     static const int                ANGLE_90_DEGREES                        = 90;
     static const int                ANGLE_180_DEGREES                       = 180;
     static const int                ANGLE_360_DEGREES                       = 360;
     static const int                POV_INPUT_TOLERANCE_VALUE               = 30;
     static const int                SCALE_TO_PERCENT                        = 100;
-    static const int                QUADRATURE_ENCODING_ROTATIONS           = 4096;
     static const char               NULL_CHARACTER                          = '\0';
     
     static const bool               USE_INVERTED_REVERSE_CONTROLS           = true;
@@ -497,9 +612,14 @@ private:
     static const bool               DIRECTIONAL_ALIGN_ENABLED               = false;
     static const bool               DIRECTIONAL_INCH_ENABLED                = false;
     static const bool               ADXRS450_GYRO_PRESENT                   = false;
+    static const bool               SHOOTER_VELOCITY_CONTROL_ENABLED        = true;
+    static const unsigned           SHOOTER_AT_SPEED_LOOPS                  = 3U;
     
     static const unsigned           CAMERA_RUN_INTERVAL_MS                  = 1000U;
     static const unsigned           I2C_RUN_INTERVAL_MS                     = 240U;
+    static const unsigned           MOTOR_STATUS_INTERVAL_LOOPS             = 50U;
+    static const unsigned           GAME_DATA_CHECK_INTERVAL_LOOPS          = 25U;
+    static const unsigned           ROBOT_LOOP_PERIOD_MS                    = 20U;      // TimedRobot default period
 
     // These represent which motor value (+1/-1) represent
     // forward/reverse in the robot.  They are used to keep
@@ -580,28 +700,75 @@ private:
 
     inline constexpr double ConvertCelsiusToFahrenheit(double degreesC) { return ((degreesC * 9.0/5.0) + 32.0); }
     
+    // Talon velocities are in sensor ticks per 100ms
+    inline constexpr double ConvertRpmToTalonVelocity(double rpm) { return ((rpm * FALCON_TICKS_PER_REVOLUTION) / 600.0); }
+    inline constexpr double ConvertTalonVelocityToRpm(double velocity) { return ((velocity * 600.0) / FALCON_TICKS_PER_REVOLUTION); }
+    
+    // Spin the robot in place, positive speeds turn right (increasing gyro angle)
+    inline void TurnInPlace(double turnSpeed)
+    {
+        m_pLeftDriveMotors->Set(turnSpeed * LEFT_DRIVE_FORWARD_SCALAR);
+        m_pRightDriveMotors->Set(turnSpeed * RIGHT_DRIVE_REVERSE_SCALAR);
+    }
+    
+    // A ball can go into the shooter when it's off or up to speed
+    inline bool IsShooterReadyToFire() const { return ((m_ShooterTargetRpm == OFF) || m_bShooterAtSpeed); }
+    
     static constexpr double         TURRET_MOTOR_SCALING_VALUE              = -0.50;
+    // Positive turret output turns toward the left sensor (increasing angle), and the encoder counts up that way
+    static constexpr double         TURRET_CENTER_ANGLE_DEGREES             =  180.0;
+    static constexpr double         TURRET_FORWARD_ANGLE_DEGREES            =  180.0;   // Turret angle that shoots straight out the front of the robot
+    static constexpr double         TURRET_MIN_ANGLE_DEGREES                =   95.0;   // Just short of the right sensor
+    static constexpr double         TURRET_MAX_ANGLE_DEGREES                =  265.0;   // Just short of the left sensor
+    static constexpr double         TURRET_ENCODER_TICKS_PER_DEGREE         =  4096.0 * 10.0 / 360.0;   // Mag encoder on the motor, 10:1 to the turret
+    static constexpr double         TURRET_MAX_OUTPUT                       =  0.50;
+    static constexpr YtaTalon::PidConfig TURRET_POSITION_PID                =  {0.40, 0.0, 4.0, 0.0, 0};
     static constexpr double         INTAKE_MOTOR_SPEED                      =  1.00;
     static constexpr double         SHOOTER_SLOW_MOTOR_SPEED                =  0.75;
     static constexpr double         SHOOTER_FAST_MOTOR_SPEED                =  0.85;
+    static constexpr double         SHOOTER_SLOW_RPM                        =  4500.0;
+    static constexpr double         SHOOTER_FAST_RPM                        =  5200.0;
+    static constexpr double         SHOOTER_AT_SPEED_TOLERANCE_RPM          =  150.0;
+    static constexpr double         SHOOTER_VOLTAGE_COMPENSATION_VOLTS      =  11.0;
+    static constexpr double         FALCON_TICKS_PER_REVOLUTION             =  2048.0;
+    // Feed forward is full output (1023) over the free speed in ticks per 100ms
+    static constexpr YtaTalon::PidConfig SHOOTER_VELOCITY_PID               =  {0.10, 0.0, 0.0, 0.047, 0};
     static constexpr double         WINCH_MOTOR_SPEED                       =  1.00;
 
-    static constexpr double         JOYSTICK_TRIM_UPPER_LIMIT               =  0.10;
-    static constexpr double         JOYSTICK_TRIM_LOWER_LIMIT               = -0.10;
     static constexpr double         CONTROL_THROTTLE_VALUE_RANGE            =  0.65;
     static constexpr double         CONTROL_THROTTLE_VALUE_BASE             =  0.35;
     static constexpr double         DRIVE_THROTTLE_VALUE_RANGE              =  1.00;//0.65;
     static constexpr double         DRIVE_THROTTLE_VALUE_BASE               =  0.00;//0.35;
     static constexpr double         DRIVE_SLOW_THROTTLE_VALUE               =  0.35;
+    static constexpr double         DRIVE_SLEW_RATE_PER_LOOP                =  0.08;    // Zero to full in a quarter second
     static constexpr double         DRIVE_MOTOR_UPPER_LIMIT                 =  1.00;
     static constexpr double         DRIVE_MOTOR_LOWER_LIMIT                 = -1.00;
     static constexpr double         DRIVE_WHEEL_DIAMETER_INCHES             =  6.00;
+    static constexpr double         DRIVE_GEAR_RATIO                        =  10.71;   // Falcon turns per wheel turn (kit Toughbox Micro)
+    // The drive encoders are the Falcons' own, so they count motor turns before the gearbox
+    static constexpr double         ENCODER_TICKS_PER_INCH                  =  (FALCON_TICKS_PER_REVOLUTION * DRIVE_GEAR_RATIO) / (M_PI * DRIVE_WHEEL_DIAMETER_INCHES);
+    static constexpr double         DEGREES_TO_RADIANS                      =  M_PI / 180.0;
+    // Where the vision target is from the autonomous start pose (x out from the alliance wall, y to the left)
+    static constexpr double         VISION_TARGET_X_INCHES                  =  120.0;
+    static constexpr double         VISION_TARGET_Y_INCHES                  =  0.0;
     static constexpr double         INCHING_DRIVE_SPEED                     =  0.25;
     static constexpr double         INCHING_DRIVE_DELAY_S                   =  0.10;
     static constexpr double         DIRECTIONAL_ALIGN_DRIVE_SPEED           =  0.55;
     static constexpr double         DIRECTIONAL_ALIGN_MAX_TIME_S            =  3.00;
     
-    static constexpr double         SAFETY_TIMER_MAX_VALUE                  =  5.00;
+    // Drive input shaping.  The custom controllers carry their own,
+    // the rest get a plain deadband like the old trim logic.
+    static constexpr const YtaController::ShapingTables STANDARD_DRIVE_SHAPING_TABLES =
+    {
+        InputShapingTable({0.10, 0.00, 1.00}),
+        InputShapingTable({0.10, 0.00, 1.00})
+    };
+    static constexpr const YtaController::ShapingTables * const DRIVE_SHAPING_TABLES = (DRIVE_CONTROLLER_TYPE == CUSTOM_CONTROLLER) ? YtaController::GetShapingTables(DRIVE_CUSTOM_CONTROLLER_TYPE) : &STANDARD_DRIVE_SHAPING_TABLES;
+    static constexpr const InputShapingTable SLOW_DRIVE_SHAPING_TABLE       =  InputShapingTable({0.10, 0.00, DRIVE_SLOW_THROTTLE_VALUE});
+    // P, I, D, integral limit, output change per loop, tolerance (deg), settled rate (deg/loop), settle loops
+    static constexpr HeadingController::Gains HEADING_CONTROLLER_GAINS      =  {0.012, 0.0005, 0.05, 0.10, 0.05, 1.0, 0.5, 5U};
+    // b, zeta (b is the usual 2.0 per m^2, converted to inches)
+    static constexpr RamseteController::Gains RAMSETE_CONTROLLER_GAINS      =  {2.0 / (39.37 * 39.37), 0.7};
     
     // This may seem backward, but the LEDS work by creating
     // a voltage differential.  The LED strip has four lines,
@@ -629,7 +796,7 @@ private:
 inline void YtaRobot::HeartBeat()
 {
     m_HeartBeat++;
-    SmartDashboard::PutNumber("Heartbeat", m_HeartBeat);
+    RobotTelemetry::Set(RobotTelemetry::ROBOT_HEARTBEAT, m_HeartBeat);
 }
 
 
@@ -644,11 +811,11 @@ inline void YtaRobot::CheckForDriveSwap()
 {
     // Check if the driver pushed the button to have
     // forward be reverse and vice versa
-    if ( m_pDriveJoystick->GetRawButton(DRIVE_CONTROLS_FORWARD_BUTTON) )
+    if ( m_DriveInputs.GetButton(DRIVE_CONTROLS_FORWARD_BUTTON) )
     {
         m_bDriveSwap = false;
     }
-    else if ( m_pDriveJoystick->GetRawButton(DRIVE_CONTROLS_REVERSE_BUTTON) )
+    else if ( m_DriveInputs.GetButton(DRIVE_CONTROLS_REVERSE_BUTTON) )
     {
         m_bDriveSwap = true;
     }
@@ -706,7 +873,7 @@ inline double YtaRobot::GetThrottleControl(YtaController * pController)
 /// This method is used to get a value from an analog gyro
 /// sensor.  There are three possible places a gyro could be
 /// connected: analog sensor, the on board SPI port (ADXRS450),
-/// or externally (BNO055 on a RIOduino).  This method will
+/// or externally (BNO055 on I2C).  This method will
 /// obtain a value from the sensor corresponding to the passed
 /// in parameter.
 ///
@@ -736,21 +903,16 @@ inline double YtaRobot::GetGyroValue(GyroType gyroType, AnalogGyro * pSensor)
         case BNO055:
         {
             // Read the angle
-            GyroI2cData * pGyroData = RobotI2c::GetGyroData();
+            GyroI2cData gyroData;
             
             // Only update the value if valid data came across the wire
-            if (pGyroData != nullptr)
+            if (RobotI2c::GetGyroData(gyroData))
             {
-                m_Bno055Angle = pGyroData->m_xAxisInfo.m_Angle;
-                
-                // Reapply negative sign if needed
-                if (pGyroData->m_xAxisInfo.m_bIsNegative)
-                {
-                    m_Bno055Angle *= -1;
-                }
+                // Fixed point with the sign included
+                m_Bno055Angle = static_cast<double>(gyroData.m_xAngle) / GyroI2cData::ANGLE_UNITS_PER_DEGREE;
             }
             
-            value = static_cast<double>(m_Bno055Angle);
+            value = m_Bno055Angle;
             
             break;
         }
@@ -762,10 +924,7 @@ inline double YtaRobot::GetGyroValue(GyroType gyroType, AnalogGyro * pSensor)
         }
     }
     
-    if (RobotUtils::DEBUG_PRINTS)
-    {
-        SmartDashboard::PutNumber("Gyro angle", value);
-    }
+    RobotTelemetry::Set(RobotTelemetry::GYRO_ANGLE, value);
     
     return value;
 }
@@ -795,6 +954,51 @@ inline double YtaRobot::GetSonarValue(Ultrasonic * pSensor)
 
 
 
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::GetLeftDriveInches
+///
+/// Returns how far the left side of the drive has gone since
+/// the encoders were tared.  The left encoder counts down when
+/// driving forward.
+///
+////////////////////////////////////////////////////////////////
+inline double YtaRobot::GetLeftDriveInches()
+{
+    return -(m_pLeftDriveMotors->GetEncoderValue()) / ENCODER_TICKS_PER_INCH;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::GetRightDriveInches
+///
+/// Returns how far the right side of the drive has gone since
+/// the encoders were tared.
+///
+////////////////////////////////////////////////////////////////
+inline double YtaRobot::GetRightDriveInches()
+{
+    return m_pRightDriveMotors->GetEncoderValue() / ENCODER_TICKS_PER_INCH;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method YtaRobot::TareDriveEncoders
+///
+/// Zeroes both drive encoders and tells odometry, so the jump
+/// back to zero isn't taken as the robot driving backwards.
+///
+////////////////////////////////////////////////////////////////
+inline void YtaRobot::TareDriveEncoders()
+{
+    m_pLeftDriveMotors->TareEncoder();
+    m_pRightDriveMotors->TareEncoder();
+    m_Odometry.ResetEncoders(0.0, 0.0);
+}
+
+
+
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::CheckAndUpdateRobotMode
 ///
@@ -844,51 +1048,17 @@ void YtaRobot::CheckAndUpdateRobotMode(RobotMode robotMode)
 /// solenoid).  If the state is reversed inside an 'if'
 /// statement that is part of a loop, the final state will be
 /// whatever transition just occurred, which could be back to
-/// the same state started in.  The intended use case is to
-/// have TriggerChangeValues variables in the code and update
-/// their 'current' value each time through the loop by reading
-/// the joystick input.  This input will then be checked against
-/// the old input and return 'true' if it detects an appropriate
-/// edge change.  This method is intended to be called inside
-/// 'if' statements for logic control.
+/// the same state started in.  The edges are worked out when
+/// the controller snapshot is updated at the top of the loop,
+/// so this is only a lookup and gives the same answer no
+/// matter how many times it is called in a loop.  This method
+/// is intended to be called inside 'if' statements for logic
+/// control.
 ///
 ////////////////////////////////////////////////////////////////
 inline bool YtaRobot::TriggerChangeValues::DetectChange(TriggerEdge edge)
 {
-    bool bTriggerChanged = false;
-    
-    // The trigger change objects are initially set to nullptr and then created
-    // after the robot joysticks are set.  While the window between the two is
-    // incredibly small (member initialization list -> constructor body), apparently
-    // it is still possible for something to try and use the objects in this window.
-    // Make sure assignment to a valid joystick has occurred.
-    if (m_pJoystick != nullptr)
-    {    
-        // First read the latest value from the joystick
-        this->m_bCurrentValue = m_pJoystick->GetRawButton(m_ButtonNumber);
-        
-        // Only report a change if the current value is different than the old value
-        if ( (this->m_bCurrentValue != this->m_bOldValue) )
-        {
-            // Also make sure the transition is to the correct edge
-            if ((edge == RISING_EDGE_TRIGGER) && this->m_bCurrentValue)
-            {
-                bTriggerChanged = true;
-            }
-            else if ((edge == FALLING_EDGE_TRIGGER) && !this->m_bCurrentValue)
-            {
-                bTriggerChanged = true;
-            }
-            else
-            {
-            }
-        }
-        
-        // Always update the old value
-        this->m_bOldValue = this->m_bCurrentValue;
-    }
-    
-    return bTriggerChanged;
+    return (edge == RISING_EDGE_TRIGGER) ? m_pInputs->IsPressed(m_ButtonNumber) : m_pInputs->IsReleased(m_ButtonNumber);
 }
 
 #endif // YTAROBOT_HPP
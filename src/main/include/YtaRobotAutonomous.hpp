@@ -71,14 +71,23 @@ namespace YtaRobotAutonomous
     
     // Autonomous delay constants
     static constexpr double COUNTERACT_COAST_TIME_S             =  0.25;
-    static constexpr double ENCODER_DRIVE_MAX_DELAY_S           =  5.00;
+    static constexpr double CAMERA_ALIGN_MAX_DELAY_S            =  5.00;
+    static constexpr double TRAJECTORY_MAX_DELAY_S              =  8.00;
+    static constexpr double NO_STEP_TIMEOUT_S                   = 15.00;
     static constexpr double DELAY_SHORT_S                       =  0.50;
     static constexpr double DELAY_MEDIUM_S                      =  1.00;
     static constexpr double DELAY_LONG_S                        =  2.00;
     
     // Autonomous encoder drive constants
     static const int        ENCODER_DRIVE_STRAIGHT_IN           =  12*8;                    
-    static constexpr double ENCODER_COMPENSATE_SPEED            =  0.02;
+    static constexpr double ENCODER_DRIVE_PERIOD_S              =  0.02;
+    static constexpr double ENCODER_DRIVE_MAX_VELOCITY_IPS      = 120.0;                    // Cruise velocity at a step speed of 1.0
+    static constexpr double ENCODER_DRIVE_MAX_ACCELERATION_IPS2 =  80.0;
+    static constexpr double ENCODER_DRIVE_KV                    =  1.0 / 160.0;             // Output per in/s, one over the free speed
+    static constexpr double ENCODER_DRIVE_KA                    =  0.002;                   // Output per in/s^2
+    static constexpr double ENCODER_DRIVE_KP                    =  0.05;                    // Output per inch behind the setpoint
+    static constexpr double ENCODER_DRIVE_HEADING_KP            =  0.02;                    // Output per inch of left/right difference
+    static constexpr double ENCODER_DRIVE_TOLERANCE_IN          =  1.0;
     
     // Autonomous sonar drive constants
     static const uint32_t   SONAR_DRIVE_STATE_SIDE_MASK         = 0x0F;
@@ -89,12 +98,19 @@ namespace YtaRobotAutonomous
     static const int        SONAR_INIT_TURN_DIST_INCHES         =     5;
     static const int        SONAR_MAX_ALLOWED_READING_DIFF      =     2;
     static const unsigned   SONAR_BUMPER_CLEARANCE_DIST_INCHES  =     4;
+    static const uint64_t   SONAR_MAX_SAMPLE_AGE_US             = 250000U;
     static constexpr double SONAR_ROUTINE_TIME_S                =  5.00;
     static constexpr double SONAR_DRIVE_LEFT_SPEED              = -0.10;
     static constexpr double SONAR_DRIVE_RIGHT_SPEED             =  0.10;
     static constexpr double SONAR_COMPENSATE_LEFT_SPEED         = -0.05;
     static constexpr double SONAR_COMPENSATE_RIGHT_SPEED        =  0.05;
     
+    // Autonomous trajectory constants
+    // Order matches YtaRobot::TrajectoryId
+    static const char * const TRAJECTORY_DIRECTORY              = "/home/lvuser/deploy/trajectories/";
+    static const char * const TRAJECTORY_FILE_NAMES[]           = {"CommonRed.traj", "CommonBlue.traj"};
+    static constexpr double DRIVE_TRACK_WIDTH_INCHES            =  24.0;
+    
     // Autonomous misc constants
     static const unsigned   I2C_THREAD_UPDATE_RATE_MS           = 20U;
     
@@ -102,31 +118,15 @@ namespace YtaRobotAutonomous
 
 
 
-////////////////////////////////////////////////////////////////
-/// @method YtaRobot::AutonomousDelay
-///
-/// Waits for a specified amount of time in autonomous.  Used
-/// while an operation is ongoing but not yet complete, and
-/// nothing else needs to occur.
-///
-////////////////////////////////////////////////////////////////
-inline void YtaRobot::AutonomousDelay(double time)
-{
-    m_pAutonomousTimer->Start();
-    while (m_pAutonomousTimer->Get() < time) {}
-    m_pAutonomousTimer->Stop();
-    m_pAutonomousTimer->Reset();
-}
-
-
-
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::AutonomousDriveSequence
 ///
-/// Drives during autonomous for a specified amount of time.
+/// Drives during autonomous in the specified direction.  The
+/// autonomous step engine is responsible for timing the drive
+/// and turning the motors back off.
 ///
 ////////////////////////////////////////////////////////////////
-inline void YtaRobot::AutonomousDriveSequence(RobotDirection direction, double speed, double time)
+inline void YtaRobot::AutonomousDriveSequence(RobotDirection direction, double speed)
 {
     double leftSpeed = 0.0;
     double rightSpeed = 0.0;
@@ -166,16 +166,9 @@ inline void YtaRobot::AutonomousDriveSequence(RobotDirection direction, double s
         }
     }
 
-    // First turn the motors on
+    // Turn the motors on
     m_pLeftDriveMotors->Set(leftSpeed);
     m_pRightDriveMotors->Set(rightSpeed);
-
-    // Time it
-    AutonomousDelay(time);
-
-    // Motors back off
-    m_pLeftDriveMotors->Set(OFF);
-    m_pRightDriveMotors->Set(OFF);
 }
 
 
@@ -183,7 +176,8 @@ inline void YtaRobot::AutonomousDriveSequence(RobotDirection direction, double s
 ////////////////////////////////////////////////////////////////
 /// @method YtaRobot::AutonomousBackDrive
 ///
-/// Back drives the motors to abruptly stop the robot.
+/// Back drives the motors to abruptly stop the robot.  This is
+/// run as a step for COUNTERACT_COAST_TIME_S.
 ///
 ////////////////////////////////////////////////////////////////
 inline void YtaRobot::AutonomousBackDrive(RobotDirection currentDirection)
@@ -215,18 +209,9 @@ inline void YtaRobot::AutonomousBackDrive(RobotDirection currentDirection)
         }
     }
     
-    // Counteract coast
+    // Counteract coast (the step engine turns the motors off)
     m_pLeftDriveMotors->Set(leftSpeed);
     m_pRightDriveMotors->Set(rightSpeed);
-    
-    // Delay
-    AutonomousDelay(YtaRobotAutonomous::COUNTERACT_COAST_TIME_S);
-    
-    // Motors off
-    m_pLeftDriveMotors->Set(OFF);
-    m_pRightDriveMotors->Set(OFF);
-    
-    m_pSafetyTimer->Reset();
 }
 
 
@@ -235,7 +220,7 @@ inline void YtaRobot::AutonomousBackDrive(RobotDirection currentDirection)
 /// @method YtaRobot::AutonomousBackDriveTurn
 ///
 /// Back drives the motors to abruptly stop the robot during
-/// a turn.
+/// a turn.  This is run as a step for COUNTERACT_COAST_TIME_S.
 ///
 ////////////////////////////////////////////////////////////////
 inline void YtaRobot::AutonomousBackDriveTurn(RobotDirection currentDirection)
@@ -267,18 +252,9 @@ inline void YtaRobot::AutonomousBackDriveTurn(RobotDirection currentDirection)
         }
     }
     
-    // Counteract coast
+    // Counteract coast (the step engine turns the motors off)
     m_pLeftDriveMotors->Set(leftSpeed);
     m_pRightDriveMotors->Set(rightSpeed);
-    
-    // Delay
-    AutonomousDelay(YtaRobotAutonomous::COUNTERACT_COAST_TIME_S);
-    
-    // Motors off
-    m_pLeftDriveMotors->Set(OFF);
-    m_pRightDriveMotors->Set(OFF);
-    
-    m_pSafetyTimer->Reset();
 }
 
 #endif // YTAROBOTAUTONOMOUS_HPP
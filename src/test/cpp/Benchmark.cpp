@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   Benchmark.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for timing robot code on the desktop.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <algorithm>                            // for std::sort
+#include <cstdio>                               // for std::printf, file functions
+#include <cstdlib>                              // for std::getenv
+#include <ctime>                                // for std::time, std::strftime
+#include <numeric>                              // for std::accumulate
+#include <string>                               // for std::to_string
+
+// C INCLUDES
+#include "gtest/gtest.h"                        // for recording test properties
+
+// C++ INCLUDES
+#include "Benchmark.hpp"                        // for class declaration
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Benchmark::Summarize
+///
+/// Works out the statistics for a set of samples.
+///
+////////////////////////////////////////////////////////////////
+Benchmark::Result Benchmark::Summarize(const char * pName, unsigned callsPerSample, std::vector<double> & rSampleNs)
+{
+    Result result = {pName, static_cast<unsigned>(rSampleNs.size()), callsPerSample, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (rSampleNs.empty())
+    {
+        return result;
+    }
+
+    std::sort(rSampleNs.begin(), rSampleNs.end());
+
+    const size_t numSamples = rSampleNs.size();
+    result.m_MinNs = rSampleNs.front();
+    result.m_MedianNs = rSampleNs[numSamples / 2U];
+    result.m_MeanNs = std::accumulate(rSampleNs.begin(), rSampleNs.end(), 0.0) / numSamples;
+    result.m_P99Ns = rSampleNs[((numSamples - 1U) * 99U) / 100U];
+    result.m_MaxNs = rSampleNs.back();
+    return result;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Benchmark::Report
+///
+/// Prints a result, records it with the running test and adds
+/// it to the results file.
+///
+////////////////////////////////////////////////////////////////
+void Benchmark::Report(const Result & rResult)
+{
+    std::printf("[ BENCHMARK] %-32s median %10.0f ns  mean %10.0f ns  p99 %10.0f ns  max %10.0f ns  (%u x %u)\n",
+                rResult.m_pName,
+                rResult.m_MedianNs,
+                rResult.m_MeanNs,
+                rResult.m_P99Ns,
+                rResult.m_MaxNs,
+                rResult.m_NumSamples,
+                rResult.m_CallsPerSample);
+
+    const std::string namePrefix = std::string(rResult.m_pName) + "_";
+    ::testing::Test::RecordProperty(namePrefix + "median_ns", std::to_string(rResult.m_MedianNs));
+    ::testing::Test::RecordProperty(namePrefix + "p99_ns", std::to_string(rResult.m_P99Ns));
+
+    AppendToResultsFile(rResult);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Benchmark::AppendToResultsFile
+///
+/// Adds a row to the results file.  The file is only ever
+/// added to, and gets a header when it's first created.
+///
+////////////////////////////////////////////////////////////////
+void Benchmark::AppendToResultsFile(const Result & rResult)
+{
+    const char * pFileName = std::getenv("YTA_BENCHMARK_RESULTS");
+    if ((pFileName == nullptr) || (*pFileName == '\0'))
+    {
+        return;
+    }
+
+    const char * pLabel = std::getenv("YTA_BENCHMARK_LABEL");
+    if ((pLabel == nullptr) || (*pLabel == '\0'))
+    {
+        pLabel = "local";
+    }
+
+    std::FILE * pFile = std::fopen(pFileName, "a");
+    if (pFile == nullptr)
+    {
+        std::printf("Couldn't open benchmark results file %s.\n", pFileName);
+        return;
+    }
+
+    // An empty file is a new one
+    (void)std::fseek(pFile, 0L, SEEK_END);
+    if (std::ftell(pFile) == 0L)
+    {
+        std::fprintf(pFile, "time,label,benchmark,samples,calls_per_sample,min_ns,median_ns,mean_ns,p99_ns,max_ns\n");
+    }
+
+    char timeString[32] = "";
+    const std::time_t currentTime = std::time(nullptr);
+    (void)std::strftime(timeString, sizeof(timeString), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&currentTime));
+
+    std::fprintf(pFile, "%s,%s,%s,%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                 timeString,
+                 pLabel,
+                 rResult.m_pName,
+                 rResult.m_NumSamples,
+                 rResult.m_CallsPerSample,
+                 rResult.m_MinNs,
+                 rResult.m_MedianNs,
+                 rResult.m_MeanNs,
+                 rResult.m_P99Ns,
+                 rResult.m_MaxNs);
+    std::fclose(pFile);
+}
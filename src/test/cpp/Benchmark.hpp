@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   Benchmark.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for timing robot code on the desktop.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+// SYSTEM INCLUDES
+#include <chrono>                               // for std::chrono
+#include <vector>                               // for std::vector
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+// (none)
+
+
+////////////////////////////////////////////////////////////////
+/// @class Benchmark
+///
+/// A small timing harness for the host side benchmarks.  The
+/// code under test runs a number of times per sample so calls
+/// shorter than the clock resolution still time well, and the
+/// spread of the samples is kept since the worst loops matter
+/// as much as the typical one.  A setup step runs before each
+/// sample without being timed, which is where inputs change.
+/// Results are printed, recorded as test properties (so they
+/// show up in the test report), and appended to a CSV file if
+/// YTA_BENCHMARK_RESULTS names one, so runs can be compared
+/// over time.  YTA_BENCHMARK_LABEL tags the rows, for example
+/// with the commit being measured.
+///
+////////////////////////////////////////////////////////////////
+class Benchmark
+{
+public:
+
+    // Summary of one benchmark, times are per call
+    struct Result
+    {
+        const char *    m_pName;
+        unsigned        m_NumSamples;
+        unsigned        m_CallsPerSample;
+        double          m_MinNs;
+        double          m_MedianNs;
+        double          m_MeanNs;
+        double          m_P99Ns;
+        double          m_MaxNs;
+    };
+
+    // Time a function, calling the setup function (with the sample number) before each sample
+    template <typename SetupFunction, typename BodyFunction>
+    static Result Run(const char * pName, unsigned numSamples, unsigned callsPerSample, SetupFunction setup, BodyFunction body);
+
+    // Time a function that doesn't need any setup
+    template <typename BodyFunction>
+    inline static Result Run(const char * pName, unsigned numSamples, unsigned callsPerSample, BodyFunction body)
+    {
+        return Run(pName, numSamples, callsPerSample, [](unsigned) {}, body);
+    }
+
+    // Print and record a result
+    static void Report(const Result & rResult);
+
+    // Work out the statistics for samples timed some other way, sorts the samples
+    static Result Summarize(const char * pName, unsigned callsPerSample, std::vector<double> & rSampleNs);
+
+private:
+
+    // Add a row to the results file, if there is one
+    static void AppendToResultsFile(const Result & rResult);
+
+    // Constructor
+    Benchmark();
+
+    // Destructor, copy constructor, assignment operator
+    ~Benchmark();
+
+    Benchmark(const Benchmark &) = delete;
+    Benchmark & operator=(const Benchmark &) = delete;
+
+    // Samples that run first and are thrown out, to get caches and allocations settled
+    static const unsigned       WARM_UP_SAMPLES             = 10U;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method Benchmark::Run
+///
+/// Runs the warm up samples, then times each sample.
+///
+////////////////////////////////////////////////////////////////
+template <typename SetupFunction, typename BodyFunction>
+Benchmark::Result Benchmark::Run(const char * pName, unsigned numSamples, unsigned callsPerSample, SetupFunction setup, BodyFunction body)
+{
+    for (unsigned sample = 0U; sample < WARM_UP_SAMPLES; sample++)
+    {
+        setup(sample);
+        body();
+    }
+
+    std::vector<double> sampleNs;
+    sampleNs.reserve(numSamples);
+    for (unsigned sample = 0U; sample < numSamples; sample++)
+    {
+        setup(sample);
+
+        const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        for (unsigned call = 0U; call < callsPerSample; call++)
+        {
+            body();
+        }
+        const std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+        sampleNs.push_back(std::chrono::duration<double, std::nano>(endTime - startTime).count() / callsPerSample);
+    }
+
+    return Summarize(pName, callsPerSample, sampleNs);
+}
+
+#endif // BENCHMARK_HPP
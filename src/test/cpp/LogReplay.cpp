@@ -0,0 +1,395 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   LogReplay.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for running the robot code on the desktop
+/// from a recorded match log.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                                // for std::fabs, std::lround
+#include <cstdio>                               // for std::printf, file functions
+#include <cstring>                              // for std::memcmp, std::memcpy
+#include <thread>                               // for std::this_thread
+
+// C INCLUDES
+#include "frc/RobotController.h"                // for GetFPGATime()
+#include "mockdata/MockHooks.h"                 // for controlling the simulated clock
+
+// C++ INCLUDES
+#include "LogReplay.hpp"                        // for class declaration
+#include "RobotI2c.hpp"                         // for injecting gyro samples
+#include "RobotTiming.hpp"                      // for the teleop loop time
+#include "SimulatedHardware.hpp"                // for injecting controller inputs
+
+// STATIC MEMBER DATA
+const char * const LogReplay::OUTPUT_NAMES[NUM_OUTPUTS] =
+{
+    "left_drive_output",
+    "right_drive_output"
+};
+constexpr std::chrono::milliseconds LogReplay::I2C_STOP_TIME;
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::ReadLog
+///
+/// Reads a log the same way the log decoder does, keeping only
+/// the loop records.
+///
+////////////////////////////////////////////////////////////////
+bool LogReplay::ReadLog(const char * pFileName, std::vector<Record> & rRecords)
+{
+    rRecords.clear();
+
+    std::FILE * pFile = std::fopen(pFileName, "rb");
+    if (pFile == nullptr)
+    {
+        std::printf("Couldn't open log %s.\n", pFileName);
+        return false;
+    }
+
+    RobotLogRecords::FileHeader fileHeader;
+    if ((std::fread(&fileHeader, sizeof(fileHeader), 1U, pFile) != 1U) ||
+        (std::memcmp(fileHeader.m_Magic, RobotLogRecords::LOG_MAGIC, sizeof(RobotLogRecords::LOG_MAGIC)) != 0) ||
+        (fileHeader.m_Version != RobotLogRecords::LOG_VERSION) ||
+        (fileHeader.m_RecordSize != RobotLogRecords::RECORD_SIZE_BYTES))
+    {
+        std::printf("%s isn't a version %u robot log.\n", pFileName, RobotLogRecords::LOG_VERSION);
+        std::fclose(pFile);
+        return false;
+    }
+
+    Record record;
+    while (std::fread(&record, sizeof(record), 1U, pFile) == 1U)
+    {
+        if (record.m_Header.m_Type == RobotLogRecords::RECORD_LOOP)
+        {
+            rRecords.push_back(record);
+        }
+    }
+
+    std::fclose(pFile);
+    return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::WriteLog
+///
+/// Writes records with the same file header the robot's logger
+/// uses, so the log decoder can read the file too.
+///
+////////////////////////////////////////////////////////////////
+bool LogReplay::WriteLog(const char * pFileName, const std::vector<Record> & rRecords)
+{
+    std::FILE * pFile = std::fopen(pFileName, "wb");
+    if (pFile == nullptr)
+    {
+        std::printf("Couldn't create log %s.\n", pFileName);
+        return false;
+    }
+
+    RobotLogRecords::FileHeader fileHeader;
+    std::memcpy(fileHeader.m_Magic, RobotLogRecords::LOG_MAGIC, sizeof(fileHeader.m_Magic));
+    fileHeader.m_Version = RobotLogRecords::LOG_VERSION;
+    fileHeader.m_RecordSize = RobotLogRecords::RECORD_SIZE_BYTES;
+
+    bool bWritten = (std::fwrite(&fileHeader, sizeof(fileHeader), 1U, pFile) == 1U);
+    if (bWritten && !rRecords.empty())
+    {
+        bWritten = (std::fwrite(rRecords.data(), sizeof(Record), rRecords.size(), pFile) == rRecords.size());
+    }
+
+    std::fclose(pFile);
+    return bWritten;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::Run
+///
+/// Replays every record in order.  The mode's init function
+/// runs before its first record, and again whenever the mode
+/// changes.  The I2C thread and the simulated clock are put
+/// back the way they were when it's done.
+///
+////////////////////////////////////////////////////////////////
+LogReplay::Result LogReplay::Run(YtaRobot & rRobot, const std::vector<Record> & rRecords, double tolerance, std::vector<Record> * pReplayedRecords)
+{
+    Result result = {};
+    result.m_NumTicks = static_cast<unsigned>(rRecords.size());
+    for (unsigned i = 0U; i < NUM_OUTPUTS; i++)
+    {
+        result.m_Outputs[i].m_pName = OUTPUT_NAMES[i];
+    }
+
+    if (pReplayedRecords != nullptr)
+    {
+        pReplayedRecords->clear();
+        pReplayedRecords->reserve(rRecords.size());
+    }
+
+    std::vector<double> tickNs;
+    std::vector<double> loopNs;
+    std::vector<double> recordedLoopNs;
+    tickNs.reserve(rRecords.size());
+
+    // The gyro samples come from here instead
+    RobotI2c::SetThreadEnabled(false);
+    std::this_thread::sleep_for(I2C_STOP_TIME);
+    HALSIM_PauseTiming();
+
+    uint8_t currentMode = YtaRobot::ROBOT_MODE_NOT_SET;
+    for (unsigned tick = 0U; tick < rRecords.size(); tick++)
+    {
+        const Record & rRecord = rRecords[tick];
+        const RobotLogRecords::LoopData & rRecordedData = rRecord.m_Loop;
+
+        if ((tick > 0U) && (rRecord.m_Header.m_TimestampUs > rRecords[tick - 1U].m_Header.m_TimestampUs))
+        {
+            HALSIM_StepTiming(rRecord.m_Header.m_TimestampUs - rRecords[tick - 1U].m_Header.m_TimestampUs);
+        }
+
+        if (!InjectInputs(rRecordedData))
+        {
+            result.m_NumInputTimeouts++;
+        }
+
+        if (rRecord.m_Header.m_RobotMode != currentMode)
+        {
+            currentMode = rRecord.m_Header.m_RobotMode;
+            StartMode(rRobot, currentMode);
+        }
+
+        // Like TimedRobot, the mode's periodic function then RobotPeriodic()
+        const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        RunPeriodic(rRobot, currentMode);
+        rRobot.RobotPeriodic();
+        const std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+        tickNs.push_back(std::chrono::duration<double, std::nano>(endTime - startTime).count());
+
+        Record replayedRecord = rRecord;
+        CaptureLoopData(rRobot, replayedRecord.m_Loop);
+        const RobotLogRecords::LoopData & rReplayedData = replayedRecord.m_Loop;
+
+        if (currentMode == YtaRobot::ROBOT_MODE_TELEOP)
+        {
+            loopNs.push_back(rReplayedData.m_LoopTimeUs * 1000.0);
+            recordedLoopNs.push_back(rRecordedData.m_LoopTimeUs * 1000.0);
+        }
+
+        CompareOutput(result.m_Outputs[LEFT_DRIVE_OUTPUT], tick, rRecordedData.m_LeftDriveOutput, rReplayedData.m_LeftDriveOutput, tolerance);
+        CompareOutput(result.m_Outputs[RIGHT_DRIVE_OUTPUT], tick, rRecordedData.m_RightDriveOutput, rReplayedData.m_RightDriveOutput, tolerance);
+
+        if (pReplayedRecords != nullptr)
+        {
+            pReplayedRecords->push_back(replayedRecord);
+        }
+    }
+
+    HALSIM_ResumeTiming();
+    RobotI2c::SetThreadEnabled(true);
+
+    result.m_TickTime = Benchmark::Summarize("ReplayTick", 1U, tickNs);
+    result.m_LoopTime = Benchmark::Summarize("ReplayTeleopLoop", 1U, loopNs);
+    result.m_RecordedLoopTime = Benchmark::Summarize("RecordedTeleopLoop", 1U, recordedLoopNs);
+    return result;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::Report
+///
+/// Prints how each output compared, then reports the timings
+/// like any other benchmark so they land in the results file.
+///
+////////////////////////////////////////////////////////////////
+void LogReplay::Report(const Result & rResult)
+{
+    std::printf("[    REPLAY] %u loops, %u with late controller inputs\n", rResult.m_NumTicks, rResult.m_NumInputTimeouts);
+
+    for (unsigned i = 0U; i < NUM_OUTPUTS; i++)
+    {
+        const OutputDiff & rDiff = rResult.m_Outputs[i];
+        if (rDiff.m_NumDiffs == 0U)
+        {
+            std::printf("[    REPLAY] %-32s matches\n", rDiff.m_pName);
+        }
+        else
+        {
+            std::printf("[    REPLAY] %-32s differs in %u loops, first at loop %u, by up to %.4f\n",
+                        rDiff.m_pName,
+                        rDiff.m_NumDiffs,
+                        rDiff.m_FirstDiffTick,
+                        rDiff.m_MaxDiff);
+        }
+    }
+
+    Benchmark::Report(rResult.m_TickTime);
+    if (rResult.m_LoopTime.m_NumSamples > 0U)
+    {
+        Benchmark::Report(rResult.m_LoopTime);
+        Benchmark::Report(rResult.m_RecordedLoopTime);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::InjectInputs
+///
+/// Sets both controllers and waits for the driver station to
+/// pick them up.  The gyro angle goes straight into the I2C
+/// gyro snapshot, in the units the BNO055 reports.
+///
+////////////////////////////////////////////////////////////////
+bool LogReplay::InjectInputs(const RobotLogRecords::LoopData & rLoopData)
+{
+    static_assert(RobotLogRecords::LOGGED_AXES == SimulatedHardware::NUM_CONTROLLER_AXES, "Logged axes don't match the simulated controllers.");
+
+    const RobotLogRecords::ControllerData * const CONTROLLER_DATA[] = {&rLoopData.m_DriveController, &rLoopData.m_ControlController};
+    const int CONTROLLER_PORTS[] = {YtaRobot::DRIVE_JOYSTICK_PORT, YtaRobot::CONTROL_JOYSTICK_PORT};
+
+    SimulatedHardware::ControllerState states[2];
+    for (unsigned i = 0U; i < 2U; i++)
+    {
+        for (unsigned axis = 0U; axis < SimulatedHardware::NUM_CONTROLLER_AXES; axis++)
+        {
+            states[i].m_Axes[axis] = CONTROLLER_DATA[i]->m_Axes[axis];
+        }
+        states[i].m_Buttons = CONTROLLER_DATA[i]->m_Buttons;
+        states[i].m_Pov = CONTROLLER_DATA[i]->m_Pov;
+        SimulatedHardware::SetController(CONTROLLER_PORTS[i], states[i]);
+    }
+
+    GyroI2cData gyroData = {};
+    gyroData.m_xAngle = static_cast<int16_t>(std::lround(rLoopData.m_GyroAngle * GyroI2cData::ANGLE_UNITS_PER_DEGREE));
+    RobotI2c::m_GyroSnapshot.Publish(gyroData, RobotController::GetFPGATime());
+
+    bool bInputsArrived = true;
+    for (unsigned i = 0U; i < 2U; i++)
+    {
+        bInputsArrived = SimulatedHardware::WaitForController(CONTROLLER_PORTS[i], states[i]) && bInputsArrived;
+    }
+    return bInputsArrived;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::StartMode
+///
+/// Calls the init function for a mode.
+///
+////////////////////////////////////////////////////////////////
+void LogReplay::StartMode(YtaRobot & rRobot, uint8_t robotMode)
+{
+    switch (robotMode)
+    {
+        case YtaRobot::ROBOT_MODE_AUTONOMOUS:
+        {
+            rRobot.AutonomousInit();
+            break;
+        }
+        case YtaRobot::ROBOT_MODE_TELEOP:
+        {
+            rRobot.TeleopInit();
+            break;
+        }
+        case YtaRobot::ROBOT_MODE_TEST:
+        {
+            rRobot.TestInit();
+            break;
+        }
+        default:
+        {
+            rRobot.DisabledInit();
+            break;
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::RunPeriodic
+///
+/// Calls the periodic function for a mode.
+///
+////////////////////////////////////////////////////////////////
+void LogReplay::RunPeriodic(YtaRobot & rRobot, uint8_t robotMode)
+{
+    switch (robotMode)
+    {
+        case YtaRobot::ROBOT_MODE_AUTONOMOUS:
+        {
+            rRobot.AutonomousPeriodic();
+            break;
+        }
+        case YtaRobot::ROBOT_MODE_TELEOP:
+        {
+            rRobot.TeleopPeriodic();
+            break;
+        }
+        case YtaRobot::ROBOT_MODE_TEST:
+        {
+            rRobot.TestPeriodic();
+            break;
+        }
+        default:
+        {
+            rRobot.DisabledPeriodic();
+            break;
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::CaptureLoopData
+///
+/// Fills in the loop data the way the robot logs it.
+///
+////////////////////////////////////////////////////////////////
+void LogReplay::CaptureLoopData(YtaRobot & rRobot, RobotLogRecords::LoopData & rLoopData)
+{
+    rRobot.FillLoopData(rLoopData);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method LogReplay::CompareOutput
+///
+/// Counts a loop as different if the output is off by more
+/// than the tolerance.
+///
+////////////////////////////////////////////////////////////////
+void LogReplay::CompareOutput(OutputDiff & rDiff, unsigned tick, float recorded, float replayed, double tolerance)
+{
+    const double difference = std::fabs(static_cast<double>(replayed) - static_cast<double>(recorded));
+    if (difference <= tolerance)
+    {
+        return;
+    }
+
+    if (rDiff.m_NumDiffs == 0U)
+    {
+        rDiff.m_FirstDiffTick = tick;
+    }
+    rDiff.m_NumDiffs++;
+
+    if (difference > rDiff.m_MaxDiff)
+    {
+        rDiff.m_MaxDiff = difference;
+    }
+}
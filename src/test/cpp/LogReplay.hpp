@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   LogReplay.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for running the robot code on the desktop from a
+/// recorded match log.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LOGREPLAY_HPP
+#define LOGREPLAY_HPP
+
+// SYSTEM INCLUDES
+#include <chrono>                               // for std::chrono
+#include <cstdint>                              // for sized integer types
+#include <vector>                               // for std::vector
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "Benchmark.hpp"                        // for timing results
+#include "RobotLogRecords.hpp"                  // for the log record layout
+#include "YtaRobot.hpp"                         // for the robot
+
+
+////////////////////////////////////////////////////////////////
+/// @class LogReplay
+///
+/// Feeds the loop records of a match log back through the
+/// robot code, one robot loop per record, as fast as the code
+/// runs.  Before each loop the recorded controller inputs go
+/// in as driver station joystick data and the recorded gyro
+/// angle goes in as a gyro sample from the I2C thread (which
+/// is stopped during a replay), so the code reads them the way
+/// it does on the robot.  The simulated FPGA clock is paused
+/// and stepped by the recorded time between loops, so timers
+/// and the autonomous steps see the match's time base.  After
+/// each loop the drive outputs are compared with the recorded
+/// ones and the loop is timed.  Both are what the code
+/// commanded, not what the Talons reported.  Encoders aren't
+/// simulated and read zero, and autonomous runs whichever
+/// routine the dashboard chooser defaults to.
+///
+////////////////////////////////////////////////////////////////
+class LogReplay
+{
+public:
+
+    typedef RobotLogRecords::Record Record;
+
+    // The teleop mode as the log records it
+    static const uint8_t TELEOP_MODE = YtaRobot::ROBOT_MODE_TELEOP;
+
+    // The outputs that are compared
+    enum Output
+    {
+        LEFT_DRIVE_OUTPUT,
+        RIGHT_DRIVE_OUTPUT,
+        NUM_OUTPUTS
+    };
+
+    // How one output compared over a replay
+    struct OutputDiff
+    {
+        const char *        m_pName;
+        unsigned            m_NumDiffs;             // Loops where it was off by more than the tolerance
+        unsigned            m_FirstDiffTick;        // Only meaningful if there were any
+        double              m_MaxDiff;
+    };
+
+    // Summary of one replay
+    struct Result
+    {
+        unsigned            m_NumTicks;
+        unsigned            m_NumInputTimeouts;     // Loops that may not have seen their controller inputs
+        OutputDiff          m_Outputs[NUM_OUTPUTS];
+        Benchmark::Result   m_TickTime;             // Each whole loop, periodic functions included
+        Benchmark::Result   m_LoopTime;             // The teleop loop as the robot times it
+        Benchmark::Result   m_RecordedLoopTime;     // The same, from the log
+    };
+
+    // Read the loop records from a log file, returns false if it isn't a log this code can read
+    static bool ReadLog(const char * pFileName, std::vector<Record> & rRecords);
+
+    // Write records out as a log file
+    static bool WriteLog(const char * pFileName, const std::vector<Record> & rRecords);
+
+    // Run the robot through the records, optionally keeping what this run would have logged
+    static Result Run(YtaRobot & rRobot, const std::vector<Record> & rRecords, double tolerance, std::vector<Record> * pReplayedRecords = nullptr);
+
+    // Print a result
+    static void Report(const Result & rResult);
+
+private:
+
+    // Put one record's controllers and gyro where the robot code reads them, returns false on a timeout
+    static bool InjectInputs(const RobotLogRecords::LoopData & rLoopData);
+
+    // Call the init function or the periodic function for a mode
+    static void StartMode(YtaRobot & rRobot, uint8_t robotMode);
+    static void RunPeriodic(YtaRobot & rRobot, uint8_t robotMode);
+
+    // What the robot would log for the loop that just ran
+    static void CaptureLoopData(YtaRobot & rRobot, RobotLogRecords::LoopData & rLoopData);
+
+    // Compare one output for one loop
+    static void CompareOutput(OutputDiff & rDiff, unsigned tick, float recorded, float replayed, double tolerance);
+
+    // Constructor
+    LogReplay();
+
+    // Destructor, copy constructor, assignment operator
+    ~LogReplay();
+
+    LogReplay(const LogReplay &) = delete;
+    LogReplay & operator=(const LogReplay &) = delete;
+
+    // MEMBER VARIABLES
+    static const char * const   OUTPUT_NAMES[NUM_OUTPUTS];
+
+    // Long enough for a BNO055 read that was in progress to finish
+    static constexpr std::chrono::milliseconds I2C_STOP_TIME = std::chrono::milliseconds(50);
+};
+
+#endif // LOGREPLAY_HPP
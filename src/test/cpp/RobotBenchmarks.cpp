@@ -0,0 +1,293 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotBenchmarks.cpp
+/// @author David Stalter
+///
+/// @details
+/// Benchmarks of the robot control code that run on the desktop.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                                // for std::sin
+#include <cstdlib>                              // for std::getenv
+#include <string>                               // for std::string
+#include <vector>                               // for std::vector
+
+// C INCLUDES
+#include "gtest/gtest.h"                        // for the test framework
+#include "opencv2/imgcodecs.hpp"                // for reading recorded frames
+
+// C++ INCLUDES
+#include "Benchmark.hpp"                        // for timing the code under test
+#include "RobotCamera.hpp"                      // for the vision pipeline
+#include "SimulatedHardware.hpp"                // for controller inputs and the robot
+#include "TalonMotorGroup.hpp"                  // for Talon group motor control
+#include "YtaRobot.hpp"                         // for the robot
+
+
+////////////////////////////////////////////////////////////////
+/// @class RobotBenchmarks
+///
+/// Friend of the robot and camera classes, so the benchmarks
+/// can reach the sequences and pipeline stages they time.
+///
+////////////////////////////////////////////////////////////////
+class RobotBenchmarks
+{
+public:
+
+    // The robot, put in teleop the first time it's asked for
+    static YtaRobot & GetRobot();
+
+    // Inputs that sweep every axis, a little different each sample
+    static void SweepControllers(unsigned sample);
+
+    inline static void UpdateControllerInputs(YtaRobot & rRobot)
+    {
+        rRobot.UpdateControllerInputs();
+    }
+
+    inline static void DriveControlSequence(YtaRobot & rRobot)
+    {
+        rRobot.DriveControlSequence();
+    }
+
+    // Recorded frames if there are any, otherwise made up ones
+    static void LoadFrames(std::vector<cv::Mat> & rFrames);
+
+    // Threshold a frame and find its contours, ready for filtering
+    static void PrepareContours(const cv::Mat & rFrame);
+
+    inline static void FilterContours()
+    {
+        RobotCamera::FilterContours(RobotCamera::FULL_SCALE);
+    }
+
+private:
+
+    // A frame with a few bright targets and some noise
+    static cv::Mat MakeSyntheticFrame(unsigned seed);
+
+    static const unsigned       NUM_SYNTHETIC_FRAMES        = 8U;
+    static const int            FRAME_WIDTH                 = 640;
+    static const int            FRAME_HEIGHT                = 480;
+};
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotBenchmarks::GetRobot
+///
+/// The robot is shared with the other tests, so the benchmarks
+/// only start teleop the first time they use it.
+///
+////////////////////////////////////////////////////////////////
+YtaRobot & RobotBenchmarks::GetRobot()
+{
+    static bool bTeleopStarted = false;
+    YtaRobot & rRobot = SimulatedHardware::GetRobot();
+    if (!bTeleopStarted)
+    {
+        rRobot.TeleopInit();
+        bTeleopStarted = true;
+    }
+    return rRobot;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotBenchmarks::SweepControllers
+///
+/// Moves every axis along a slow sine wave, with each axis out
+/// of phase, so the drive code sees changing inputs.
+///
+////////////////////////////////////////////////////////////////
+void RobotBenchmarks::SweepControllers(unsigned sample)
+{
+    SimulatedHardware::ControllerState state = {{}, 0U, -1};
+    for (unsigned i = 0U; i < SimulatedHardware::NUM_CONTROLLER_AXES; i++)
+    {
+        state.m_Axes[i] = static_cast<float>(std::sin((sample * 0.05) + i));
+    }
+
+    SimulatedHardware::SetController(0, state);
+    SimulatedHardware::SetController(1, state);
+    SimulatedHardware::SetGyroHeading(sample * 0.5);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotBenchmarks::LoadFrames
+///
+/// Reads the frames in the directory YTA_BENCHMARK_FRAMES names
+/// (images saved from the robot's cameras).  Without any, some
+/// frames are made up so the benchmark still runs.
+///
+////////////////////////////////////////////////////////////////
+void RobotBenchmarks::LoadFrames(std::vector<cv::Mat> & rFrames)
+{
+    rFrames.clear();
+
+    const char * pDirectory = std::getenv("YTA_BENCHMARK_FRAMES");
+    if ((pDirectory != nullptr) && (*pDirectory != '\0'))
+    {
+        std::vector<cv::String> fileNames;
+        cv::glob(std::string(pDirectory) + "/*.png", fileNames, false);
+        for (const cv::String & rFileName : fileNames)
+        {
+            cv::Mat frame = cv::imread(rFileName, cv::IMREAD_COLOR);
+            if (!frame.empty())
+            {
+                rFrames.push_back(frame);
+            }
+        }
+    }
+
+    if (rFrames.empty())
+    {
+        for (unsigned i = 0U; i < NUM_SYNTHETIC_FRAMES; i++)
+        {
+            rFrames.push_back(MakeSyntheticFrame(i));
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotBenchmarks::MakeSyntheticFrame
+///
+/// Draws solid bright shapes that pass the contour filter and
+/// small specks that don't, on a dark background.
+///
+////////////////////////////////////////////////////////////////
+cv::Mat RobotBenchmarks::MakeSyntheticFrame(unsigned seed)
+{
+    static const int NUM_TARGETS = 3;
+    static const int NUM_SPECKS = 40;
+
+    cv::RNG randomGenerator(seed + 1U);
+    cv::Mat frame = cv::Mat::zeros(cv::Size(FRAME_WIDTH, FRAME_HEIGHT), CV_8UC3);
+
+    for (int i = 0; i < NUM_TARGETS; i++)
+    {
+        const int width = randomGenerator.uniform(40, 120);
+        const int height = randomGenerator.uniform(20, 60);
+        const int x = randomGenerator.uniform(0, FRAME_WIDTH - width);
+        const int y = randomGenerator.uniform(0, FRAME_HEIGHT - height);
+        cv::rectangle(frame, cv::Rect(x, y, width, height), cv::Scalar(255, 255, 255), cv::FILLED);
+    }
+
+    for (int i = 0; i < NUM_SPECKS; i++)
+    {
+        const cv::Point center(randomGenerator.uniform(0, FRAME_WIDTH), randomGenerator.uniform(0, FRAME_HEIGHT));
+        cv::circle(frame, center, randomGenerator.uniform(1, 4), cv::Scalar(240, 240, 240), cv::FILLED);
+    }
+
+    return frame;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method RobotBenchmarks::PrepareContours
+///
+/// Runs the frame through the threshold stage and the contour
+/// search, like the pipeline does before filtering.
+///
+////////////////////////////////////////////////////////////////
+void RobotBenchmarks::PrepareContours(const cv::Mat & rFrame)
+{
+    RobotCamera::FrameInfo frameInfo = {};
+    RobotCamera::ThresholdImage(rFrame, frameInfo);
+    RobotCamera::FindContours(RobotCamera::m_ErodeOutputMat, frameInfo.m_SearchRegion);
+}
+
+
+
+// Motor group writes, alternating so the write cache has something to send
+TEST(Benchmark, TalonMotorGroupSet)
+{
+    static TalonMotorGroup<TalonFX> * pMotors = new TalonMotorGroup<TalonFX>(2, 20, YtaTalon::FOLLOW);
+
+    double value = 0.5;
+    Benchmark::Report(Benchmark::Run("TalonMotorGroupSet", 1000U, 100U, [&value]()
+    {
+        value = -value;
+        pMotors->Set(value);
+    }));
+}
+
+
+
+// Motor group writes of the same value, which the write cache skips
+TEST(Benchmark, TalonMotorGroupSetRepeated)
+{
+    static TalonMotorGroup<TalonFX> * pMotors = new TalonMotorGroup<TalonFX>(2, 22, YtaTalon::FOLLOW);
+
+    Benchmark::Report(Benchmark::Run("TalonMotorGroupSetRepeated", 1000U, 100U, []()
+    {
+        pMotors->Set(0.5);
+    }));
+}
+
+
+
+// The drive sequence on its own, with the inputs changing between samples
+TEST(Benchmark, DriveControlSequence)
+{
+    YtaRobot & rRobot = RobotBenchmarks::GetRobot();
+
+    Benchmark::Report(Benchmark::Run("DriveControlSequence", 1000U, 10U,
+        [&rRobot](unsigned sample)
+        {
+            RobotBenchmarks::SweepControllers(sample);
+            RobotBenchmarks::UpdateControllerInputs(rRobot);
+        },
+        [&rRobot]()
+        {
+            RobotBenchmarks::DriveControlSequence(rRobot);
+        }));
+}
+
+
+
+// Contour filtering, cycling through the frames
+TEST(Benchmark, FilterContours)
+{
+    std::vector<cv::Mat> frames;
+    RobotBenchmarks::LoadFrames(frames);
+    ASSERT_FALSE(frames.empty());
+
+    Benchmark::Report(Benchmark::Run("FilterContours", 400U, 10U,
+        [&frames](unsigned sample)
+        {
+            RobotBenchmarks::PrepareContours(frames[sample % frames.size()]);
+        },
+        []()
+        {
+            RobotBenchmarks::FilterContours();
+        }));
+}
+
+
+
+// One whole teleop loop, the way TimedRobot runs it
+TEST(Benchmark, TeleopTick)
+{
+    YtaRobot & rRobot = RobotBenchmarks::GetRobot();
+
+    Benchmark::Report(Benchmark::Run("TeleopTick", 500U, 1U,
+        [](unsigned sample)
+        {
+            RobotBenchmarks::SweepControllers(sample);
+        },
+        [&rRobot]()
+        {
+            rRobot.TeleopPeriodic();
+            rRobot.RobotPeriodic();
+        }));
+}
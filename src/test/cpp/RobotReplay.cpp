@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   RobotReplay.cpp
+/// @author David Stalter
+///
+/// @details
+/// Replays of match logs through the robot code that run on the desktop.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                                // for std::sin, std::fmod
+#include <cstdio>                               // for std::printf
+#include <cstdlib>                              // for std::getenv, std::strtod
+#include <vector>                               // for std::vector
+
+// C INCLUDES
+#include "gtest/gtest.h"                        // for the test framework
+
+// C++ INCLUDES
+#include "LogReplay.hpp"                        // for replaying logs
+#include "SimulatedHardware.hpp"                // for the robot
+
+// Loops in the made up run, 20 seconds of teleop
+static const unsigned   SWEPT_INPUT_LOOPS       = 1000U;
+static const uint64_t   LOOP_PERIOD_US          = 20000U;
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method MakeSweptInputs
+///
+/// Builds teleop records with every axis on both controllers
+/// moving along a slow sine wave and the robot turning.  Only
+/// the inputs are filled in.
+///
+////////////////////////////////////////////////////////////////
+static void MakeSweptInputs(std::vector<LogReplay::Record> & rRecords)
+{
+    rRecords.clear();
+    rRecords.reserve(SWEPT_INPUT_LOOPS);
+
+    for (unsigned loop = 0U; loop < SWEPT_INPUT_LOOPS; loop++)
+    {
+        LogReplay::Record record = {};
+        record.m_Header.m_TimestampUs = loop * LOOP_PERIOD_US;
+        record.m_Header.m_Sequence = loop;
+        record.m_Header.m_Type = RobotLogRecords::RECORD_LOOP;
+        record.m_Header.m_RobotMode = LogReplay::TELEOP_MODE;
+
+        RobotLogRecords::ControllerData * const CONTROLLERS[] = {&record.m_Loop.m_DriveController, &record.m_Loop.m_ControlController};
+        for (RobotLogRecords::ControllerData * pController : CONTROLLERS)
+        {
+            pController->m_Pov = -1;
+            for (unsigned axis = 0U; axis < RobotLogRecords::LOGGED_AXES; axis++)
+            {
+                pController->m_Axes[axis] = static_cast<float>(std::sin((loop * 0.05) + axis));
+            }
+        }
+
+        record.m_Loop.m_GyroAngle = static_cast<float>(std::fmod(loop * 0.5, 360.0));
+        rRecords.push_back(record);
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method GetTolerance
+///
+/// How far an output can be from the recorded one and still
+/// match, from YTA_REPLAY_TOLERANCE (exact if it isn't set).
+///
+////////////////////////////////////////////////////////////////
+static double GetTolerance()
+{
+    const char * pTolerance = std::getenv("YTA_REPLAY_TOLERANCE");
+    return ((pTolerance != nullptr) && (*pTolerance != '\0')) ? std::strtod(pTolerance, nullptr) : 0.0;
+}
+
+
+
+// A made up run recorded on the desktop, then replayed against itself
+TEST(Replay, SweptInputs)
+{
+    YtaRobot & rRobot = SimulatedHardware::GetRobot();
+
+    std::vector<LogReplay::Record> inputs;
+    MakeSweptInputs(inputs);
+
+    std::vector<LogReplay::Record> recorded;
+    static_cast<void>(LogReplay::Run(rRobot, inputs, 0.0, &recorded));
+
+    // Replaying the same inputs has to give the same outputs
+    const LogReplay::Result result = LogReplay::Run(rRobot, recorded, 0.0);
+    LogReplay::Report(result);
+
+    EXPECT_EQ(result.m_NumInputTimeouts, 0U);
+    for (const LogReplay::OutputDiff & rDiff : result.m_Outputs)
+    {
+        EXPECT_EQ(rDiff.m_NumDiffs, 0U) << rDiff.m_pName;
+    }
+
+    // Saving the run gives later changes something to be compared against
+    const char * pFileName = std::getenv("YTA_REPLAY_RECORD");
+    if ((pFileName != nullptr) && (*pFileName != '\0'))
+    {
+        EXPECT_TRUE(LogReplay::WriteLog(pFileName, recorded));
+    }
+}
+
+
+
+// A log from the robot, or one saved by the test above, replayed against the current code
+TEST(Replay, RecordedLog)
+{
+    const char * pFileName = std::getenv("YTA_REPLAY_LOG");
+    if ((pFileName == nullptr) || (*pFileName == '\0'))
+    {
+        std::printf("YTA_REPLAY_LOG isn't set, there is no log to replay.\n");
+        return;
+    }
+
+    std::vector<LogReplay::Record> recorded;
+    ASSERT_TRUE(LogReplay::ReadLog(pFileName, recorded));
+    ASSERT_FALSE(recorded.empty());
+
+    const LogReplay::Result result = LogReplay::Run(SimulatedHardware::GetRobot(), recorded, GetTolerance());
+    LogReplay::Report(result);
+
+    EXPECT_EQ(result.m_NumInputTimeouts, 0U);
+    for (const LogReplay::OutputDiff & rDiff : result.m_Outputs)
+    {
+        EXPECT_EQ(rDiff.m_NumDiffs, 0U) << rDiff.m_pName;
+    }
+}
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   SimulatedHardware.cpp
+/// @author David Stalter
+///
+/// @details
+/// Contains function definitions for the hardware fakes used by the host side
+/// tests and benchmarks.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <cmath>                                // for std::fmod, std::lround
+#include <cstring>                              // for std::memset
+#include <thread>                               // for std::this_thread
+
+// C INCLUDES
+#include "frc/DriverStation.h"                  // for reading back joystick data
+#include "hal/DriverStationTypes.h"             // for joystick data structures
+#include "mockdata/DriverStationData.h"         // for setting simulated joystick data
+#include "mockdata/I2CData.h"                   // for simulated I2C callbacks
+
+// C++ INCLUDES
+#include "SimulatedHardware.hpp"                // for class declaration
+
+// STATIC MEMBER DATA
+uint8_t                 SimulatedHardware::m_Bno055Registers[BNO055_NUM_REGISTERS];
+std::mutex              SimulatedHardware::m_Bno055Mutex;
+bool                    SimulatedHardware::m_bInitialized = false;
+thread_local uint8_t    SimulatedHardware::m_RegisterAddress = 0U;
+constexpr std::chrono::milliseconds SimulatedHardware::CONTROLLER_TIMEOUT;
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SimulatedHardware::Initialize
+///
+/// Registers the I2C callbacks and gives every controller a
+/// centered, nothing pressed state.
+///
+////////////////////////////////////////////////////////////////
+void SimulatedHardware::Initialize()
+{
+    if (m_bInitialized)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Bno055Mutex);
+        std::memset(&m_Bno055Registers[0], 0U, sizeof(m_Bno055Registers));
+        m_Bno055Registers[BNO055_CHIP_ID_REGISTER] = BNO055_CHIP_ID_VALUE;
+    }
+
+    HALSIM_RegisterI2CWriteCallback(MXP_I2C_PORT, I2cWriteCallback, nullptr);
+    HALSIM_RegisterI2CReadCallback(MXP_I2C_PORT, I2cReadCallback, nullptr);
+
+    const ControllerState idleState = {{0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F}, 0U, -1};
+    SetController(0, idleState);
+    SetController(1, idleState);
+
+    m_bInitialized = true;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SimulatedHardware::SetController
+///
+/// Sets the joystick data for one port.  Like on the robot, the
+/// robot code sees it once the driver station thread has read
+/// the new data.
+///
+////////////////////////////////////////////////////////////////
+void SimulatedHardware::SetController(int port, const ControllerState & rState)
+{
+    HAL_JoystickAxes axes;
+    std::memset(&axes, 0U, sizeof(axes));
+    axes.count = static_cast<int16_t>(NUM_CONTROLLER_AXES);
+    for (unsigned i = 0U; i < NUM_CONTROLLER_AXES; i++)
+    {
+        axes.axes[i] = rState.m_Axes[i];
+    }
+
+    HAL_JoystickButtons buttons;
+    std::memset(&buttons, 0U, sizeof(buttons));
+    buttons.count = static_cast<uint8_t>(NUM_CONTROLLER_BUTTONS);
+    buttons.buttons = rState.m_Buttons;
+
+    HAL_JoystickPOVs povs;
+    std::memset(&povs, 0U, sizeof(povs));
+    povs.count = 1;
+    povs.povs[0] = static_cast<int16_t>(rState.m_Pov);
+
+    HALSIM_SetJoystickAxes(port, &axes);
+    HALSIM_SetJoystickButtons(port, &buttons);
+    HALSIM_SetJoystickPOVs(port, &povs);
+    HALSIM_NotifyDriverStationNewData();
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SimulatedHardware::WaitForController
+///
+/// The driver station thread copies new joystick data some time
+/// after it's set.  Code that needs every loop to see exactly
+/// the inputs it set waits here until the copy has happened.
+///
+////////////////////////////////////////////////////////////////
+bool SimulatedHardware::WaitForController(int port, const ControllerState & rState)
+{
+    DriverStation & rDriverStation = DriverStation::GetInstance();
+    const std::chrono::steady_clock::time_point timeoutTime = std::chrono::steady_clock::now() + CONTROLLER_TIMEOUT;
+
+    while (std::chrono::steady_clock::now() < timeoutTime)
+    {
+        bool bMatches = ((static_cast<uint32_t>(rDriverStation.GetStickButtons(port)) & CONTROLLER_BUTTONS_MASK) == (rState.m_Buttons & CONTROLLER_BUTTONS_MASK));
+        bMatches = bMatches && (rDriverStation.GetStickPOV(port, 0) == rState.m_Pov);
+        for (unsigned i = 0U; bMatches && (i < NUM_CONTROLLER_AXES); i++)
+        {
+            bMatches = (rDriverStation.GetStickAxis(port, static_cast<int>(i)) == static_cast<double>(rState.m_Axes[i]));
+        }
+
+        if (bMatches)
+        {
+            return true;
+        }
+
+        std::this_thread::yield();
+    }
+
+    return false;
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SimulatedHardware::SetGyroHeading
+///
+/// Writes a heading into the BNO055 euler registers.  The
+/// sensor reports zero to 360 degrees in sixteenths.
+///
+////////////////////////////////////////////////////////////////
+void SimulatedHardware::SetGyroHeading(double headingDegrees)
+{
+    double heading = std::fmod(headingDegrees, 360.0);
+    if (heading < 0.0)
+    {
+        heading += 360.0;
+    }
+
+    const uint16_t rawHeading = static_cast<uint16_t>(std::lround(heading * BNO055_UNITS_PER_DEGREE));
+
+    std::lock_guard<std::mutex> lock(m_Bno055Mutex);
+    m_Bno055Registers[BNO055_EULER_HEADING_LSB] = static_cast<uint8_t>(rawHeading & 0xFFU);
+    m_Bno055Registers[BNO055_EULER_HEADING_LSB + 1U] = static_cast<uint8_t>(rawHeading >> 8);
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SimulatedHardware::I2cWriteCallback
+///
+/// The first byte of a write is the register.  Anything after
+/// it is data for that register and the ones following it.
+///
+////////////////////////////////////////////////////////////////
+void SimulatedHardware::I2cWriteCallback(const char *, void *, const unsigned char * pBuffer, unsigned int count)
+{
+    if (count == 0U)
+    {
+        return;
+    }
+
+    m_RegisterAddress = pBuffer[0];
+
+    std::lock_guard<std::mutex> lock(m_Bno055Mutex);
+    for (unsigned i = 1U; i < count; i++)
+    {
+        const unsigned reg = m_RegisterAddress + i - 1U;
+        if (reg < BNO055_NUM_REGISTERS)
+        {
+            m_Bno055Registers[reg] = pBuffer[i];
+        }
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SimulatedHardware::I2cReadCallback
+///
+/// Fills a read from the register this thread last wrote.
+/// Registers past the end read as zero.
+///
+////////////////////////////////////////////////////////////////
+void SimulatedHardware::I2cReadCallback(const char *, void *, unsigned char * pBuffer, unsigned int count)
+{
+    std::lock_guard<std::mutex> lock(m_Bno055Mutex);
+    for (unsigned i = 0U; i < count; i++)
+    {
+        const unsigned reg = m_RegisterAddress + i;
+        pBuffer[i] = (reg < BNO055_NUM_REGISTERS) ? m_Bno055Registers[reg] : 0U;
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////
+/// @method SimulatedHardware::GetRobot
+///
+/// Builds the robot and runs RobotInit() on the first call.
+/// Callers choose the mode they want themselves.
+///
+////////////////////////////////////////////////////////////////
+YtaRobot & SimulatedHardware::GetRobot()
+{
+    static YtaRobot * pRobot = nullptr;
+    if (pRobot == nullptr)
+    {
+        pRobot = new YtaRobot();
+        pRobot->RobotInit();
+    }
+    return *pRobot;
+}
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file   SimulatedHardware.hpp
+/// @author David Stalter
+///
+/// @details
+/// Contains declarations for the hardware fakes used by the host side tests and
+/// benchmarks.
+///
+/// Copyright (c) 2020 Youth Technology Academy
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SIMULATEDHARDWARE_HPP
+#define SIMULATEDHARDWARE_HPP
+
+// SYSTEM INCLUDES
+#include <chrono>                               // for std::chrono
+#include <cstdint>                              // for sized integer types
+#include <mutex>                                // for std::mutex
+
+// C INCLUDES
+// (none)
+
+// C++ INCLUDES
+#include "YtaRobot.hpp"                         // for the robot
+
+
+////////////////////////////////////////////////////////////////
+/// @class SimulatedHardware
+///
+/// Fakes for the hardware the robot code talks to when it runs
+/// on the desktop.  The desktop build of WPILib runs on the
+/// simulated HAL and Phoenix runs on its stub platform, so the
+/// Talons (and the motor groups) accept every call and send
+/// nothing.  What the robot reads back comes from here: the
+/// controllers are driver station joystick data, and the
+/// MXP I2C port answers like a BNO055 with a register file.
+/// The simulated I2C callbacks don't say which address is being
+/// read, and the RIOduino is on the same port, so its reads get
+/// the same registers (which never pass as a RIOduino frame).  The robot claims hardware and starts
+/// threads it never gives back, so one robot is built for the
+/// whole run and shared by everything that needs one.
+///
+////////////////////////////////////////////////////////////////
+class SimulatedHardware
+{
+public:
+
+    static const unsigned       NUM_CONTROLLER_AXES         = 6U;
+    static const unsigned       NUM_CONTROLLER_BUTTONS      = 12U;
+
+    // What one controller reports
+    struct ControllerState
+    {
+        float       m_Axes[NUM_CONTROLLER_AXES];
+        uint32_t    m_Buttons;                  // Bit zero is button one
+        int         m_Pov;                      // Angle in degrees, -1 when not pressed
+    };
+
+    // Hook up the fakes (call once, after HAL_Initialize)
+    static void Initialize();
+
+    // Change what a controller reports, it is picked up with the next driver station data
+    static void SetController(int port, const ControllerState & rState);
+
+    // Wait for the driver station to report a controller state, returns false on a timeout
+    static bool WaitForController(int port, const ControllerState & rState);
+
+    // Change the heading the BNO055 reports
+    static void SetGyroHeading(double headingDegrees);
+
+    // The robot, built and initialized the first time it's asked for
+    static YtaRobot & GetRobot();
+
+private:
+
+    // Simulated HAL callbacks for the MXP I2C port
+    static void I2cWriteCallback(const char * pName, void * pParam, const unsigned char * pBuffer, unsigned int count);
+    static void I2cReadCallback(const char * pName, void * pParam, unsigned char * pBuffer, unsigned int count);
+
+    // Constructor
+    SimulatedHardware();
+
+    // Destructor, copy constructor, assignment operator
+    ~SimulatedHardware();
+
+    SimulatedHardware(const SimulatedHardware &) = delete;
+    SimulatedHardware & operator=(const SimulatedHardware &) = delete;
+
+    // MEMBER VARIABLES
+    static const unsigned       BNO055_NUM_REGISTERS        = 0x80U;
+    static const uint8_t        BNO055_CHIP_ID_REGISTER     = 0x00U;
+    static const uint8_t        BNO055_CHIP_ID_VALUE        = 0xA0U;
+    static const uint8_t        BNO055_EULER_HEADING_LSB    = 0x1AU;
+    static const int            BNO055_UNITS_PER_DEGREE     = 16;
+    static const int32_t        MXP_I2C_PORT                = 1;
+    static const uint32_t       CONTROLLER_BUTTONS_MASK     = (1U << NUM_CONTROLLER_BUTTONS) - 1U;
+    static constexpr std::chrono::milliseconds CONTROLLER_TIMEOUT = std::chrono::milliseconds(100);
+
+    static uint8_t              m_Bno055Registers[BNO055_NUM_REGISTERS];
+    static std::mutex           m_Bno055Mutex;
+    static bool                 m_bInitialized;
+
+    // Each thread's transactions are a write of the register then a
+    // read, so the register being read is kept per thread
+    static thread_local uint8_t m_RegisterAddress;
+};
+
+#endif // SIMULATEDHARDWARE_HPP
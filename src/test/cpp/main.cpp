@@ -2,8 +2,11 @@
 
 #include "gtest/gtest.h"
 
+#include "SimulatedHardware.hpp"
+
 int main(int argc, char** argv) {
   HAL_Initialize(500, 0);
+  SimulatedHardware::Initialize();
   ::testing::InitGoogleTest(&argc, argv);
   int ret = RUN_ALL_TESTS();
   return ret;